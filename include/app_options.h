@@ -0,0 +1,76 @@
+#ifndef APP_OPTIONS_H
+#define APP_OPTIONS_H
+
+#include <string>
+#include <cstddef>
+
+// Command line settings
+struct AppOptions
+{
+    // Board
+    int boardWidth = 75, boardHeight = 75;
+    std::string rule;                   // e.g. "B36/S23"; empty = the pattern file's rule, else B3/S23
+    std::string ruleTable;              // Golly .rule file (@TABLE) to run in place of --rule
+    std::string engine = "gpu";         // "gpu" (compute shader) or "cpu" (bit-parallel, multithreaded)
+    unsigned long long reverseAt = 0;   // Reversible rules: run backwards from this generation on (0 = never)
+
+    // Patterns
+    std::string loadRLE;                // Seed the board from this RLE file (centred; the board grows to fit)
+    std::string saveRLE;                // Save the final board here on exit
+    std::string loadMacrocell;          // Seed from a Golly macrocell file (view only if too big for the GPU board)
+    std::string saveMacrocell;          // Save the final board as macrocell on exit
+    std::string loadPlaintext;          // Seed from a plaintext (.cells) pattern
+    std::string loadLife106;            // Seed from a Life 1.06 coordinate list
+    std::string stampScriptPath;        // Stamps patterns onto the board at given generations
+    std::string loadSnapshot;           // Resume from a binary snapshot (board size, rule & generation come from it)
+    std::string saveSnapshot;           // Save the final board as a binary snapshot on exit
+
+    // History
+    std::string recordPath;             // Record every generation (delta compressed) to this file
+    unsigned keyframeInterval = 1000;   // Generations between keyframes in a recording (bounds the cost of a seek)
+    std::string replayPath;             // Play back a recording instead of simulating
+    unsigned long long replayFrom = 0;  // Generation to start the replay at
+
+    // Metrics
+    std::string statsPath;              // Per generation population / births / deaths / bounding box (CSV if *.csv, else binary)
+    int maxPeriod = 0;                  // Detect the board becoming periodic, up to this period (0 = off)
+    std::string onPeriod = "report";    // What to do then: "report", "stop" the run, or "skip" ahead to --generations
+    std::string censusPath;             // Split the final board into objects & write their tally (apgcode,count CSV)
+    std::string emissionsPath;          // Log (CSV) & erase the spaceships reaching the band at the board's edges
+
+    // Soup search (no window: runs instead of the simulation)
+    unsigned long long soupCount = 0;   // Soups to search (0 = no search)
+    unsigned long long soupSeed = 0;    // Which soups: the same seed always gives the same soups
+
+    // Parameter sweep (no window): every rule x density x seed as its own --board-size universe, stepped as one batch
+    int sweepSeeds = 0;                 // Random fills per rule & density (0 = no sweep)
+    std::string sweepRules;             // Comma separated (default --rule, else B3/S23)
+    std::string sweepDensities = "0.5"; // Comma separated fill densities
+    std::string sweepPath;              // Final population of each universe (CSV); else a summary is printed
+
+    // 3D volume (runs instead of the 2D board): --rule is then a 3D rule
+    int volumeWidth = 0, volumeHeight = 0, volumeDepth = 0;    // 0 = no volume
+    double volumeDensity = 0.2;         // Of the random block filling the middle half of the volume
+
+    // Checkpointing
+    std::string checkpointDir;          // Write checkpoints here & resume from the newest one on start
+    unsigned long long checkpointEvery = 0;     // Generations between checkpoints (0 = not by generation)
+    double checkpointSeconds = 300.0;   // Seconds between checkpoints (0 = not by time)
+    int checkpointKeep = 3;             // Checkpoints kept on disk
+
+    // Offscreen rendering / capture
+    bool offscreen = false;             // Render into an FBO with no visible window
+    unsigned long long maxGenerations = 0;  // Stop after this many generations (0 = run until closed)
+    std::string pngPattern;             // printf-style path for a PNG sequence, e.g. "out/frame_%06d.png"
+    std::string rawPipeCommand;         // Command that receives raw RGBA frames on stdin, e.g. an ffmpeg invocation
+
+    // Tile-streamed rendering
+    bool tileView = false;              // Draw through the sparse tile store + GPU tile cache instead of per-cell quads
+    size_t tileBudgetMB = 64;           // GPU memory for the tile atlas
+};
+
+// Returns false (after printing usage) if the arguments can't be parsed
+bool parseAppOptions(int argc, char** argv, AppOptions& options);
+void printUsage(const char* programName);
+
+#endif
@@ -0,0 +1,71 @@
+#ifndef BIT_UTILS_H
+#define BIT_UTILS_H
+
+#include <cstdint>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+// Population count / bit scans that compile to single instructions where the target has them
+inline int popcount64(uint64_t x)
+{
+#if defined(_MSC_VER)
+    return static_cast<int>(__popcnt64(x));
+#else
+    return __builtin_popcountll(x);
+#endif
+}
+
+// Index of the lowest set bit ('x' must be non-zero)
+inline int countTrailingZeros64(uint64_t x)
+{
+#if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanForward64(&index, x);
+    return static_cast<int>(index);
+#else
+    return __builtin_ctzll(x);
+#endif
+}
+
+// Index of the highest set bit ('x' must be non-zero)
+inline int highestBit64(uint64_t x)
+{
+#if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanReverse64(&index, x);
+    return static_cast<int>(index);
+#else
+    return 63 - __builtin_clzll(x);
+#endif
+}
+
+// Atomic OR into a word shared between threads (no ordering implied)
+inline void atomicOr64(uint64_t* word, uint64_t bits)
+{
+#if defined(_MSC_VER)
+    _InterlockedOr64(reinterpret_cast<volatile long long*>(word), static_cast<long long>(bits));
+#else
+    __atomic_fetch_or(word, bits, __ATOMIC_RELAXED);
+#endif
+}
+
+// Bit-sliced counting: adds a one bit per cell plane into four count bit-planes (s3 s2 s1 s0), one cell per bit
+inline void addPlane(uint64_t v, uint64_t& s0, uint64_t& s1, uint64_t& s2, uint64_t& s3)
+{
+    uint64_t c0 = s0 & v;   s0 ^= v;
+    uint64_t c1 = s1 & c0;  s1 ^= c0;
+    uint64_t c2 = s2 & c1;  s2 ^= c1;
+    s3 |= c2;
+}
+
+// Bit-sliced full adder: the 2 bit count of a, b & c in (carry sum)
+inline void fullAdd(uint64_t a, uint64_t b, uint64_t c, uint64_t& sum, uint64_t& carry)
+{
+    uint64_t ab = a ^ b;
+    sum = ab ^ c;
+    carry = (a & b) | (ab & c);
+}
+
+#endif
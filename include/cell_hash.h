@@ -0,0 +1,24 @@
+#ifndef CELL_HASH_H
+#define CELL_HASH_H
+
+#include <cstdint>
+
+// Position hash of a live cell. A board's hash is the sum (mod 2^32 per lane) of its live cells' hashes,
+// so it can be kept up to date by adding births & subtracting deaths, summed per tile, or reduced on the
+// GPU with atomicAdd. computeShader.comp has the same function: the two must match bit for bit
+inline uint32_t lowbias32(uint32_t x)
+{
+    x ^= x >> 16;   x *= 0x7feb352du;
+    x ^= x >> 15;   x *= 0x846ca68bu;
+    x ^= x >> 16;
+    return x;
+}
+
+// Two independent 32 bit lanes, combined as (hi << 32) | lo
+inline void cellHash(uint32_t x, uint32_t y, uint32_t& lo, uint32_t& hi)
+{
+    lo = lowbias32(x + lowbias32(y));
+    hi = lowbias32(lo ^ 0x5bd1e995u);
+}
+
+#endif
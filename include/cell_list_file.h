@@ -0,0 +1,36 @@
+#ifndef CELL_LIST_FILE_H
+#define CELL_LIST_FILE_H
+
+#include <string>
+#include "packed_grid.h"
+#include "tile_store.h"
+
+// Plaintext (.cells: '!' comment lines, then rows of '.' / 'O', top row first) and Life 1.06
+// ("#Life 1.06", then an "x y" line per live cell, y pointing down) pattern files.
+// The file is memory mapped & cut into one chunk per thread at line boundaries; the chunks are parsed
+// in parallel straight out of the mapping, with no copy of the text.
+// Both formats have y pointing down, so rows are flipped onto the board (as with RLE)
+class CellListFile
+{
+public:
+    enum Format {
+        PLAINTEXT,
+        LIFE_106
+    };
+
+    struct Info {
+        long long minX = 0, minY = 0, maxX = -1, maxY = -1;    // Bounding box of the live cells in file coordinates
+        unsigned long long cells = 0;                           // Live cell lines (duplicates counted)
+        long long width() const { return maxX < minX ? 0 : maxX - minX + 1; }
+        long long height() const { return maxY < minY ? 0 : maxY - minY + 1; }
+    };
+
+    // Parallel pass over the file finding the bounding box
+    static bool scan(const std::string& path, Format format, Info& info);
+    // File cell (x, y) goes to (offsetX + x - info.minX, offsetY + info.maxY - y): the bounding box's
+    // bottom-left corner lands on the offset. Cells outside the grid are dropped
+    static bool load(const std::string& path, Format format, const Info& info, PackedGrid& grid, int offsetX, int offsetY);
+    static bool load(const std::string& path, Format format, const Info& info, TileStore& store, int64_t offsetX, int64_t offsetY);
+};
+
+#endif
@@ -0,0 +1,68 @@
+#ifndef CHECKPOINTER_H
+#define CHECKPOINTER_H
+
+#include <string>
+#include <vector>
+#include <chrono>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include "life_rule.h"
+
+// Periodic crash-safe checkpoints of the board as SnapshotFiles ("checkpoint_<generation>.snap").
+// Double buffered: submit() swaps the caller's cell buffer with a spare one of the same size, so the
+// step loop pays for a vector swap & nothing else. Packing, writing, fsync & the atomic rename happen
+// on an I/O thread, which then hands the buffer back as the next spare. If that thread is still busy
+// when the next checkpoint is due, the checkpoint is put off rather than waited for: due() stays false
+// until the writer is free, so the caller doesn't read the board back for a submit() that would fail
+class Checkpointer
+{
+public:
+    // Takes a checkpoint every 'everyGenerations' generations and / or 'everySeconds' seconds (0 = off),
+    // keeping the newest 'keep'
+    Checkpointer(const std::string& directory, unsigned long long everyGenerations, double everySeconds, int keep = 3);
+    ~Checkpointer() { finish(); }
+
+    bool start(int width, int height, const LifeRule& rule, unsigned long long generation);
+    // A checkpoint is due & the writer is free to take it
+    bool due(unsigned long long generation) const;
+    // Takes the board for 'generation' by swapping 'cells' with the spare buffer ('cells' then holds
+    // stale contents the caller must overwrite). Returns false, leaving 'cells' alone, if busy
+    bool submit(std::vector<uint32_t>& cells, unsigned long long generation);
+    // As above for a board the caller can't give up (e.g. a mapped readback buffer): it's copied into the spare
+    bool submit(const uint32_t* cells, unsigned long long generation);
+    // Waits for the checkpoint in flight
+    void finish();
+
+    unsigned long long written() const { return _written; }
+
+    // Path of the newest checkpoint in 'directory' whose checksum verifies ("" if none)
+    static std::string findLatest(const std::string& directory);
+
+private:
+    std::string directory;
+    unsigned long long everyGenerations;
+    double everySeconds;
+    int keep;
+    int width = 0, height = 0;
+    LifeRule rule;
+
+    unsigned long long lastGeneration = 0;
+    std::chrono::steady_clock::time_point lastTime;
+
+    std::thread writer;
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::vector<uint32_t> spare, pending;
+    unsigned long long pendingGeneration = 0;
+    std::atomic<bool> busy{false};      // Written under 'mutex', read without it by due()
+    bool stopping = false;
+    std::atomic<unsigned long long> _written{0};
+
+    void writerLoop();
+    void write(const std::vector<uint32_t>& cells, unsigned long long generation);
+    void prune();
+};
+
+#endif
@@ -6,7 +6,8 @@
 class ComputeShaderProgram : public ShaderProgram
 {
 public:
-    ComputeShaderProgram(const char* computePath);
+    // 'prelude' (e.g. #defines specialising the shader) goes in after the #version line
+    ComputeShaderProgram(const char* computePath, const std::string& prelude = "");
 };
 
 #endif
\ No newline at end of file
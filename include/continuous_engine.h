@@ -0,0 +1,61 @@
+#ifndef CONTINUOUS_ENGINE_H
+#define CONTINUOUS_ENGINE_H
+
+#include <cstdint>
+#include <vector>
+#include "continuous_rule.h"
+#include "fft.h"
+#include "stamp.h"
+
+// Continuous-state rules (see ContinuousRule) on the CPU: a float per cell, & each kernel's potentials the
+// board's convolution with it, done as a product of spectra. The board is zero padded up to power-of-two
+// sizes with room for the kernel's reach, so the (circular) convolution doesn't wrap: cells past the edges
+// are 0, as on every other engine. The kernels' spectra are worked out once, when the board's size is known.
+// A step is three passes, each split between the threads:
+//   rows       real FFT of each board row, written out by column (the padding rows stay 0)
+//   columns    FFT of each column, then per kernel: the product with its spectrum & the inverse FFT, keeping
+//              the board's rows
+//   rows       each kernel's inverse real FFT of the row, then the rule applied to its cells
+class ContinuousEngine
+{
+public:
+    explicit ContinuousEngine(int threads = 0);     // 0 = one per hardware thread
+
+    void setRule(const ContinuousRule& rule);
+    // Cell values are levels 0 - 255 (255 being 1, as Lenia's patterns store them)
+    void loadCells(const std::vector<uint32_t>& cells, int width, int height);
+    void toCells(std::vector<uint32_t>& cells) const;
+
+    void step();
+    // Pattern cells become 1 or 0, combined as stampState() does
+    void stamp(const PackedGridView& pattern, int x, int y, StampMode mode);
+
+    int width() const { return _width; }
+    int height() const { return _height; }
+    const std::vector<float>& values() const { return field; }
+
+    // Levels to values & back
+    static float toValue(uint32_t level) { return (level > 255 ? 255 : level) / 255.0f; }
+    static uint32_t toLevel(float value) { return static_cast<uint32_t>(value * 255.0f + 0.5f); }
+
+private:
+    using Complex = Fft::Complex;
+
+    ContinuousRule rule;
+    int _width = 0, _height = 0;
+    int paddedX = 0, paddedY = 0, bins = 0;     // bins = paddedX / 2 + 1, the row spectra's length
+    Fft rowFft, columnFft;
+    std::vector<float> field;                   // width x height
+    std::vector<Complex> spectrum;              // bins x paddedY, column by column
+    std::vector<std::vector<Complex>> kernelSpectra;    // Same layout, scaled by 1 / (paddedX paddedY)
+    std::vector<std::vector<Complex>> potentials;       // Per kernel: bins x height, column by column
+    int threads;
+
+    void plan();
+    void runBands(void (ContinuousEngine::*pass)(int, int), int count, size_t values);
+    void forwardRows(int y0, int y1);
+    void convolveColumns(int x0, int x1);
+    void updateRows(int y0, int y1);
+};
+
+#endif
@@ -0,0 +1,58 @@
+#ifndef CONTINUOUS_RULE_H
+#define CONTINUOUS_RULE_H
+
+#include <string>
+#include <vector>
+
+// Continuous-state rules: cells hold values in [0, 1], & a step convolves the board with large smooth kernels
+// then maps each cell's weighted sums (its "potentials") to its next value.
+//   Lenia       "Lenia:R=13,T=10,m=0.15,s=0.015,b=1"  one kernel of concentric shells (peaks b, separated by
+//               ';'), radius R; the cell grows by G(u) / T, G being a bump around m of width s, in [-1, 1].
+//               kernel= & growth= pick the core & growth function shapes: exp|poly|step, gauss|poly|step
+//   SmoothLife  "SmoothLife:ri=7,ra=21,b1=0.278,b2=0.365,d1=0.267,d2=0.445,an=0.028,am=0.147,dt=0"
+//               Rafler's rule: m is the inner disc's filling, n the outer ring's; S(n, m) is the next value
+//               (dt=0), or the cell moves by dt * (2S - 1) (smooth time)
+// Any key left out keeps the default shown
+class ContinuousRule
+{
+public:
+    enum Kind { LENIA, SMOOTH_LIFE };
+    enum Shape { EXPONENTIAL, POLYNOMIAL, STEP };
+
+    static constexpr int MAX_RADIUS = 256;
+    static constexpr int MAX_SHELLS = 8;
+
+    Kind kind = LENIA;
+
+    // Lenia
+    int radius = 13;
+    float timeSteps = 10.0f;        // T: a step moves a cell by G(u) / T
+    float growthCentre = 0.15f, growthWidth = 0.015f;   // m, s
+    std::vector<float> shells = { 1.0f };
+    Shape kernelShape = EXPONENTIAL, growthShape = EXPONENTIAL;    // EXPONENTIAL growth is the Gaussian
+
+    // SmoothLife
+    float innerRadius = 7.0f, outerRadius = 21.0f;
+    float birthLow = 0.278f, birthHigh = 0.365f, deathLow = 0.267f, deathHigh = 0.445f;
+    float alphaN = 0.028f, alphaM = 0.147f;
+    float dt = 0.0f;                // 0 = discrete time
+
+    // Returns false & leaves the rule untouched if the string isn't understood
+    bool parse(const std::string& text);
+    std::string toString() const;
+
+    // One kernel for Lenia, the disc & the ring for SmoothLife
+    int kernelCount() const { return kind == LENIA ? 1 : 2; }
+    int kernelRadius() const;       // Of the cells any kernel reaches
+    // Kernel k's (2 kernelRadius() + 1)^2 weights, row by row, normalised to sum to 1
+    std::vector<float> kernel(int k) const;
+
+    // The next value of a cell of value 'value' with potentials 'u' (one per kernel)
+    float next(float value, const float* u) const;
+
+private:
+    float growth(float u) const;
+    float smoothLifeNext(float value, float n, float m) const;
+};
+
+#endif
@@ -0,0 +1,55 @@
+#ifndef CPU_LIFE_ENGINE_H
+#define CPU_LIFE_ENGINE_H
+
+#include <vector>
+#include "packed_grid.h"
+#include "life_rule.h"
+#include "generation_stats.h"
+#include "stamp.h"
+#include "rule_diagram.h"
+
+// Bit-parallel Life-like engine on a PackedGrid: each 64 bit word updates 64 cells at once, the eight
+// neighbour words being summed with bit-sliced adders into four count bit-planes. Cells beyond the
+// edges are dead, as in the compute shader. Big boards are split into row bands stepped on separate threads.
+// Population / births / deaths / bounding box fall out of the step as popcounts of the words it writes.
+// The board hash is kept per 64x64 tile (one word column of a 64 row band): only tiles the step changed
+// are rehashed, then the tile hashes are summed. Isotropic non-totalistic rules skip the count: the nine
+// neighbourhood words go through the rule's decision diagram (see rule_diagram.h) instead. Hexagonal &
+// von Neumann rules count their 6 / 4 neighbour words with adders of their own
+class CpuLifeEngine
+{
+public:
+    explicit CpuLifeEngine(int threads = 0);    // 0 = one per hardware thread
+
+    void setRule(const LifeRule& rule);
+    void load(const PackedGrid& board);
+    void loadCells(const std::vector<uint32_t>& cells, int width, int height);
+
+    // Advances one generation, filling 'stats' if given ('generation' is left to the caller)
+    void step(GenerationStats* stats = nullptr);
+    void stamp(const PackedGridView& pattern, int x, int y, StampMode mode);
+
+    const PackedGrid& board() const { return current; }
+    uint64_t hash() const;      // Same value as the compute shader's (see cell_hash.h)
+
+private:
+    PackedGrid current, next;
+    std::vector<uint64_t> zeroRow;
+    unsigned birthMask, surviveMask;
+    LifeRule::Neighbourhood neighbourhood = LifeRule::MOORE;
+    bool isotropic = false;
+    RuleDiagram diagram;        // Only built for isotropic rules
+    int threads;
+
+    static constexpr int TILE_ROWS = 64;
+    struct TileHash { uint32_t lo = 0, hi = 0; };
+    std::vector<TileHash> tileHashes;       // Tile row major, usedWordsPerRow tiles per tile row
+    std::vector<uint8_t> tileChanged;
+
+    void stepRows(int y0, int y1, GenerationStats& stats);
+    // Rehashes the tiles of tile rows [tileY0, tileY1) of 'grid' (only those flagged changed if 'changedOnly')
+    void hashTiles(const PackedGrid& grid, int tileY0, int tileY1, bool changedOnly);
+    void resetTiles();
+};
+
+#endif
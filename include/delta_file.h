@@ -0,0 +1,98 @@
+#ifndef DELTA_FILE_H
+#define DELTA_FILE_H
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include "packed_grid.h"
+#include "life_rule.h"
+
+// Generation history files: a 32 byte header, then one record per recorded generation.
+//  record  = varint payloadBytes, payload
+//  payload = u8 type, varint generation, varint changedTiles, changedTiles x tile
+//  tile    = varint tileGap (tiles skipped since the previous changed one, row major), then word runs
+//            "varint zeroWords, varint literalWords, literalWords x u64 LE" until all 64 rows are covered
+// Tiles are 64x64 cells: one packed word in each of 64 rows. A DELTA record holds the XOR against the
+// previous record's board; a KEYFRAME record the board itself (XOR against an empty board), so one can
+// be decoded without anything before it.
+// Alongside sits an index file (path + ".idx"): a 16 byte header, then a (generation, byte offset)
+// uint64 pair per keyframe, so seeking costs one keyframe decode + at most a keyframe interval of deltas
+class DeltaFile
+{
+public:
+    static constexpr uint32_t VERSION = 1;
+    static constexpr int TILE_ROWS = 64;
+
+    enum RecordType : uint8_t {
+        DELTA = 0,
+        KEYFRAME = 1
+    };
+
+    struct Header {
+        char magic[8];          // "GOLDELTA"
+        uint32_t version;
+        uint32_t width, height;
+        uint32_t birthMask, surviveMask;
+        uint32_t reserved;
+    };
+    static_assert(sizeof(Header) == 32, "delta file header must stay 32 bytes");
+
+    struct IndexHeader {
+        char magic[8];          // "GOLDIDX\0"
+        uint32_t version;
+        uint32_t keyframeInterval;
+    };
+    struct IndexEntry {
+        uint64_t generation;
+        uint64_t offset;        // Of the record's length prefix
+    };
+
+    static std::string indexPath(const std::string& path) { return path + ".idx"; }
+    static IndexHeader makeIndexHeader(uint32_t keyframeInterval);
+
+    static Header makeHeader(int width, int height, const LifeRule& rule);
+    static bool checkHeader(const Header& header);
+
+    // Appends a whole record (length prefix included) to 'out'. 'previous' is ignored for keyframes
+    static void encodeRecord(const PackedGrid& previous, const PackedGrid& current, unsigned long long generation,
+                             RecordType type, std::vector<uint8_t>& out);
+    // Applies one record payload to 'grid' (sized to the file's board). Returns false if it's malformed
+    static bool applyRecord(const uint8_t* payload, size_t size, PackedGrid& grid, unsigned long long& generation, RecordType& type);
+
+    // Sequential & seekable reader
+    class Reader
+    {
+    public:
+        ~Reader() { close(); }
+
+        // Loads the index file if there is one; keyframes past its end (or all of them, without one) are
+        // found by walking the record headers, skipping the payloads
+        bool open(const std::string& path);
+        void close();
+        const Header& header() const { return _header; }
+
+        // Decodes the next record into 'grid'. Returns false at the end of the file or on a damaged record
+        bool next(PackedGrid& grid, unsigned long long& generation, RecordType* type = nullptr);
+        // Decodes the last recorded board at or before 'target' (the first one if 'target' is earlier);
+        // reading then carries on from there
+        bool seek(unsigned long long target, PackedGrid& grid, unsigned long long& generation);
+
+        unsigned long long firstGeneration() const { return keyframes.empty() ? 0 : keyframes.front().generation; }
+        unsigned long long lastGeneration() const { return _lastGeneration; }
+
+    private:
+        FILE* file = nullptr;
+        uint64_t fileSize = 0;
+        Header _header;
+        std::vector<uint8_t> payload;
+        std::vector<IndexEntry> keyframes;
+        unsigned long long _lastGeneration = 0;
+
+        void loadIndex(const std::string& path);
+        void scanRecords(uint64_t offset);
+        bool readPayload();
+    };
+};
+
+#endif
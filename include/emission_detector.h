@@ -0,0 +1,72 @@
+#ifndef EMISSION_DETECTOR_H
+#define EMISSION_DETECTOR_H
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "packed_grid.h"
+#include "life_rule.h"
+#include "object_census.h"
+
+// Logs the spaceships leaving a watched rectangle of the board (gun / breeder output) with no board history.
+// Only a band of BAND cells just outside the rectangle is ever read, so a scan costs the band's perimeter,
+// not the board's area; the live cells found there are clustered (cells within 2 can interact), & clusters
+// clear of the rectangle & the band's outer edge are classified by apgcode - canonical over their period &
+// orientation, cached by their exact cells. Each spaceship is logged with its direction & then handed back
+// to the caller to erase, so it's counted once & never reaches the board's edge. Anything else is left be
+class EmissionDetector
+{
+public:
+    static constexpr int BAND = 24;             // Band width, in cells
+    static constexpr int CHECK_INTERVAL = 4;    // Generations between scans: nothing at up to c moves far across the band
+    static constexpr int MAX_CELLS = 128;       // Bigger clusters aren't taken as single spaceships
+
+    struct Rect {
+        int x0, y0, x1, y1;     // Inclusive, board coordinates
+    };
+    struct Emission {
+        unsigned long long generation;  // Of the scan that saw it
+        std::string code;
+        int x, y;                       // Bounding box's low corner then
+        int dx, dy, period;             // Moves (dx, dy) every 'period' generations
+    };
+    // A spaceship to erase: its cells, bottom-left corner at (x, y)
+    struct Sighting {
+        PackedGrid shape;
+        int x, y;
+    };
+
+    EmissionDetector(int boardWidth, int boardHeight, const Rect& watched, const LifeRule& rule);
+
+    // The band, as up to 4 strips clipped to the board: the cells scan() reads
+    const std::vector<Rect>& band() const { return strips; }
+
+    // Scans the band of 'board' (nothing else is read), logging the spaceships found & returning them
+    std::vector<Sighting> scan(const PackedGrid& board, unsigned long long generation);
+    // 'sighting' stepped on its own 'generations' further: where to erase it once the board has moved on past the scan
+    Sighting advance(const Sighting& sighting, int generations) const;
+
+    const std::vector<Emission>& emissions() const { return _emissions; }
+    // "generation,code,x,y,dx,dy,period" lines
+    bool write(const std::string& path) const;
+    // Count, direction & mean interval of each kind of emission
+    void printSummary() const;
+
+private:
+    struct Motion {
+        std::string code;
+        int dx = 0, dy = 0, period = 0;     // period 0: not a spaceship
+    };
+
+    Rect watched;
+    std::vector<Rect> strips;
+    LifeRule rule;
+    ObjectCensus census;
+    std::unordered_map<std::string, Motion> motionCache;    // Cluster cells key -> what it is
+    std::vector<Emission> _emissions;
+
+    Motion identify(const PackedGrid& shape);
+};
+
+#endif
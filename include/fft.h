@@ -0,0 +1,38 @@
+#ifndef FFT_H
+#define FFT_H
+
+#include <complex>
+#include <cstdint>
+#include <vector>
+
+// Radix-2 FFTs of one power-of-two length n: complex transforms of length n, & real ones of length n done
+// as a complex transform of half the length. The twiddles & bit reversal orders are worked out once.
+// Nothing is scaled: an inverse after a forward transform gives the input times n
+class Fft
+{
+public:
+    using Complex = std::complex<float>;
+
+    explicit Fft(int length = 2);
+
+    int length() const { return n; }
+
+    // In place, over length() values
+    void transform(Complex* data, bool inverse) const;
+    // length() reals to their length() / 2 + 1 non-negative frequency bins (the rest mirror them), & back.
+    // 'scratch' holds length() / 2 values
+    void forwardReal(const float* in, Complex* out, Complex* scratch) const;
+    void inverseReal(const Complex* in, float* out, Complex* scratch) const;
+
+    static bool isPowerOfTwo(int n) { return n > 0 && (n & (n - 1)) == 0; }
+    static int nextPowerOfTwo(int n);
+
+private:
+    int n;
+    std::vector<Complex> twiddles;          // e^(-2 pi i k / n), k < n / 2
+    std::vector<uint32_t> reversed, halfReversed;
+
+    void transform(Complex* data, int length, const std::vector<uint32_t>& order, bool inverse) const;
+};
+
+#endif
@@ -0,0 +1,74 @@
+#ifndef GENERATION_RECORDER_H
+#define GENERATION_RECORDER_H
+
+#include <cstdio>
+#include <string>
+#include <vector>
+#include <deque>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include "delta_file.h"
+
+// Records the board's history to a DeltaFile from a writer thread.
+// The step loop only packs the board into a recycled PackedGrid & queues it; XOR / encoding / writing
+// happen on the writer. The queue is bounded & record() never waits on it: if the writer falls behind,
+// generations are dropped (the next recorded one is a delta against the last one written), so
+// recording can't throttle the simulation.
+// Every 'keyframeInterval' generations a keyframe is written instead of a delta & listed in the index file
+class GenerationRecorder
+{
+public:
+    GenerationRecorder() {}
+    ~GenerationRecorder() { finish(); }
+
+    bool open(const std::string& path, int width, int height, const LifeRule& rule, unsigned keyframeInterval = 1000);
+    // Queues the board for 'generation' (one uint32 per cell, as in the SSBOs)
+    void record(const std::vector<uint32_t>& cells, unsigned long long generation) { record(cells.data(), generation); }
+    void record(const uint32_t* cells, unsigned long long generation);
+    // The queue can take another frame. Lets the caller skip reading the board back for one record() would drop
+    bool hasRoom() const;
+    // Counts a generation the caller didn't get to record() (e.g. while hasRoom() was false)
+    void drop() { _dropped++; }
+    // Writes everything queued & closes the file
+    void finish();
+
+    unsigned long long recorded() const { return _recorded; }
+    unsigned long long dropped() const { return _dropped; }
+    unsigned long long bytesWritten() const { return _bytesWritten; }
+
+private:
+    struct Frame {
+        unsigned long long generation;
+        PackedGrid grid;
+    };
+
+    static constexpr size_t MAX_QUEUED_FRAMES = 4;
+
+    int width = 0, height = 0;
+    unsigned keyframeInterval = 1000;
+    FILE* file = nullptr;
+    FILE* indexFile = nullptr;
+    std::vector<char> ioBuffer;
+
+    std::thread writer;
+    mutable std::mutex queueMutex;
+    std::condition_variable queueCV;
+    std::deque<Frame> queue;
+    std::vector<PackedGrid> freeGrids;
+    bool stopping = false;
+
+    // Writer thread only
+    PackedGrid lastWritten;
+    bool wroteAny = false;
+    unsigned long long lastKeyframe = 0;
+    std::vector<uint8_t> encoded;
+
+    std::atomic<unsigned long long> _recorded{0}, _dropped{0}, _bytesWritten{0};
+
+    void writerLoop();
+    void writeFrame(const Frame& frame);
+};
+
+#endif
@@ -0,0 +1,68 @@
+#ifndef GENERATION_STATS_H
+#define GENERATION_STATS_H
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <atomic>
+#include "spsc_queue.h"
+
+// Per generation metrics, produced by the engines as part of each step
+struct GenerationStats
+{
+    uint64_t generation = 0;
+    uint64_t population = 0;
+    uint64_t births = 0, deaths = 0;
+    uint64_t hash = 0;      // Board hash (see cell_hash.h): equal boards have equal hashes
+    int32_t minX = 0, minY = 0, maxX = -1, maxY = -1;   // Bounding box of the live cells (empty if maxX < minX)
+};
+
+// Adds a band's counts & bounding box into 'total', for engines that step in bands (the hash is left to them)
+void addStats(GenerationStats& total, const GenerationStats& part);
+
+// Cells whose count bit-planes (s3 s2 s1 s0) hold a value whose bit is set in 'mask'
+inline uint64_t countIn(unsigned mask, uint64_t s0, uint64_t s1, uint64_t s2, uint64_t s3)
+{
+    uint64_t match = 0;
+    for (unsigned n = 0; n <= 8; n++) {
+        if (!((mask >> n) & 1)) continue;
+        match |= ((n & 1) ? s0 : ~s0) & ((n & 2) ? s1 : ~s1) & ((n & 4) ? s2 : ~s2) & ((n & 8) ? s3 : ~s3);
+    }
+    return match;
+}
+
+// Streams GenerationStats to a file from a writer thread. The step loop pushes into a lock-free
+// queue & never waits: if the writer falls that far behind, records are dropped (and counted).
+// Paths ending in ".csv" get CSV; anything else a 16 byte header ("GOLSTATS", version, record size)
+// followed by the raw records
+class StatsWriter
+{
+public:
+    StatsWriter() : queue(QUEUE_CAPACITY) {}
+    ~StatsWriter() { finish(); }
+
+    bool open(const std::string& path);
+    void push(const GenerationStats& stats);
+    // Writes everything queued & closes the file
+    void finish();
+
+    unsigned long long written() const { return _written; }
+    unsigned long long dropped() const { return _dropped; }
+
+private:
+    static constexpr size_t QUEUE_CAPACITY = 4096;
+    static constexpr uint32_t VERSION = 2;     // 2: added hash
+
+    SPSCQueue<GenerationStats> queue;
+    FILE* file = nullptr;
+    bool csv = false;
+    std::thread writer;
+    std::atomic<bool> stopping{false};
+    std::atomic<unsigned long long> _written{0}, _dropped{0};
+
+    void writerLoop();
+    void write(const GenerationStats& stats);
+};
+
+#endif
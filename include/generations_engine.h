@@ -0,0 +1,50 @@
+#ifndef GENERATIONS_ENGINE_H
+#define GENERATIONS_ENGINE_H
+
+#include <vector>
+#include "packed_grid.h"
+#include "life_rule.h"
+#include "generation_stats.h"
+#include "stamp.h"
+
+// Bit-parallel engine for Generations rules (LifeRule::states > 2). A cell's state is stored bit-sliced over
+// 2-4 PackedGrid planes (bit i of the state in plane i), so a word of each plane holds 64 cells & memory per
+// cell is the state's bit count. A step derives the live (state 1) plane a row at a time, counts it with the
+// same bit-sliced adders as CpuLifeEngine, & applies birth / survival / decay to whole words: decaying cells
+// go up by one through a ripple carry across the planes, wrapping to 0 past the last state.
+// Stats count live cells only; the hash covers every state (see cell_hash.h), so period detection works
+class GenerationsEngine
+{
+public:
+    explicit GenerationsEngine(int threads = 0);    // 0 = one per hardware thread
+
+    void setRule(const LifeRule& rule);     // Before loading: the state count sets the number of planes
+    // Cell values are states (values past the last state are taken as live)
+    void loadCells(const std::vector<uint32_t>& cells, int width, int height);
+    void toCells(std::vector<uint32_t>& cells) const;
+
+    // Advances one generation, filling 'stats' if given ('generation' is left to the caller)
+    void step(GenerationStats* stats = nullptr);
+    // Pattern cells are live (state 1) ones, combined as stampState() does
+    void stamp(const PackedGridView& pattern, int x, int y, StampMode mode);
+
+    int width() const { return current[0].width(); }
+    int height() const { return current[0].height(); }
+    size_t sizeInBytes() const;     // Of one generation's planes
+
+private:
+    static constexpr int MAX_PLANES = 4;
+
+    std::vector<PackedGrid> current, next;      // One per state bit
+    std::vector<uint64_t> zeroRow;
+    unsigned birthMask, surviveMask;
+    int states, planes;
+    int threads;
+    bool hashing = false;   // Only worth the per cell work when stats are wanted
+
+    unsigned get(int x, int y) const;
+    void set(int x, int y, unsigned state);
+    void stepRows(int y0, int y1, GenerationStats& stats, uint32_t& hashLo, uint32_t& hashHi);
+};
+
+#endif
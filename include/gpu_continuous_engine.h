@@ -0,0 +1,53 @@
+#ifndef GPU_CONTINUOUS_ENGINE_H
+#define GPU_CONTINUOUS_ENGINE_H
+
+#include <vector>
+#include <glad/glad.h>
+#include "compute_shader_program.h"
+#include "continuous_rule.h"
+#include "stamp.h"
+
+// Continuous-state rules on the GPU, convolving as ContinuousEngine does over the same zero padded,
+// power-of-two board, but with complex FFTs throughout: fftPass.comp does one radix-2 pass of a Stockham FFT
+// (one invocation per butterfly, ping-ponging between two buffers, no bit reversal), log2 of the length of
+// them over the rows then the columns. A step (continuousStep.comp's stages around the FFTs):
+//   load       the cells into the padded complex board
+//   FFT        rows, then columns
+//   multiply   by the kernels' spectra: with two kernels (SmoothLife) the second's product goes in as the
+//              imaginary part, so one inverse transform gives both (real) potentials
+//   inverse    columns, then the board's rows
+//   update     the rule, & the cells as levels 0 - 255 into the board buffer the renderer draws from
+// The kernel spectra are transformed on the CPU & uploaded once: a vec2 per frequency, or a vec4 with two kernels
+class GpuContinuousEngine
+{
+public:
+    static constexpr GLuint FIELD_BINDING = 19;
+    static constexpr GLuint WORK_BINDING = 20;      // fftPass.comp's input, & the board continuousStep.comp works on
+    static constexpr GLuint OUTPUT_BINDING = 21;    // fftPass.comp's output
+    static constexpr GLuint SPECTRA_BINDING = 22;
+
+    GpuContinuousEngine(int width, int height, const ContinuousRule& rule);
+    ~GpuContinuousEngine();
+
+    // Cell values are levels 0 - 255, as ContinuousEngine's
+    void load(const std::vector<uint32_t>& cells);
+    // As ContinuousEngine::stamp(): the board is read back, stamped & uploaded again, & the stamped cells'
+    // levels written to 'cellsBuf'
+    void stamp(GLuint cellsBuf, const PackedGridView& pattern, int x, int y, StampMode mode);
+
+    // Writes the new cells' levels to 'cellsBuf' (one uint per cell)
+    void step(GLuint cellsBuf);
+
+private:
+    enum Stage { LOAD = 0, MULTIPLY = 1, UPDATE = 2 };
+
+    ComputeShaderProgram fftShader, stepShader;
+    GLuint fieldBuf, workBufs[2], spectraBuf;
+    int width, height, paddedX, paddedY;
+
+    // Runs the passes over 'lines' lines of 'length' values; returns which work buffer holds the result
+    int transform(int from, int length, int stride, int lineStride, int lines, bool inverse);
+    void runStage(Stage stage, int work);
+};
+
+#endif
@@ -0,0 +1,41 @@
+#ifndef GPU_GENERATIONS_ENGINE_H
+#define GPU_GENERATIONS_ENGINE_H
+
+#include <glad/glad.h>
+#include <cstdint>
+#include <vector>
+#include "compute_shader_program.h"
+#include "life_rule.h"
+
+// Generations rules on the GPU (generationsStep.comp). States are packed 4 bits per cell, 8 cells to a uint,
+// in two buffers that take turns as the current generation. An invocation steps a whole word: it turns the
+// 3x3 block of words around it into live (state 1) masks & counts neighbours with bitCount().
+// The board only ever exists packed: the renderer & reductions decode the nibbles straight from statesBuffer()
+class GpuGenerationsEngine
+{
+public:
+    static constexpr GLuint STATES0_BINDING = 10;
+    static constexpr GLuint STATES1_BINDING = 11;
+    static constexpr int CELLS_PER_WORD = 8;
+
+    GpuGenerationsEngine(int width, int height, const LifeRule& rule);
+    ~GpuGenerationsEngine();
+
+    void load(const std::vector<uint32_t>& cells);     // One state per cell
+    // Reads the current generation back, one state per cell (blocking: for stamping & saving, not every step)
+    void toCells(std::vector<uint32_t>& cells) const;
+    void step();
+
+    GLuint statesBuffer() const { return statesBufs[currentBuf]; }     // The current generation, packed
+    int packedWordsPerRow() const { return wordsPerRow; }
+    size_t sizeInBytes() const { return static_cast<size_t>(wordsPerRow) * height * sizeof(GLuint); }   // Of a generation
+
+private:
+    ComputeShaderProgram shader;
+    GLuint statesBufs[2];
+    int width, height, wordsPerRow;
+    int currentBuf = 0;
+    GLint sourceLoc;
+};
+
+#endif
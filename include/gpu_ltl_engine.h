@@ -0,0 +1,30 @@
+#ifndef GPU_LTL_ENGINE_H
+#define GPU_LTL_ENGINE_H
+
+#include <glad/glad.h>
+#include "compute_shader_program.h"
+#include "ltl_rule.h"
+
+// Larger than Life on the GPU. Each step builds the board's summed-area table: ltlPrefixSums.comp scans
+// the rows, then the columns, with workgroup prefix scans over 32x32 tiles (an invocation per cell, 32 lines
+// to a workgroup). ltlStep.comp then takes any cell's box count from four table entries & applies the
+// rule, so a cell costs the same at any range. The board stays in the one-uint-per-cell board buffer,
+// stepped in place: a cell only reads the table & itself
+class GpuLtlEngine
+{
+public:
+    static constexpr GLuint SUMS_BINDING = 13;
+
+    GpuLtlEngine(int width, int height, const LtlRule& rule);
+    ~GpuLtlEngine();
+
+    void step(GLuint cellsBuf);
+
+private:
+    ComputeShaderProgram prefixSumsShader, stepShader;
+    GLuint sumsBuf;
+    GLint alongColumnsLoc;
+    int width, height;
+};
+
+#endif
@@ -0,0 +1,32 @@
+#ifndef GPU_MARGOLUS_ENGINE_H
+#define GPU_MARGOLUS_ENGINE_H
+
+#include <array>
+#include <glad/glad.h>
+#include "compute_shader_program.h"
+#include "margolus_rule.h"
+
+// Margolus rules on the GPU (margolusStep.comp): one invocation per block, stepping the one-uint-per-cell
+// board buffer in place. Stepping backwards runs the inverse table over the partition the undone step used,
+// as MargolusEngine does
+class GpuMargolusEngine
+{
+public:
+    GpuMargolusEngine(int width, int height, const MargolusRule& rule);
+
+    // Advances one generation, or undoes the last one when 'backward' (reversible rules only)
+    void step(GLuint cellsBuf, bool backward = false);
+    long long time() const { return _time; }
+
+private:
+    ComputeShaderProgram shader;
+    std::array<GLuint, 16> forwardTable, backwardTable;
+    bool reversible;
+    bool tableBackward = false;     // Which table the shader has
+    long long _time = 0;
+    int width, height;
+
+    void setTable(bool backward);
+};
+
+#endif
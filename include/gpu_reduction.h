@@ -0,0 +1,54 @@
+#ifndef GPU_REDUCTION_H
+#define GPU_REDUCTION_H
+
+#include <glad/glad.h>
+#include <cstdint>
+#include <deque>
+#include "compute_shader_program.h"
+#include "readback_ring.h"
+
+// Board-wide aggregates of any one-uint-per-cell SSBO (or one of 4 bit packed states), computed on the GPU (reduce.comp): the number of
+// non-zero cells, the sum / min / max of the values & the bounding box of the non-zero cells.
+// Only the few dozen bytes of the result come back, asynchronously: like GpuStats, each request gets a
+// buffer from a ReadbackRing & is read once its fence has signalled, so callers never stall on the GPU
+class GpuReduction
+{
+public:
+    static constexpr GLuint CELLS_BINDING = 2;
+    static constexpr GLuint RESULT_BINDING = 6;
+
+    struct Result {
+        unsigned long long tag = 0;     // As passed to submit()
+        uint64_t count = 0, sum = 0;
+        uint32_t minValue = 0, maxValue = 0;
+        int32_t minX = 0, minY = 0, maxX = -1, maxY = -1;   // Empty if maxX < minX
+        bool empty() const { return maxX < minX; }
+    };
+
+    explicit GpuReduction(int slots = 4);
+
+    // Queues a reduction of the width x height board in 'cellsBuf'; its result carries 'tag'. With
+    // 'packedWordsPerRow' the board is 4 bit states packed 8 cells to a uint (as GpuGenerationsEngine keeps it)
+    void submit(GLuint cellsBuf, int width, int height, unsigned long long tag, int packedWordsPerRow = 0);
+    // Returns the oldest finished result, if any
+    bool poll(Result& result);
+    // Waits for every request in flight; poll() then returns them all
+    void flush();
+
+private:
+    // Mirrors the shader's Result block
+    struct Block {
+        GLuint count, sumLo, sumHi, minValue, maxValue;
+        GLint minX, minY, maxX, maxY;
+    };
+
+    ComputeShaderProgram shader;
+    ReadbackRing ring;
+    std::deque<Result> ready;
+
+    // Ring consumer: queues a finished request's Block as its Result
+    void store(const void* data, unsigned long long tag);
+    ReadbackRing::Consumer storer() { return [this](const void* data, unsigned long long tag) { store(data, tag); }; }
+};
+
+#endif
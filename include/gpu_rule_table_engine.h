@@ -0,0 +1,33 @@
+#ifndef GPU_RULE_TABLE_ENGINE_H
+#define GPU_RULE_TABLE_ENGINE_H
+
+#include <glad/glad.h>
+#include "compute_shader_program.h"
+#include "rule_table.h"
+
+// Rule tables on the GPU (ruleTableStep.comp), stepping the board's own one-uint-per-cell buffers: a step
+// reads one & writes the other, which the caller then swaps. The shader is compiled for the table, with the
+// key's layout, the neighbour offsets & the lookup's sizes as constants, & the table itself goes up once:
+// the dense byte table, or the perfect hash's slots & bucket seeds
+class GpuRuleTableEngine
+{
+public:
+    static constexpr GLuint TABLE_BINDING = 17;     // Dense table / hash slots
+    static constexpr GLuint SEEDS_BINDING = 18;
+
+    GpuRuleTableEngine(int width, int height, const RuleTable& table);
+    ~GpuRuleTableEngine();
+
+    void step(GLuint sourceBuf, GLuint targetBuf);
+    size_t tableBytes() const { return tableSize + seedsSize; }
+
+private:
+    ComputeShaderProgram shader;
+    GLuint tableBuf, seedsBuf;
+    size_t tableSize = 0, seedsSize = 0;
+    int width, height;
+
+    static std::string specialise(const RuleTable& table);
+};
+
+#endif
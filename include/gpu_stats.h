@@ -0,0 +1,44 @@
+#ifndef GPU_STATS_H
+#define GPU_STATS_H
+
+#include <glad/glad.h>
+#include <deque>
+#include "generation_stats.h"
+#include "readback_ring.h"
+
+// Collects the GenerationStats the compute shader reduces into the SSBO at binding 3.
+// Each step gets its own small buffer from a ReadbackRing; a buffer is read back only once its fence has
+// signalled (normally a couple of steps later), so the step loop never waits on the GPU for them
+class GpuStats
+{
+public:
+    static constexpr GLuint BINDING = 3;
+
+    explicit GpuStats(int slots = 4);
+
+    // Resets the next buffer & binds it for the coming dispatch
+    void begin();
+    // Fences the dispatch that just went out, which produced 'generation'
+    void end(unsigned long long generation);
+    // Returns the oldest finished step's stats, if any
+    bool poll(GenerationStats& stats);
+    // Waits for every step in flight; poll() then returns them all
+    void flush();
+
+private:
+    // Mirrors the shader's Stats block
+    struct Block {
+        GLuint population, births, deaths;
+        GLint minX, minY, maxX, maxY;
+        GLuint hashLo, hashHi;
+    };
+
+    ReadbackRing ring;
+    std::deque<GenerationStats> ready;
+
+    // Ring consumer: queues a finished step's Block as its GenerationStats
+    void store(const void* data, unsigned long long generation);
+    ReadbackRing::Consumer storer() { return [this](const void* data, unsigned long long tag) { store(data, tag); }; }
+};
+
+#endif
@@ -0,0 +1,36 @@
+#ifndef GPU_UNIVERSE_BATCH_H
+#define GPU_UNIVERSE_BATCH_H
+
+#include <glad/glad.h>
+#include "compute_shader_program.h"
+#include "universe_batch.h"
+
+// A UniverseBatch stepped on the GPU (batchStep.comp). GLSL has no 64 bit words, so each 64 universe slice is
+// two 32 universe slices here; the layout is otherwise the CPU one, border included. One dispatch advances
+// every universe a generation, & a run of generations is one bind plus a dispatch & barrier per generation:
+// there are no per-universe dispatches, uniforms or buffer binds
+class GpuUniverseBatch
+{
+public:
+    static constexpr GLuint CELLS0_BINDING = 7;     // The two generations ping-pong between these...
+    static constexpr GLuint CELLS1_BINDING = 8;
+    static constexpr GLuint RULES_BINDING = 9;      // ...under these per slice masks
+
+    explicit GpuUniverseBatch(const UniverseBatch& batch);     // Sized for the batch, & loaded from it
+    ~GpuUniverseBatch();
+
+    void upload(const UniverseBatch& batch);                  // Cells & rules
+    void step(int generations = 1);
+    void download(UniverseBatch& batch) const;                // Cells
+
+private:
+    ComputeShaderProgram shader;
+    GLuint cellsBufs[2];
+    GLuint rulesBuf;
+    int width, height, slices;      // 32 universe slices
+    size_t sliceWords;
+    int currentBuf = 0;
+    GLint sourceLoc;
+};
+
+#endif
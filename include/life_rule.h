@@ -0,0 +1,55 @@
+#ifndef LIFE_RULE_H
+#define LIFE_RULE_H
+
+#include <array>
+#include <cstdint>
+#include <string>
+
+// Outer totalistic (Life-like) rule: bit n of a mask is set when a cell with n live neighbours
+// is born (dead cell) / survives (live cell).
+// With more than 2 states it's a Generations rule: only state 1 is alive (& counted as a neighbour); a live
+// cell that doesn't survive decays through states 2, 3... one per generation & then dies.
+// Isotropic non-totalistic rules (Hensel notation: B2-a/S12) also pick which arrangements of n neighbours
+// (up to rotation & reflection) count, each named by a letter; the engines then go by table().
+// Hexagonal (H suffix) & von Neumann (V) rules count 6 / 4 neighbours: hex grids are stored skewed, the
+// Moore neighbourhood less its NE & SW cells, (x+1, y+1) & (x-1, y-1) with north being +y on the board
+class LifeRule
+{
+public:
+    enum Neighbourhood { MOORE = 0, HEXAGONAL = 1, VON_NEUMANN = 2 };
+
+    static constexpr int MAX_STATES = 16;          // States fit in 4 bits
+    static constexpr const char* HENSEL_LETTERS = "cekainyqjrtwz";
+
+    unsigned birthMask = 1u << 3;                   // B3
+    unsigned surviveMask = (1u << 2) | (1u << 3);   // S23
+    int states = 2;
+    Neighbourhood neighbourhood = MOORE;
+    // Isotropic rules: bit k of xxxLetters[n] set if the arrangement of n neighbours named by letter k of
+    // HENSEL_LETTERS is born / survives (bit 0 for 0 & 8). The masks then have the counts with any set
+    bool isotropic = false;
+    std::array<uint16_t, 9> birthLetters{}, surviveLetters{};
+
+    // Accepts "B3/S23" (any case, either order) and the older "23/3" survive/birth form; Generations rules as
+    // "B2/S/C3" (or G3) and "/2/3" survive/birth/states; Hensel letters after a digit ("B2ak", "S2-i"), not
+    // with Generations; a trailing H or V (Moore only with letters or Generations). Returns false & leaves
+    // the rule untouched if the string isn't understood
+    bool parse(const std::string& text);
+    std::string toString() const;   // Canonical "B3/S23" form ("B2/S/C3" for Generations)
+
+    // Bit i of word i / 64 set: a cell whose neighbourhood is i is live next generation. Bits 0-7 of i are
+    // the neighbours N, NE, E, SE, S, SW, W, NW (N at y - 1) & bit 8 the cell. Totalistic rules too (the
+    // cells outside a hexagonal / von Neumann neighbourhood don't count)
+    std::array<uint64_t, 8> table() const;
+
+    bool isGenerations() const { return states > 2; }
+    int neighbourCount() const { return neighbourhood == HEXAGONAL ? 6 : neighbourhood == VON_NEUMANN ? 4 : 8; }
+    bool operator==(const LifeRule& other) const
+    {
+        return birthMask == other.birthMask && surviveMask == other.surviveMask && states == other.states &&
+               neighbourhood == other.neighbourhood && isotropic == other.isotropic &&
+               birthLetters == other.birthLetters && surviveLetters == other.surviveLetters;
+    }
+};
+
+#endif
@@ -0,0 +1,41 @@
+#ifndef LTL_ENGINE_H
+#define LTL_ENGINE_H
+
+#include <cstdint>
+#include <vector>
+#include "ltl_rule.h"
+#include "generation_stats.h"
+#include "stamp.h"
+
+// Larger than Life on the CPU, at a cost per cell that doesn't grow with the range. A step is two passes of
+// running (sliding window) sums: each row's window of 2R+1 cells is summed along the row, adding the cell
+// entering the window & subtracting the one leaving it, then those row sums are summed down the columns the
+// same way, which gives every cell its box count. Both passes run on row bands in parallel
+class LtlEngine
+{
+public:
+    explicit LtlEngine(int threads = 0);    // 0 = one per hardware thread
+
+    void setRule(const LtlRule& rule);
+    void loadCells(const std::vector<uint32_t>& cells, int width, int height);    // Non-zero is live
+    void toCells(std::vector<uint32_t>& cells) const;
+
+    // Advances one generation, filling 'stats' if given ('generation' is left to the caller)
+    void step(GenerationStats* stats = nullptr);
+    void stamp(const PackedGridView& pattern, int x, int y, StampMode mode);
+
+    int width() const { return _width; }
+    int height() const { return _height; }
+
+private:
+    LtlRule rule;
+    int _width = 0, _height = 0;
+    std::vector<uint8_t> current, next;
+    std::vector<uint16_t> rowSums;      // Live cells in each cell's row window
+    int threads;
+
+    void sumRows(int y0, int y1);
+    void stepRows(int y0, int y1, GenerationStats& stats, uint32_t& hashLo, uint32_t& hashHi, bool hashing);
+};
+
+#endif
@@ -0,0 +1,27 @@
+#ifndef LTL_RULE_H
+#define LTL_RULE_H
+
+#include <string>
+
+// Larger than Life rule: totalistic over the (2R+1)^2 cell box of range R around a cell, with birth &
+// survival given as ranges of live counts. Golly's "R5,C0,M1,S33..57,B34..45,NM" form (Bosco's rule):
+// M1 counts the cell itself as one of its neighbours. Only 2 states (C0 / C2) & the Moore (box)
+// neighbourhood (NM) are supported
+class LtlRule
+{
+public:
+    static constexpr int MAX_RANGE = 500;       // As in Golly; keeps a row's window sum in 16 bits
+
+    int range = 5;
+    int birthMin = 34, birthMax = 45;
+    int surviveMin = 33, surviveMax = 57;
+    bool countsSelf = true;
+
+    // Returns false & leaves the rule untouched if the string isn't understood
+    bool parse(const std::string& text);
+    std::string toString() const;
+
+    int neighbourhoodSize() const { return (2 * range + 1) * (2 * range + 1); }
+};
+
+#endif
@@ -0,0 +1,18 @@
+#ifndef MACROCELL_FILE_H
+#define MACROCELL_FILE_H
+
+#include <string>
+#include "quadtree.h"
+
+// Golly macrocell (.mc) files: a post-order list of quadtree nodes, each line either an 8x8 leaf
+// ("..*$.*$" rows top to bottom) or "level nw ne sw se" referring to earlier lines (0 = empty).
+// Lines map one to one onto hash-consed QuadTree nodes, so loading costs O(lines) whatever the
+// area the pattern covers. Only 2-state ([M2]) files are supported
+class MacrocellFile
+{
+public:
+    static bool load(const std::string& path, QuadTree& tree, std::string* rule = nullptr, unsigned long long* generation = nullptr);
+    static bool save(const std::string& path, const QuadTree& tree, const std::string& rule, unsigned long long generation = 0);
+};
+
+#endif
@@ -0,0 +1,54 @@
+#ifndef MARGOLUS_ENGINE_H
+#define MARGOLUS_ENGINE_H
+
+#include <array>
+#include <cstdint>
+#include <vector>
+#include "margolus_rule.h"
+#include "generation_stats.h"
+#include "stamp.h"
+
+// Margolus rules (see MargolusRule) on the CPU: a byte per cell, stepped in place, as no block reads a cell
+// another one writes. On x86 with SSSE3 (checked at run time) 16 blocks go at once: their cells are gathered
+// into 16 table indices, which one byte shuffle (pshufb) looks up in the table held in a register, & the
+// results are scattered back; the rest of a row pair goes a block at a time. Row pairs are split into bands,
+// one per thread. Blocks the offset partition leaves hanging over the board's edges are left as they are, so
+// a reversible rule's step stays a permutation of the whole board & stepping backwards undoes it exactly.
+// The stats are a pass of their own over the board & the copy taken before the step; the hash is
+// complemented on odd partitions, so boards only match when the next step cuts them the same way
+class MargolusEngine
+{
+public:
+    explicit MargolusEngine(int threads = 0);    // 0 = one per hardware thread
+
+    void setRule(const MargolusRule& rule);
+    void loadCells(const std::vector<uint32_t>& cells, int width, int height);    // Non-zero is live
+    void toCells(std::vector<uint32_t>& cells) const;
+
+    // Advances one generation, or undoes the last one when 'backward' (reversible rules only), filling
+    // 'stats' if given ('generation' is left to the caller)
+    void step(bool backward = false, GenerationStats* stats = nullptr);
+    void stamp(const PackedGridView& pattern, int x, int y, StampMode mode);
+    // Turns the byte shuffle path off (or back on, where the CPU has it), e.g. to check it against the block at a time one
+    void setShuffle(bool on);
+    bool shuffling() const { return shuffle; }
+
+    // Steps forward less steps back, since loading: its parity picks the partition
+    long long time() const { return _time; }
+    int width() const { return _width; }
+    int height() const { return _height; }
+
+private:
+    MargolusRule rule;
+    std::array<uint8_t, 16> forwardTable, backwardTable;
+    int _width = 0, _height = 0;
+    std::vector<uint8_t> current, previous;     // 'previous' is only kept for the stats
+    long long _time = 0;
+    bool shuffle;
+    int threads;
+
+    void stepPairs(int pair0, int pair1, int offset, const uint8_t* table);
+    void statsRows(int y0, int y1, GenerationStats& stats, uint32_t& hashLo, uint32_t& hashHi);
+};
+
+#endif
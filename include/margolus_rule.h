@@ -0,0 +1,27 @@
+#ifndef MARGOLUS_RULE_H
+#define MARGOLUS_RULE_H
+
+#include <array>
+#include <cstdint>
+#include <string>
+
+// Margolus (block partitioning) rule: the board is cut into 2x2 blocks, offset by (1, 1) on every other
+// generation, & each block is replaced as a whole through a 16 entry table. A block's index is its cells'
+// weights summed, as in MCell & Golly: upper-left 1, upper-right 2, lower-left 4, lower-right 8 (upper
+// being +y). Written "MS,D0;8;4;3;2;5;9;7;1;6;10;11;12;13;14;15" (the table in order), or by name:
+// BBM (the billiard-ball machine), Critters, Tron. A table that's a permutation is reversible: its
+// inverse, applied with the same block offsets in reverse order, steps the board backwards exactly
+class MargolusRule
+{
+public:
+    std::array<uint8_t, 16> table = { 0, 8, 4, 3, 2, 5, 9, 7, 1, 6, 10, 11, 12, 13, 14, 15 };  // BBM
+
+    // Returns false & leaves the rule untouched if the string isn't understood
+    bool parse(const std::string& text);
+    std::string toString() const;
+
+    bool reversible() const;
+    std::array<uint8_t, 16> inverse() const;     // Only meaningful when reversible()
+};
+
+#endif
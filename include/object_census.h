@@ -0,0 +1,87 @@
+#ifndef OBJECT_CENSUS_H
+#define OBJECT_CENSUS_H
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "packed_grid.h"
+#include "life_rule.h"
+
+// Splits a board into objects & tallies them by apgcode, apgsearch style.
+//  - Labelling: union-find over runs of live cells, which come straight out of the packed words. Cells within
+//    2 of each other join a cluster - further apart, no dead cell neighbours both, so clusters can't interact.
+//    Rows are split into bands labelled on separate threads, then the band seams are joined
+//  - Splitting: a cluster's 8-connected parts are tallied separately if they evolve just as they do on their
+//    own (e.g. a bi-block is two blocks); otherwise (say, pieces only stable together) the cluster is one object
+//  - Classification: each object is evolved on its own to find its period & displacement, then named by its
+//    extended Wechsler code, minimised over the 8 orientations & every phase: "xs<population>_" still lifes,
+//    "xp<period>_" oscillators, "xq<period>_" spaceships ("zz_DIES" / "zz_UNKNOWN" if it dies, or nothing
+//    repeats within MAX_PERIOD). Results are cached by the cluster's exact cells, so the common ash costs a lookup
+class ObjectCensus
+{
+public:
+    static constexpr int MAX_PERIOD = 64;
+
+    struct Object {
+        std::string code;
+        int minX, minY, maxX, maxY;     // Inclusive, board coordinates
+        uint32_t population;
+    };
+
+    explicit ObjectCensus(int threads = 0);     // 0 = one per hardware thread
+
+    void setRule(const LifeRule& rule);         // Clears the classification cache
+
+    // Labels & classifies the grid's objects, adding them to the table
+    void take(const PackedGrid& grid);
+    // Adds another census's table to this one
+    void merge(const ObjectCensus& other);
+    void clear();
+
+    const std::vector<Object>& objects() const { return _objects; }     // Of the last take()
+    const std::map<std::string, uint64_t>& table() const { return _table; }
+
+    // "code,count" lines, most common first
+    bool write(const std::string& path) const;
+
+private:
+    struct Run {
+        int y, x0, x1;      // Inclusive
+    };
+    // Object cells, row 0 at the top (apgcode order)
+    struct Bitmap {
+        int width = 0, height = 0;
+        std::vector<uint8_t> cells;
+        bool get(int x, int y) const { return cells[y * width + x] != 0; }
+    };
+    // An object within a cluster's bitmap
+    struct Piece {
+        std::string code;
+        int x, y, width, height;
+        uint32_t population;
+    };
+
+    int threads;
+    LifeRule rule;
+    std::vector<Object> _objects;
+    std::map<std::string, uint64_t> _table;
+    std::unordered_map<std::string, std::vector<Piece>> pieceCache;    // Cluster bitmap key -> its objects
+
+    // Runs of the grid (row by row) & the cluster id of each; returns the cluster count
+    int label(const PackedGrid& grid, std::vector<Run>& runs, std::vector<int>& cluster) const;
+    std::vector<Piece> classifyCluster(const Bitmap& cluster) const;
+    std::string classify(const Bitmap& object) const;
+    // Whether the cluster evolves for 'generations' exactly as the union of its parts evolving on their own
+    bool evolvesApart(const Bitmap& cluster, const std::vector<Piece>& pieces, const std::vector<Bitmap>& parts, int generations) const;
+
+    static void extractRuns(const PackedGrid& grid, int y0, int y1, std::vector<Run>& runs, std::vector<size_t>& rowStart);
+    static std::vector<Piece> splitParts(const Bitmap& cluster, std::vector<Bitmap>& parts);
+    static void paint(const Bitmap& bitmap, PackedGrid& grid, int x, int y);
+    static Bitmap crop(const PackedGrid& grid, int minX, int minY, int maxX, int maxY);
+    static Bitmap orient(const Bitmap& bitmap, int orientation);
+    static std::string wechsler(const Bitmap& bitmap);
+};
+
+#endif
@@ -0,0 +1,70 @@
+#ifndef OFFSCREEN_CAPTURE_H
+#define OFFSCREEN_CAPTURE_H
+
+#include <glad/glad.h>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include <deque>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+
+// Renders into an FBO instead of the window and streams the frames out.
+// Readback goes through a ring of PBOs: glReadPixels only queues a DMA into the PBO, which is
+// mapped a few frames later once its fence has signalled, so the copy overlaps the next steps.
+// Encoding / writing happens on a separate writer thread.
+class OffscreenCapture
+{
+public:
+    OffscreenCapture(int width, int height, int numPBOs = 3);
+    ~OffscreenCapture();
+
+    // Sinks (any combination may be open at once)
+    bool openPngSequence(const std::string& pathPattern);  // printf-style, e.g. "frames/frame_%06d.png"
+    bool openRawPipe(const std::string& command);          // Raw RGBA, top row first, written to the command's stdin
+
+    // Makes the FBO the current render target
+    void bindFramebuffer();
+    // Queues an async readback of the current FBO contents & hands any finished readback to the writer
+    void captureFrame();
+    // Flushes all in-flight readbacks and waits for the writer to finish
+    void finish();
+
+    int width() const { return _width; }
+    int height() const { return _height; }
+    unsigned long long framesWritten() const { return _framesWritten; }
+
+private:
+    struct Frame {
+        unsigned long long index;
+        std::vector<unsigned char> pixels;
+    };
+
+    int _width, _height;
+    GLuint FBO, colourRBO, depthRBO;
+    std::vector<GLuint> PBOs;
+    std::vector<GLsync> fences;
+    std::vector<unsigned long long> pboFrameIndex;
+    unsigned long long nextFrameIndex = 0;
+    std::atomic<unsigned long long> _framesWritten{0};
+
+    std::string pngPattern;
+    FILE* rawPipe = nullptr;
+
+    // Writer thread & its bounded queue (bounded so a slow sink applies backpressure instead of eating memory)
+    static constexpr size_t MAX_QUEUED_FRAMES = 8;
+    std::thread writer;
+    std::mutex queueMutex;
+    std::condition_variable queueCV;
+    std::deque<Frame> queue;
+    std::vector<std::vector<unsigned char>> freeBuffers;
+    bool stopping = false;
+
+    void collectPBO(int slot);
+    void writerLoop();
+    void writeFrame(const Frame& frame);
+};
+
+#endif
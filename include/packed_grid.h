@@ -0,0 +1,91 @@
+#ifndef PACKED_GRID_H
+#define PACKED_GRID_H
+
+#include <cstdint>
+#include <cstddef>
+#include <new>
+#include <vector>
+
+// Allocator giving 64-byte (cache line) aligned storage, so each grid row starts on a line boundary
+template <typename T>
+struct CacheLineAllocator
+{
+    typedef T value_type;
+    static constexpr size_t ALIGNMENT = 64;
+
+    CacheLineAllocator() {}
+    template <typename U> CacheLineAllocator(const CacheLineAllocator<U>&) {}
+
+    T* allocate(size_t n) { return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t(ALIGNMENT))); }
+    void deallocate(T* p, size_t) { ::operator delete(p, std::align_val_t(ALIGNMENT)); }
+
+    template <typename U> bool operator==(const CacheLineAllocator<U>&) const { return true; }
+    template <typename U> bool operator!=(const CacheLineAllocator<U>&) const { return false; }
+};
+
+// Non-owning read-only view of rows laid out like a PackedGrid's, e.g. straight out of a mapped snapshot
+struct PackedGridView
+{
+    const uint64_t* words = nullptr;
+    int width = 0, height = 0;
+    size_t wordsPerRow = 0;
+
+    const uint64_t* row(int y) const { return words + wordsPerRow * y; }
+    bool get(int x, int y) const { return (row(y)[x >> 6] >> (x & 63)) & 1; }
+};
+
+// Dense bit-packed board: 1 bit per cell, bit (x & 63) of word (x >> 6) in row y.
+// Rows are padded to a multiple of 8 words (64 bytes) so every row is cache line aligned;
+// padding bits are always kept 0
+class PackedGrid
+{
+public:
+    static constexpr int WORD_BITS = 64;
+    static constexpr size_t ROW_ALIGN_WORDS = 8;
+
+    PackedGrid() {}
+    PackedGrid(int width, int height) { resize(width, height); }
+
+    // Resizing clears the grid
+    void resize(int width, int height);
+    void clear();
+
+    int width() const { return _width; }
+    int height() const { return _height; }
+    size_t wordsPerRow() const { return _wordsPerRow; }     // Row stride (includes padding)
+    size_t usedWordsPerRow() const { return (static_cast<size_t>(_width) + WORD_BITS - 1) / WORD_BITS;  }
+    size_t sizeInBytes() const { return words.size() * sizeof(uint64_t); }
+
+    uint64_t* row(int y) { return words.data() + _wordsPerRow * y; }
+    const uint64_t* row(int y) const { return words.data() + _wordsPerRow * y; }
+    uint64_t* data() { return words.data(); }
+    const uint64_t* data() const { return words.data(); }
+
+    bool get(int x, int y) const { return (row(y)[x >> 6] >> (x & 63)) & 1; }
+    void set(int x, int y, bool alive)
+    {
+        uint64_t bit = 1ull << (x & 63);
+        if (alive) row(y)[x >> 6] |= bit;
+        else       row(y)[x >> 6] &= ~bit;
+    }
+    // Sets 'length' cells starting at (x, y) alive, a word at a time. Cells past the right edge are dropped
+    void setRun(int x, int y, int length);
+
+    size_t population() const;
+
+    PackedGridView view() const { return { words.data(), _width, _height, _wordsPerRow }; }
+    // Copies a view's cells in (resizing to match)
+    void assign(const PackedGridView& source);
+
+    // Conversion to / from the one-uint32-per-cell layout used by the GPU SSBOs
+    void toCells(std::vector<uint32_t>& cells) const;
+    void fromCells(const std::vector<uint32_t>& cells, int width, int height) { fromCells(cells.data(), width, height); }
+    void fromCells(const uint32_t* cells, int width, int height);
+
+private:
+    int _width = 0, _height = 0;
+    size_t _wordsPerRow = 0;
+    std::vector<uint64_t, CacheLineAllocator<uint64_t>> words;
+};
+
+#endif
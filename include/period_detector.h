@@ -0,0 +1,32 @@
+#ifndef PERIOD_DETECTOR_H
+#define PERIOD_DETECTOR_H
+
+#include <cstdint>
+#include <vector>
+
+// Spots a board that has become periodic (still life = period 1, oscillators, or a stable mix) from its
+// per generation hashes. The last maxPeriod hashes are kept in a ring; each new one is compared with them,
+// the nearest match giving the candidate period p. A period is only reported once the hashes have repeated
+// with it for p generations in a row, so one-off hash collisions aren't taken for periodicity
+class PeriodDetector
+{
+public:
+    explicit PeriodDetector(int maxPeriod);
+
+    // Feeds the hash of the next generation (generations must come in order, one each).
+    // Returns the period on the generation it's confirmed, else 0
+    int add(unsigned long long generation, uint64_t hash);
+    void reset();
+
+    // Generation from which the board has been periodic (valid once add() has returned a period)
+    unsigned long long periodicSince() const { return _periodicSince; }
+
+private:
+    std::vector<uint64_t> history;      // Ring: hash of generation g at g % history.size()
+    unsigned long long count = 0;       // Hashes fed since the last reset
+    int candidate = 0;                  // Period being confirmed
+    int repeats = 0;                    // Generations in a row that have repeated with it
+    unsigned long long _periodicSince = 0;
+};
+
+#endif
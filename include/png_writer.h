@@ -0,0 +1,19 @@
+#ifndef PNG_WRITER_H
+#define PNG_WRITER_H
+
+#include <string>
+#include <vector>
+
+// Minimal, dependency-free PNG encoder for 8-bit RGBA frames.
+// Rows are 'Sub' filtered and deflated with fixed Huffman codes + byte run matches, which
+// compresses the large flat areas of a cell board well without pulling in zlib
+class PNGWriter
+{
+public:
+    // 'rgba' holds width * height * 4 bytes; set flipY when rows are stored bottom-up (as glReadPixels returns them)
+    static bool write(const std::string& path, int width, int height, const unsigned char* rgba, bool flipY);
+    // Encodes into memory instead of a file
+    static void encode(std::vector<unsigned char>& out, int width, int height, const unsigned char* rgba, bool flipY);
+};
+
+#endif
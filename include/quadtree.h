@@ -0,0 +1,92 @@
+#ifndef QUADTREE_H
+#define QUADTREE_H
+
+#include <cstdint>
+#include <vector>
+#include <unordered_map>
+#include "packed_grid.h"
+#include "tile_store.h"
+
+// Hash-consed quadtree of cells: every distinct subtree is stored once, so highly repetitive patterns
+// (breeders, metacells) cost memory proportional to their number of distinct blocks, not their area.
+// Leaves are 8x8 blocks (level 3); a level L node covers 2^L x 2^L cells.
+// Coordinates follow the board: x right, y up, a node's origin is its bottom-left corner
+class QuadTree
+{
+public:
+    typedef uint32_t NodeId;
+    static constexpr NodeId EMPTY = 0;      // The all-dead node, at any level
+    static constexpr int LEAF_LEVEL = 3;
+    static constexpr int TILE_LEVEL = 6;    // Matches TileStore::TILE_SIZE
+
+    struct Node {
+        uint64_t leafBits;      // Level 3 only: bit (y*8 + x)
+        NodeId nw, ne, sw, se;
+        uint8_t level;
+    };
+
+    struct Box {
+        int64_t minX, minY, maxX, maxY;     // Inclusive
+        bool empty() const { return maxX < minX; }
+    };
+
+    QuadTree();
+
+    // Returns the unique id for the given contents (creating it if new)
+    NodeId leaf(uint64_t bits);
+    NodeId node(int level, NodeId nw, NodeId ne, NodeId sw, NodeId se);
+
+    const Node& get(NodeId id) const { return nodes[id]; }
+    size_t nodeCount() const { return nodes.size(); }
+
+    NodeId root() const { return _root; }
+    int rootLevel() const { return _rootLevel; }
+    void setRoot(NodeId id, int level) { _root = id; _rootLevel = level; }
+
+    // Bounding box of the live cells relative to the root's origin (empty box if no cells)
+    Box boundingBox() const;
+    uint64_t population() const;
+
+    // Writes the cells inside the window (tile-aligned) into the tile store, the root's origin at (0, 0)
+    void paintTiles(TileStore& store, int64_t minX, int64_t minY, int64_t maxX, int64_t maxY) const;
+    // Writes all cells into the grid with the root's origin at (offsetX, offsetY); cells outside are dropped
+    void paintGrid(PackedGrid& grid, int64_t offsetX, int64_t offsetY) const;
+
+    // Replaces the tree with the contents of a grid (root origin = grid cell (0, 0))
+    void buildFromGrid(const PackedGrid& grid);
+    void clear();
+
+private:
+    struct NodeKey {
+        NodeId nw, ne, sw, se;
+        uint8_t level;
+        bool operator==(const NodeKey& o) const { return nw == o.nw && ne == o.ne && sw == o.sw && se == o.se && level == o.level; }
+    };
+    struct NodeKeyHash {
+        size_t operator()(const NodeKey& k) const
+        {
+            uint64_t h = k.level;
+            h = h * 0x9E3779B97F4A7C15ull + k.nw;
+            h = h * 0x9E3779B97F4A7C15ull + k.ne;
+            h = h * 0x9E3779B97F4A7C15ull + k.sw;
+            h = h * 0x9E3779B97F4A7C15ull + k.se;
+            return static_cast<size_t>(h ^ (h >> 29));
+        }
+    };
+
+    std::vector<Node> nodes;
+    std::unordered_map<uint64_t, NodeId> leafIndex;
+    std::unordered_map<NodeKey, NodeId, NodeKeyHash> nodeIndex;
+    NodeId _root = EMPTY;
+    int _rootLevel = LEAF_LEVEL;
+
+    Box nodeBox(NodeId id, std::unordered_map<NodeId, Box>& memo) const;
+    uint64_t nodePopulation(NodeId id, std::unordered_map<NodeId, uint64_t>& memo) const;
+    void tileRows(NodeId id, int level, int x0, int y0, uint64_t* rows) const;
+    void paintTilesRec(NodeId id, int level, int64_t x0, int64_t y0, TileStore& store,
+                       int64_t minX, int64_t minY, int64_t maxX, int64_t maxY) const;
+    void paintGridRec(NodeId id, int level, int64_t x0, int64_t y0, PackedGrid& grid) const;
+    NodeId buildRec(const PackedGrid& grid, int level, int x0, int y0);
+};
+
+#endif
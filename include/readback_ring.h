@@ -0,0 +1,45 @@
+#ifndef READBACK_RING_H
+#define READBACK_RING_H
+
+#include <glad/glad.h>
+#include <cstddef>
+#include <functional>
+#include <vector>
+
+// Asynchronous GPU -> CPU readback through a ring of buffers. Each request fills the ring's next() buffer
+// with GPU commands the caller issues (a dispatch writing it, a buffer copy...) & is then fenced by submit().
+// A buffer is mapped & handed back only once its fence has signalled (normally a frame or two later), so
+// the caller never waits on the GPU. Only a full ring waits, for its oldest request, when next() is reused
+class ReadbackRing
+{
+public:
+    // Gets a finished request's contents (mapped: valid only during the call) & the tag it was submitted with
+    using Consumer = std::function<void(const void* data, unsigned long long tag)>;
+
+    ReadbackRing(int slots, size_t bytes, GLenum usage = GL_DYNAMIC_READ);
+    ~ReadbackRing();
+
+    size_t bytes() const { return _bytes; }
+    size_t inFlight() const { return _inFlight; }
+    bool full() const { return _inFlight == buffers.size(); }
+
+    // The buffer the next request fills. The ring must not be full: collect() the oldest first
+    GLuint next() const { return buffers[nextSlot]; }
+    // Fences the commands filling next(); its contents come back with 'tag'
+    void submit(unsigned long long tag);
+    // Hands the oldest request to 'consume' if the GPU is done with it (without waiting)
+    bool poll(const Consumer& consume);
+    // Waits for the oldest request & hands it to 'consume'
+    void collect(const Consumer& consume);
+    // Waits for every request in flight, oldest first
+    void flush(const Consumer& consume);
+
+private:
+    size_t _bytes;
+    std::vector<GLuint> buffers;
+    std::vector<GLsync> fences;
+    std::vector<unsigned long long> tags;
+    size_t nextSlot = 0, oldestSlot = 0, _inFlight = 0;
+};
+
+#endif
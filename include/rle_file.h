@@ -0,0 +1,40 @@
+#ifndef RLE_FILE_H
+#define RLE_FILE_H
+
+#include <string>
+#include <vector>
+#include <functional>
+#include "packed_grid.h"
+
+// Standard run length encoded pattern files ("x = 3, y = 3, rule = B3/S23" header + "bo$2bo$3o!").
+// Loading streams the file through a fixed-size buffer & sets runs straight into the packed grid, so
+// memory use is bounded by the grid itself, whatever the file size.
+// Multi-state patterns ('.' for state 0, A..X for 1-24, pA..yO past that) load & save as one state per cell.
+// RLE rows run top to bottom, while board row 0 is drawn at the bottom: rows are flipped on the way in / out
+class RLEFile
+{
+public:
+    struct Header {
+        long long width = 0, height = 0;
+        std::string rule;       // Empty if the file doesn't give one
+    };
+
+    static bool readHeader(const std::string& path, Header& header);
+    // Writes the pattern into 'grid' with its bottom-left corner at (offsetX, offsetY); cells outside the grid are dropped
+    static bool load(const std::string& path, PackedGrid& grid, int offsetX, int offsetY, Header* header = nullptr);
+    // Saves the bounding box of the live cells
+    static bool save(const std::string& path, const PackedGrid& grid, const std::string& rule);
+
+    // As load() & save(), for a board of states ('cells', width x height, row 0 at the bottom). Loading
+    // keeps the states as they are ('o' is 1); saving always writes multi-state letters
+    static bool loadStates(const std::string& path, std::vector<uint32_t>& cells, int width, int height, int offsetX, int offsetY,
+                           Header* header = nullptr);
+    static bool saveStates(const std::string& path, const std::vector<uint32_t>& cells, int width, int height, const std::string& rule);
+
+private:
+    static bool parseHeaderLine(const std::string& line, Header& header);
+    // Streams the file, calling paint(x, row, run, state) for each run of live cells (row 0 at the top)
+    static bool decode(const std::string& path, Header& header, const std::function<void(long long, long long, long long, unsigned)>& paint);
+};
+
+#endif
@@ -0,0 +1,27 @@
+#ifndef RULE_3D_H
+#define RULE_3D_H
+
+#include <cstdint>
+#include <string>
+
+// Life-like rule on a cubic lattice: totalistic over the 26 cells around a cell (Moore), or its 6 face
+// neighbours (von Neumann). Written "B5/S45", with commas between counts once any passes 9 ("B5/S4,5,10"),
+// & a trailing V for von Neumann neighbours as in 2D. Bays' four digit form is read too: the survival
+// range then the birth range, so "4555" (his Life 4555) is S45 & B5
+class Rule3D
+{
+public:
+    static constexpr int MAX_NEIGHBOURS = 26;
+
+    uint32_t birthMask = 1u << 5;                       // Bit n set: a dead cell with n live neighbours is born
+    uint32_t surviveMask = (1u << 4) | (1u << 5);       // Bit n set: a live cell with n live neighbours survives
+    bool vonNeumann = false;
+
+    // Returns false & leaves the rule untouched if the string isn't understood
+    bool parse(const std::string& text);
+    std::string toString() const;
+
+    int neighbourCount() const { return vonNeumann ? 6 : MAX_NEIGHBOURS; }
+};
+
+#endif
@@ -0,0 +1,43 @@
+#ifndef RULE_DIAGRAM_H
+#define RULE_DIAGRAM_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// A 512 entry rule table (LifeRule::table()) as a reduced ordered binary decision diagram over the 9 cells
+// of the neighbourhood, so it can be evaluated bit-parallel: with each input a word of 64 cells, every node
+// is one select, lo ^ (input & (lo ^ hi)). Isotropic rules come to a few dozen nodes, about the work of
+// the bit-sliced neighbour count. A few variable orders are tried & the smallest diagram kept
+class RuleDiagram
+{
+public:
+    static constexpr int MAX_NODES = 512;
+
+    void build(const std::array<uint64_t, 8>& table);
+    size_t size() const { return nodes.size(); }
+
+    // 'in' holds the neighbourhood's words in table index order (N, NE, E, SE, S, SW, W, NW, cell)
+    uint64_t evaluate(const uint64_t in[9]) const
+    {
+        uint64_t value[MAX_NODES + 2];
+        value[0] = 0;
+        value[1] = ~0ull;
+        uint64_t* out = value + 2;
+        for (const Node& node : nodes) {
+            uint64_t lo = value[node.lo];
+            *out++ = lo ^ (in[node.input] & (lo ^ value[node.hi]));
+        }
+        return value[root];
+    }
+
+private:
+    struct Node {
+        uint16_t input, lo, hi;     // lo & hi index the constants 0 & 1, then the nodes (children come first)
+    };
+    std::vector<Node> nodes;
+    uint16_t root = 0;
+};
+
+#endif
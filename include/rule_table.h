@@ -0,0 +1,76 @@
+#ifndef RULE_TABLE_H
+#define RULE_TABLE_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "cell_hash.h"
+
+// Golly rule table: the @TABLE section of a .rule file (or a bare .table file), for automata with up to 256
+// states over the Moore or von Neumann neighbourhood. Its transition lines, variables & symmetries are all
+// expanded when the file is loaded, into a lookup keyed by the cell's whole neighbourhood, so stepping a
+// cell is one lookup whatever the table looks like. First matching line wins & unmatched cells keep their
+// state, as in Golly.
+// A key packs bitsPerState bits per cell: the cell itself in the lowest, then its neighbours in Golly's
+// order (N, NE, E, SE, S, SW, W, NW, or N, E, S, W), north being +y on the board. Short keys index a dense
+// byte table; longer ones go through a perfect hash (hash & displace) of just the transitions that change
+// the cell, so a lookup is two hashes & one compare
+class RuleTable
+{
+public:
+    enum Neighbourhood { MOORE, VON_NEUMANN };
+
+    static constexpr int MAX_STATES = 256;
+    static constexpr int MAX_MOORE_STATES = 128;    // Keeps a Moore key in 63 bits
+    static constexpr int DENSE_MAX_BITS = 24;       // Keys up to this long index a table (of at most 16MB)
+
+    // One perfect hash slot, as the GPU reads it (a uvec4); empty slots hold EMPTY_KEY, which no key reaches
+    struct Slot {
+        uint32_t keyLo, keyHi, output, unused;
+    };
+    static constexpr uint32_t EMPTY_KEY = 0xffffffffu;
+
+    std::string name;
+    int states = 2;
+    Neighbourhood neighbourhood = MOORE;
+    int bitsPerState = 1;
+    std::vector<uint32_t> colours;      // 0xRRGGBB per state, from @COLORS or Golly's default red to yellow
+
+    // Prints what's wrong (with the line) & returns false if the file can't be used
+    bool load(const std::string& path);
+
+    int neighbourCount() const { return neighbourhood == MOORE ? 8 : 4; }
+    int keyBits() const { return bitsPerState * (neighbourCount() + 1); }
+    bool dense() const { return !denseTable.empty(); }
+    size_t transitions() const { return changing; }     // Keys whose cell changes state
+
+    // The cell's next state
+    uint32_t lookup(uint64_t key) const
+    {
+        if (!denseTable.empty()) return denseTable[key];
+        uint32_t lo = static_cast<uint32_t>(key), hi = static_cast<uint32_t>(key >> 32);
+        const Slot& slot = slots[hashKey(lo, hi, seeds[hashKey(lo, hi, 0) % seeds.size()]) % slots.size()];
+        return slot.keyLo == lo && slot.keyHi == hi ? slot.output : lo & ((1u << bitsPerState) - 1);
+    }
+
+    // ruleTableStep.comp has the same function: the two must match bit for bit
+    static uint32_t hashKey(uint32_t lo, uint32_t hi, uint32_t seed)
+    {
+        return lowbias32(lo ^ lowbias32(hi + 0x9e3779b9u * seed));
+    }
+
+    // The lookup's tables, for the GPU: the dense one, else the slots & a seed per bucket
+    const std::vector<uint8_t>& denseEntries() const { return denseTable; }
+    const std::vector<Slot>& hashSlots() const { return slots; }
+    const std::vector<uint32_t>& bucketSeeds() const { return seeds; }
+
+private:
+    std::vector<uint8_t> denseTable;
+    std::vector<Slot> slots;
+    std::vector<uint32_t> seeds;
+    size_t changing = 0;
+
+    bool buildPerfectHash(std::vector<std::pair<uint64_t, uint8_t>>& entries);
+};
+
+#endif
@@ -0,0 +1,44 @@
+#ifndef RULE_TABLE_ENGINE_H
+#define RULE_TABLE_ENGINE_H
+
+#include <cstdint>
+#include <vector>
+#include "rule_table.h"
+#include "generation_stats.h"
+#include "stamp.h"
+
+// Rule tables (see RuleTable) on the CPU: a byte per cell, with a border of dead cells around the board so
+// neighbours are read without bounds checks. A cell's neighbourhood is packed into its table key & looked
+// up, one lookup per cell. Rows are stepped in bands, one per thread.
+// Any non-zero state counts as live for the stats; the hash mixes in states past 1 as GenerationsEngine's does
+class RuleTableEngine
+{
+public:
+    explicit RuleTableEngine(int threads = 0);    // 0 = one per hardware thread
+
+    void setRule(const RuleTable& table);       // Kept by reference: the table must outlive the engine
+    // Cell values are states (values past the last state are taken as state 1)
+    void loadCells(const std::vector<uint32_t>& cells, int width, int height);
+    void toCells(std::vector<uint32_t>& cells) const;
+
+    // Advances one generation, filling 'stats' if given ('generation' is left to the caller)
+    void step(GenerationStats* stats = nullptr);
+    // Pattern cells are state 1, combined as stampState() does
+    void stamp(const PackedGridView& pattern, int x, int y, StampMode mode);
+
+    int width() const { return _width; }
+    int height() const { return _height; }
+
+private:
+    const RuleTable* table = nullptr;
+    int _width = 0, _height = 0;
+    size_t stride = 0;                      // Of a padded row
+    std::vector<uint8_t> current, next;     // (width + 2) x (height + 2), cell (x, y) at (y + 1) * stride + x + 1
+    int threads;
+
+    uint8_t& cell(int x, int y) { return current[(y + 1) * stride + x + 1]; }
+    template <int NEIGHBOURS>
+    void stepRows(int y0, int y1, GenerationStats& stats, uint32_t& hashLo, uint32_t& hashHi, bool hashing);
+};
+
+#endif
@@ -26,12 +26,14 @@ public:
     void setInt_w_Loc(GLint location, int value) const;
     void setFloat_w_Name(const std::string &name, float value) const;
     void setFloat_w_Loc(GLint location, float value) const;
+    void set2Floats_w_Name(const std::string &name, float value0, float value1) const;
+    void set2Floats_w_Loc(GLint location, float value0, float value1) const;
     void set4Floats_w_Name(const std::string &name, float value0, float value1, float value2, float value3) const;   
     void set4Floats_w_Loc(GLint location, float value0, float value1, float value2, float value3) const;   
     void setMat4_w_Name(const std::string &name, GLboolean transpose, const GLfloat* value) const;
     void setMat4_w_Loc(GLint location, GLboolean transpose, const GLfloat* value) const;
 protected:
-    unsigned readAndCompileShaderFile(const char* shaderPath, unsigned& shaderID, std::string shaderType);
+    unsigned readAndCompileShaderFile(const char* shaderPath, unsigned& shaderID, std::string shaderType, const std::string& prelude = "");
     void checkCompileErrors(unsigned& shaderID, std::string shaderType);
     virtual void checkLinkErrors();
 };
@@ -0,0 +1,63 @@
+#ifndef SNAPSHOT_FILE_H
+#define SNAPSHOT_FILE_H
+
+#include <cstdint>
+#include <string>
+#include "mapped_file.h"
+#include "packed_grid.h"
+#include "life_rule.h"
+
+// Binary board snapshot, laid out so it can be used straight from a memory mapping with no parse step:
+//  - a 64 byte header (below)
+//  - 'height' rows of 'wordsPerRow' little endian uint64 words, bit (x & 63) of word (x >> 6) = cell x.
+//    wordsPerRow is a multiple of 8, so with the data at offset 64 every row starts on a cache line,
+//    exactly like a PackedGrid (the mapped rows can be wrapped in a PackedGridView)
+// The checksum covers the row data. It isn't checked on open (that would page in the whole file);
+// call verifyChecksum() when the file may be damaged
+class SnapshotFile
+{
+public:
+    static constexpr uint32_t VERSION = 1;
+    static constexpr size_t HEADER_BYTES = 64;
+
+    enum Topology : uint32_t {
+        BOUNDED = 0,    // Cells beyond the edges are dead (what the compute shader does)
+        TORUS = 1
+    };
+
+    struct Header {
+        char magic[8];              // "GOLSNAP\0"
+        uint32_t version;
+        uint32_t headerBytes;
+        uint32_t width, height;
+        uint32_t wordsPerRow;       // uint64 words per row, padding included
+        uint32_t topology;
+        uint64_t generation;
+        uint32_t birthMask, surviveMask;
+        uint64_t dataBytes;
+        uint64_t checksum;
+    };
+    static_assert(sizeof(Header) == HEADER_BYTES, "snapshot header must stay 64 bytes");
+
+    // Written to path + ".tmp" & renamed over 'path', so a crash never leaves a half written snapshot.
+    // 'durable' also flushes the file (& its directory entry) to disk before returning
+    static bool save(const std::string& path, const PackedGridView& grid, const LifeRule& rule,
+                     unsigned long long generation, Topology topology = BOUNDED, bool durable = false);
+    static uint64_t checksum(const uint64_t* words, size_t count);
+
+    // Maps the file & validates its header
+    bool open(const std::string& path);
+    void close() { file.close(); }
+    bool isOpen() const { return file.isOpen(); }
+
+    const Header& header() const { return *reinterpret_cast<const Header*>(file.data()); }
+    const uint64_t* data() const { return reinterpret_cast<const uint64_t*>(file.data() + HEADER_BYTES); }
+    PackedGridView grid() const;
+    LifeRule rule() const;
+    bool verifyChecksum() const;
+
+private:
+    MappedFile file;
+};
+
+#endif
@@ -0,0 +1,56 @@
+#ifndef SOUP_SEARCH_H
+#define SOUP_SEARCH_H
+
+#include <atomic>
+#include <cstdint>
+#include "packed_grid.h"
+#include "life_rule.h"
+#include "object_census.h"
+
+// Random soup search, apgsearch style: soups are evolved until they settle & what's left is censused.
+//  - Soup k of a search is a function of (seed, k) only (a counter-based generator), so any soup can be
+//    regenerated on its own & results don't depend on the thread count
+//  - Each worker thread runs one small universe at a time on the CPU engine, soup in the middle. A border
+//    band is cleared every few generations, so escaping spaceships are absorbed instead of crashing into
+//    the edges & leaving junk (they aren't tallied)
+//  - A soup has settled once its board hash repeats (PeriodDetector); soups still going after
+//    maxGenerations are counted as unsettled. Each worker keeps its own census, merged at the end
+class SoupSearch
+{
+public:
+    static constexpr int SOUP_SIZE = 16;
+    static constexpr int UNIVERSE_SIZE = 128;
+    static constexpr int BORDER = 8;            // Band width cleared...
+    static constexpr int BORDER_INTERVAL = 4;   // ...this often: nothing at up to c crosses it in between
+
+    struct Settings {
+        uint64_t seed = 0;
+        uint64_t soups = 0;
+        int threads = 0;                        // 0 = one per hardware thread
+        int maxPeriod = 60;
+        unsigned long long maxGenerations = 50000;
+        LifeRule rule;
+    };
+
+    explicit SoupSearch(const Settings& settings);
+
+    // Searches all the soups, printing progress. Blocks until done
+    void run();
+
+    const ObjectCensus& census() const { return _census; }
+    uint64_t unsettled() const { return _unsettled; }
+    double seconds() const { return _seconds; }
+
+    // Writes soup 'index' of 'seed' into the grid with its bottom-left corner at (x, y)
+    static void writeSoup(uint64_t seed, uint64_t index, PackedGrid& grid, int x, int y);
+
+private:
+    Settings settings;
+    ObjectCensus _census;
+    std::atomic<uint64_t> nextSoup{0}, soupsDone{0}, _unsettled{0};
+    double _seconds = 0.0;
+
+    void worker(ObjectCensus& census);
+};
+
+#endif
@@ -0,0 +1,81 @@
+#ifndef STAMP_H
+#define STAMP_H
+
+#include <string>
+#include <vector>
+#include <map>
+#include "packed_grid.h"
+#include "compute_shader_program.h"
+
+// How a stamped pattern combines with the cells under it
+enum StampMode {
+    STAMP_OR = 0,       // Pattern cells are set
+    STAMP_XOR = 1,      // Pattern cells are toggled
+    STAMP_REPLACE = 2,  // The pattern's rectangle is overwritten, dead cells included
+    STAMP_CLEAR = 3     // Pattern cells are killed
+};
+
+bool parseStampMode(const std::string& text, StampMode& mode);
+inline unsigned stampCell(unsigned current, unsigned patternCell, StampMode mode)
+{
+    switch (mode) {
+        case STAMP_OR:      return current | patternCell;
+        case STAMP_XOR:     return current ^ patternCell;
+        case STAMP_REPLACE: return patternCell;
+        default:            return current & ~patternCell;
+    }
+}
+
+// stampCell() for a Generations state: stamped cells become live (state 1) or dead, others keep their state
+inline unsigned stampState(unsigned current, unsigned patternCell, StampMode mode)
+{
+    if (!patternCell && mode != STAMP_REPLACE) return current;
+    return stampCell(current != 0, patternCell, mode);
+}
+
+// Stamps 'pattern' into 'grid' with its bottom-left corner at (x, y), a word at a time; the parts
+// outside the grid are dropped
+void stampGrid(PackedGrid& grid, const PackedGridView& pattern, int x, int y, StampMode mode);
+
+// Stamps into a one-uint-per-cell board SSBO without touching the rest of it: the pattern's packed rows
+// go into a small staging buffer (glBufferSubData) & a compute pass writes just the covered cells
+class GpuStamper
+{
+public:
+    GpuStamper();
+    ~GpuStamper();
+
+    void stamp(GLuint cellsBuf, int numCellsX, int numCellsY, const PackedGridView& pattern, int x, int y, StampMode mode);
+
+private:
+    ComputeShaderProgram shader;
+    GLuint patternBuf;
+    size_t patternBufBytes = 0;
+};
+
+// Scripted stamps, one "generation x y mode pattern.rle" line each ('#' starts a comment).
+// (x, y) is where the pattern's bottom-left corner goes. Each pattern file is loaded once
+class StampScript
+{
+public:
+    struct Entry {
+        unsigned long long generation;
+        int x, y;
+        StampMode mode;
+        size_t pattern;
+    };
+
+    bool load(const std::string& path);
+    // Next entry due at or before 'generation' (nullptr when there's none), in script order within a generation
+    const Entry* next(unsigned long long generation);
+    bool finished() const { return nextEntry >= entries.size(); }
+    const PackedGrid& pattern(size_t index) const { return patterns[index]; }
+
+private:
+    std::vector<Entry> entries;
+    size_t nextEntry = 0;
+    std::vector<PackedGrid> patterns;
+    std::map<std::string, size_t> patternIndex;
+};
+
+#endif
@@ -0,0 +1,64 @@
+#ifndef TILE_CACHE_H
+#define TILE_CACHE_H
+
+#include <glad/glad.h>
+#include <list>
+#include <vector>
+#include <unordered_map>
+#include "tile_store.h"
+#include "shader_program.h"
+
+// Fixed-size GPU cache of TileStore tiles for rendering boards too big for one buffer / texture.
+//  - Physical atlas: an R32UI texture holding 'capacity' tiles, each a 2x64 texel block (64 rows of 2 uint32)
+//  - Page table: an R32UI texture of PAGE_TABLE_DIM^2 entries addressed by tile coords modulo PAGE_TABLE_DIM,
+//    so any window of up to PAGE_TABLE_DIM x PAGE_TABLE_DIM tiles maps without aliasing.
+//    Entry = atlas slot + 1, EMPTY_TILE if the store has no such tile (all dead), or UNLOADED_TILE if
+//    the tile exists but isn't resident yet
+// Each frame the visible tiles are made resident (nearest the view centre first), evicting the least
+// recently used ones
+class TileCache
+{
+public:
+    static constexpr int PAGE_TABLE_DIM = 1024;     // Must be a power of 2
+    static constexpr GLuint EMPTY_TILE = 0;
+    static constexpr GLuint UNLOADED_TILE = 0xffffffffu;
+
+    TileCache(size_t atlasBudgetBytes, int maxUploadsPerFrame = 2048);
+    ~TileCache();
+
+    // Streams in the tiles overlapping the cell rect [minX, maxX] x [minY, maxY] & updates the page table
+    void update(const TileStore& store, int64_t minX, int64_t minY, int64_t maxX, int64_t maxY);
+    // Binds the atlas / page table to texture units 0 / 1 & sets the matching uniforms of the tile shader
+    void bind(ShaderProgram& shader) const;
+
+    // Widest tile window that can be shown at once (bounded by the page table & atlas)
+    int maxVisibleTiles() const;
+
+    size_t capacity() const { return _capacity; }
+    size_t residentCount() const { return entries.size(); }
+    size_t uploadsLastFrame() const { return _uploadsLastFrame; }
+
+private:
+    struct Entry {
+        GLuint slot;
+        uint32_t version;
+        std::list<uint64_t>::iterator lruPos;
+    };
+
+    size_t _capacity;
+    int slotsPerRow;
+    int maxUploadsPerFrame;
+    size_t _uploadsLastFrame = 0;
+
+    GLuint atlasTex, pageTableTex;
+    std::vector<GLuint> pageTable;      // CPU mirror of the page table texture
+    std::list<uint64_t> lru;            // Most recently used at the front
+    std::unordered_map<uint64_t, Entry> entries;
+    std::vector<GLuint> freeSlots;
+
+    GLuint acquireSlot();
+    void uploadTile(GLuint slot, const TileStore::Tile& tile);
+    void uploadPageTableRect(int x0, int y0, int x1, int y1);
+};
+
+#endif
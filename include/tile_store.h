@@ -0,0 +1,50 @@
+#ifndef TILE_STORE_H
+#define TILE_STORE_H
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+#include <unordered_map>
+
+// Sparse CPU-side board: only the 64x64 tiles that contain live cells are stored, so boards far
+// bigger than memory (e.g. 2^20 x 2^20) cost only what their live regions cost.
+// Bit x of rows[y] in tile (tx, ty) is cell (tx*64 + x, ty*64 + y). Coordinates may be negative.
+class TileStore
+{
+public:
+    static constexpr int TILE_SIZE = 64;
+    static constexpr int TILE_SHIFT = 6;
+
+    struct Tile {
+        uint64_t rows[TILE_SIZE];
+        uint32_t version;   // Bumped whenever the tile's contents change, so GPU copies can tell they're stale
+    };
+
+    bool get(int64_t x, int64_t y) const;
+    void set(int64_t x, int64_t y, bool alive);
+
+    const Tile* findTile(int32_t tx, int32_t ty) const;
+    // Replaces a whole tile (erasing it if 'rows' is all zero)
+    void setTile(int32_t tx, int32_t ty, const uint64_t* rows);
+    // ORs another store's cells into this one
+    void merge(const TileStore& other);
+    void clear();
+
+    // Mirrors a dense per-cell board (the GPU 'newCells' layout, cell (x, y) at y*width + x) into the store,
+    // only touching (and re-versioning) the tiles that actually changed
+    void loadCells(const std::vector<uint32_t>& cells, int width, int height) { loadCells(cells.data(), width, height); }
+    void loadCells(const uint32_t* cells, int width, int height);
+
+    size_t tileCount() const { return tiles.size(); }
+    const std::unordered_map<uint64_t, Tile>& allTiles() const { return tiles; }
+
+    static uint64_t key(int32_t tx, int32_t ty) { return (static_cast<uint64_t>(static_cast<uint32_t>(ty)) << 32) | static_cast<uint32_t>(tx); }
+    static int32_t keyX(uint64_t key) { return static_cast<int32_t>(key & 0xffffffffu); }
+    static int32_t keyY(uint64_t key) { return static_cast<int32_t>(key >> 32); }
+
+private:
+    std::unordered_map<uint64_t, Tile> tiles;
+    uint32_t nextVersion = 1;
+};
+
+#endif
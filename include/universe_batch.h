@@ -0,0 +1,60 @@
+#ifndef UNIVERSE_BATCH_H
+#define UNIVERSE_BATCH_H
+
+#include <cstdint>
+#include <vector>
+#include "packed_grid.h"
+#include "life_rule.h"
+
+// Many small same-sized universes stepped together, structure-of-arrays: the board is one word per cell,
+// bit k of a word belonging to universe k, so one pass of bit-sliced adders advances 64 universes at once
+// (a "slice"; more universes take more slices). Each universe can have its own rule: per slice & neighbour
+// count there's a mask of the universes born / surviving with that count. Cells beyond the edges are dead -
+// every slice is stored with a dead border, so the step has no edge cases.
+// Slices are independent, so step(n) hands each thread whole slices for all n generations: the per-universe
+// cost of a step is nothing but its share of the bit operations
+class UniverseBatch
+{
+public:
+    static constexpr int LANES = 64;        // Universes per slice
+    static constexpr int RULE_WORDS = 18;   // Per slice: birth masks for 0-8 neighbours, then survival masks
+
+    UniverseBatch(int width, int height, int universes, int threads = 0);   // 0 threads = one per hardware thread
+
+    void setRule(const LifeRule& rule);                 // All universes
+    void setRule(int universe, const LifeRule& rule);
+    void clear();
+    void set(int universe, int x, int y, bool alive);
+    bool get(int universe, int x, int y) const;
+    void load(int universe, const PackedGrid& board, int x = 0, int y = 0);   // Board's bottom-left corner at (x, y)
+    void extract(int universe, PackedGrid& board) const;
+
+    void step(int generations = 1);
+
+    std::vector<uint64_t> populations() const;         // Per universe
+
+    int width() const { return _width; }
+    int height() const { return _height; }
+    int universes() const { return _universes; }
+    int slices() const { return _slices; }
+
+    // Raw layout, for GpuUniverseBatch: slice major, then (height + 2) rows of (width + 2) words with the
+    // border in the outer rows & columns
+    size_t sliceWords() const { return static_cast<size_t>(_width + 2) * (_height + 2); }
+    const uint64_t* words() const { return current.data(); }
+    uint64_t* words() { return current.data(); }
+    const std::vector<uint64_t>& ruleMasks() const { return rules; }   // RULE_WORDS per slice
+
+private:
+    typedef std::vector<uint64_t, CacheLineAllocator<uint64_t>> Words;
+
+    int _width, _height, _universes, _slices;
+    int threads;
+    Words current, next;
+    std::vector<uint64_t> rules;
+
+    size_t index(int slice, int x, int y) const { return slice * sliceWords() + static_cast<size_t>(y + 1) * (_width + 2) + x + 1; }
+    void stepSlices(int slice0, int slice1, int generations);
+};
+
+#endif
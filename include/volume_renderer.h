@@ -0,0 +1,33 @@
+#ifndef VOLUME_RENDERER_H
+#define VOLUME_RENDERER_H
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include "vf_shader_program.h"
+#include "voxel_engine.h"
+
+// Draws a VoxelEngine volume by raymarching its packed bits in a fragment shader (volume.frag) over a
+// fullscreen triangle. The words go to the GPU as they are, only the slices changed since the last upload,
+// along with the brick occupancy, so rays jump over empty bricks whole & step voxel by voxel (a 3D DDA)
+// only through occupied ones
+class VolumeRenderer
+{
+public:
+    static constexpr GLuint VOLUME_BINDING = 14;
+    static constexpr GLuint BRICKS_BINDING = 15;
+
+    explicit VolumeRenderer(const VoxelEngine& engine);
+    ~VolumeRenderer();
+
+    void upload(VoxelEngine& engine);
+    // Camera orbiting the volume's centre: angles in radians, distance in volume diagonals
+    void render(float yaw, float pitch, float distance, int viewportWidth, int viewportHeight);
+
+private:
+    VFShaderProgram shader;
+    GLuint VAO, volumeBuf, bricksBuf;
+    glm::vec3 size;
+    size_t wordsPerSlice;
+};
+
+#endif
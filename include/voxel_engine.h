@@ -0,0 +1,65 @@
+#ifndef VOXEL_ENGINE_H
+#define VOXEL_ENGINE_H
+
+#include <cstdint>
+#include <vector>
+#include "rule_3d.h"
+
+// 3D Life-like rules on the CPU, bit-packed like CpuLifeEngine: bit (x & 63) of word (x >> 6) of row (y, z),
+// rows z major. The volume is tiled into bricks of one word x BRICK_ROWS rows x BRICK_SLICES slices, & only
+// bricks next to (or in) one that changed last step are stepped: the others hold the same cells in both
+// buffers already. A brick's counts are summed separably with full adders, along x for its rows & the
+// ring around them, then y, then z, which leaves each cell's total over its 3x3x3 block in 5 bit-planes.
+// Active bricks are shared out between threads
+class VoxelEngine
+{
+public:
+    static constexpr int BRICK_ROWS = 8;
+    static constexpr int BRICK_SLICES = 8;
+
+    explicit VoxelEngine(int threads = 0);      // 0 = one per hardware thread
+
+    void setRule(const Rule3D& rule);
+    void resize(int width, int height, int depth);      // Clears the volume
+
+    bool get(int x, int y, int z) const;
+    void set(int x, int y, int z, bool alive);
+
+    void step();
+
+    int width() const { return _width; }
+    int height() const { return _height; }
+    int depth() const { return _depth; }
+    size_t wordsPerRow() const { return _wordsPerRow; }
+    const uint64_t* words() const { return current.data(); }
+    uint64_t population() const;
+
+    // Brick grid, & which bricks hold live cells (brick (bx, by, bz) at (bz * bricksY + by) * bricksX + bx)
+    int bricksX() const { return _bricksX; }
+    int bricksY() const { return _bricksY; }
+    int bricksZ() const { return _bricksZ; }
+    const std::vector<uint8_t>& occupiedBricks() const { return occupied; }
+    size_t activeBricks() const { return active.size(); }      // Stepped last step
+
+    // Slices [z0, z1) changed since the last call (false if none), for uploading just those
+    bool takeChangedSlices(int& z0, int& z1);
+
+private:
+    Rule3D rule;
+    int _width = 0, _height = 0, _depth = 0;
+    size_t _wordsPerRow = 0;
+    std::vector<uint64_t> current, next;
+    int _bricksX = 0, _bricksY = 0, _bricksZ = 0;
+    std::vector<uint8_t> changed, occupied;     // Per brick: changed last step / holds live cells
+    std::vector<uint32_t> brickPopulation;
+    std::vector<uint32_t> active;               // Bricks to step
+    int changedZ0 = 0, changedZ1 = 0;
+    int threads;
+
+    size_t brickIndex(int bx, int by, int bz) const { return (static_cast<size_t>(bz) * _bricksY + by) * _bricksX + bx; }
+    void markChanged(size_t brick, int z0, int z1);
+    void stepBricks(size_t first, size_t last, std::vector<uint8_t>& nowChanged);
+    void stepBrick(size_t brick, std::vector<uint8_t>& nowChanged);
+};
+
+#endif
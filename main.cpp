@@ -2,6 +2,13 @@
 #include <cmath>
 #include <vector>
 #include <ctime>
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <random>
+#include <sstream>
+#include <deque>
+#include <functional>
 
 #include <glad/glad.h> 
 #include <GLFW/glfw3.h>
@@ -10,30 +17,97 @@
 #include <glm/gtc/type_ptr.hpp>
 #include "vf_shader_program.h"
 #include "compute_shader_program.h"
+#include "offscreen_capture.h"
+#include "app_options.h"
+#include "tile_store.h"
+#include "tile_cache.h"
+#include "packed_grid.h"
+#include "life_rule.h"
+#include "rle_file.h"
+#include "quadtree.h"
+#include "macrocell_file.h"
+#include "snapshot_file.h"
+#include "generation_recorder.h"
+#include "checkpointer.h"
+#include "cell_list_file.h"
+#include "cpu_life_engine.h"
+#include "gpu_stats.h"
+#include "generation_stats.h"
+#include "stamp.h"
+#include "period_detector.h"
+#include "gpu_reduction.h"
+#include "readback_ring.h"
+#include "object_census.h"
+#include "soup_search.h"
+#include "universe_batch.h"
+#include "gpu_universe_batch.h"
+#include "emission_detector.h"
+#include "generations_engine.h"
+#include "gpu_generations_engine.h"
+#include "ltl_rule.h"
+#include "ltl_engine.h"
+#include "gpu_ltl_engine.h"
+#include "rule_3d.h"
+#include "voxel_engine.h"
+#include "volume_renderer.h"
+#include "rule_table.h"
+#include "rule_table_engine.h"
+#include "gpu_rule_table_engine.h"
+#include "continuous_rule.h"
+#include "continuous_engine.h"
+#include "gpu_continuous_engine.h"
+#include "margolus_rule.h"
+#include "margolus_engine.h"
+#include "gpu_margolus_engine.h"
 
 using namespace glm;
 
 
 // SETTINGS
 // --------
-const uint NUMCELLS_X = 75, NUMCELLS_Y = 75;
+uint NUMCELLS_X = 75, NUMCELLS_Y = 75;     // Set from --board-size / the loaded pattern in configureBoard()
+const uint MAX_GPU_BOARD_DIM = 8192;    // Larger patterns are shown view-only through the tile cache
 int SCR_WIDTH = 1000, SCR_HEIGHT = 1000;
 int CELL_WIDTH = SCR_WIDTH / NUMCELLS_X, CELL_HEIGHT = SCR_HEIGHT / NUMCELLS_Y;
 
 
 // FUNCTIONS
 // ---------
+bool configureBoard();
+bool checkRuleSupport();
+int runSoupSearch();
+int runSweep();
+int runVolume();
+void saveBoard();
+void takeCensus();
+void detectEmissions();
+std::vector<EmissionDetector::Sighting> scanEmissionBand(const void* data, unsigned long long scanGeneration);
 void initCellsComputeShader();
 void initGridShader();
 void initLiveCellsShader();
-void bindNewLiveCellVertices();
+void compactLiveCells();
 void renderGrid();
 void renderLiveCells();
 void executeCompShader();
+void stepBoard();
+void handleStats(const GenerationStats& stats);
+void stamp(const PackedGridView& pattern, int x, int y, StampMode mode);
+void applyScriptedStamps();
+void stampRandomSoup();
 void writeToSSBOs();
+void uploadCells();
+void syncCellsFromGPU();
+void requestBoardReadback();
+void collectBoardReadbacks(bool wait);
+void uploadSnapshot();
+void initTileView();
+void renderTiles();
+void refreshTileStore();
+void streamPatternTiles();
+void advanceReplay();
 
 // Utilities
-GLFWwindow* configGLFW();
+GLFWwindow* configGLFW(bool offscreen);
 void outputGLLimits();
 
 // Callbacks
@@ -41,6 +115,7 @@ void framebufferSizeCallback(GLFWwindow* window, int width, int height);
 void processInput(GLFWwindow* window);
 void mouseMoveCallback(GLFWwindow* window, double mouseX, double mouseY);
 void mouseScrollCallback(GLFWwindow* window, double xoffset, double yoffset);
+void keyCallback(GLFWwindow* window, int key, int scancode, int action, int mods);
 
 
 // GLOBALS
@@ -54,21 +129,135 @@ public:
 class LiveCells {
 public:
     VFShaderProgram* Shader;
-    GLuint VBO, VAO, EBO;
+    ComputeShaderProgram* CompactShader;    // Lists the live cells on the GPU for an instanced, indirect draw
+    GLuint VAO, ListBuf, DrawCommandBuf;
+    GLuint PaletteBuf = 0;                  // Rule tables & continuous states: a colour per state / level
 } liveCells;
 
 ComputeShaderProgram* computeShader;
 std::vector<uint32> prevCells(NUMCELLS_X * NUMCELLS_Y);  // Prev cell states
 std::vector<uint32> newCells(NUMCELLS_X * NUMCELLS_Y);   // Current cell states
-int newLiveCellsCount = 0;
+bool cpuCellsStale = false;     // newCells is behind the GPU board: it's only read back when the CPU needs it
+unsigned long long generation = 0;
+LifeRule rule;
+LtlRule ltlRule;                // In place of rule when largerThanLife is set
+bool largerThanLife = false;
+
+AppOptions options;
+OffscreenCapture* capture = nullptr;   // Only set when rendering offscreen
+GenerationRecorder* recorder = nullptr; // Only set with --record
+Checkpointer* checkpointer = nullptr;   // Only set with --checkpoint-dir
+// The recorder's & checkpoints' boards come off the GPU through this, a few frames late instead of stalling it
+ReadbackRing* boardReadback = nullptr;
+struct BoardReadback { bool record, checkpoint; };
+std::deque<BoardReadback> boardReadbacks;   // Who each request in boardReadback is for, oldest first
+bool checkpointReadPending = false;         // A checkpoint's board is on its way back
+CpuLifeEngine* cpuEngine = nullptr;     // Only set with --engine cpu (steps on the CPU instead of the compute shader)
+// Generations rules step on one of these instead (the cell values on the CPU & in prevCellsBuf are then states;
+// gpuGenerations keeps its board packed in its own buffers, which are drawn from directly)
+GenerationsEngine* generationsEngine = nullptr;
+GpuGenerationsEngine* gpuGenerations = nullptr;
+// Larger than Life rules step on one of these (the cells stay 0 / 1)
+LtlEngine* ltlEngine = nullptr;
+GpuLtlEngine* gpuLtl = nullptr;
+// Rule tables (--rule-table) step on one of these instead of rule (the cell values are states)
+RuleTable ruleTable;
+bool tableRule = false;
+RuleTableEngine* tableEngine = nullptr;
+GpuRuleTableEngine* gpuTable = nullptr;
+// Continuous-state rules (Lenia, SmoothLife) step on one of these (the cell values are levels 0 - 255)
+ContinuousRule continuousRule;
+bool continuous = false;
+ContinuousEngine* continuousEngine = nullptr;
+GpuContinuousEngine* gpuContinuous = nullptr;
+// Margolus rules step on one of these (the cells stay 0 / 1)
+MargolusRule margolusRule;
+bool margolus = false;
+MargolusEngine* margolusEngine = nullptr;
+GpuMargolusEngine* gpuMargolus = nullptr;
+bool runningBackward = false;           // Reversible rules: undoing generations (--reverse-at, the B key)
+// The CPU engine in use (if any), as stepBoard() drives it: one step, filling in the stats if asked for (& the
+// engine keeps them), then its board written out as cell values for the renderer's upload
+struct CpuStepper {
+    std::function<void(GenerationStats* stats)> step;
+    std::function<void(std::vector<uint32>& cells)> toCells;
+    bool keepsStats = true;
+};
+CpuStepper cpuStepper;
+StatsWriter* statsWriter = nullptr;     // Only set with --stats
+GpuStats* gpuStats = nullptr;           // Stats readback for the compute shader engine
+PeriodDetector* periodDetector = nullptr;   // Only set with --detect-period
+EmissionDetector* emissionDetector = nullptr;   // Only set with --emissions
+PackedGrid emissionBand;                    // GPU engine: the band cells read back for it (the rest stays empty)
+ReadbackRing* emissionReadback = nullptr;   // GPU engine: the band's strips, one scan in flight at a time
+unsigned long long emissionScanGeneration = 0;  // Of the last scan requested
+bool stopRequested = false;             // Ends the run after the current frame
+GpuStamper* gpuStamper = nullptr;       // Created on the first stamp
+GpuReduction* boardReduction = nullptr; // Population & bounding box for the window title (interactive runs only)
+StampScript stampScript;                // --stamp-script
+
+// Macrocell pattern (--mc). Patterns too big for the GPU board are only viewed, straight from the quadtree
+QuadTree macrocell;
+// Cell list pattern (--cells / --life106). Ones too big for the GPU board are only viewed, from the tile store
+std::string cellListPath;
+CellListFile::Format cellListFormat = CellListFile::PLAINTEXT;
+CellListFile::Info cellListInfo;
+QuadTree::Box patternBox;       // Of the loaded pattern, in its own coordinates
+bool patternViewOnly = false;
+
+// Replay of a recording (--replay): the board comes from the file instead of the compute shader
+class Replay {
+public:
+    DeltaFile::Reader reader;
+    PackedGrid board;
+    bool playing = true;
+    bool seekPending = false;
+    unsigned long long seekTarget = 0;
+} replay;
+
+// Binary snapshot (--snapshot), mapped from configureBoard() until its rows are uploaded
+SnapshotFile snapshot;
+
+// Tile-streamed view (--tile-view)
+TileStore tileStore;
+TileCache* tileCache = nullptr;
+ReadbackRing* tileReadback = nullptr;   // Tile view of the GPU board: it comes back a frame or two late, without stalling
+class TileView {
+public:
+    VFShaderProgram* Shader;
+    GLuint VAO;
+    double originX = 0.0, originY = 0.0;    // Board position at the bottom-left of the viewport
+    double cellsPerPixel = 1.0;
+    double minCellsPerPixel = 1.0 / 64.0, maxCellsPerPixel = 1.0;
+    double lastMouseX = 0.0, lastMouseY = 0.0;
+} tileView;
+
+// 3D volume view (--volume): a camera orbiting the volume's centre
+class VolumeView {
+public:
+    float yaw = 0.6f, pitch = 0.45f;    // Radians
+    float distance = 1.4f;              // In volume diagonals
+    double lastMouseX = 0.0, lastMouseY = 0.0;
+} volumeView;
 
-int main()
+int main(int argc, char** argv)
 {
+    if (!parseAppOptions(argc, argv, options)) return -1;
+    if (options.soupCount > 0) return runSoupSearch();
+    if (options.sweepSeeds > 0) return runSweep();
+    if (options.volumeWidth > 0) return runVolume();
+    if (!configureBoard()) return -1;
+    if (!checkRuleSupport()) return -1;
+    if (options.reverseAt > 0 && !(margolus && margolusRule.reversible())) {
+        std::cout << "--reverse-at needs a reversible rule: a Margolus rule whose table is a permutation" << std::endl;
+        return -1;
+    }
+
     srand(static_cast<unsigned int>(time(NULL))); // Seed randomness
 
     // GLFW: INIT & CONFIG
     // -------------------
-    GLFWwindow* window = configGLFW();
+    GLFWwindow* window = configGLFW(options.offscreen);
     if (window == NULL) return -1;
 
     // INIT GLAD, WHICH MANAGES FUNCTION POINTERS FOR OPENGL
@@ -82,18 +271,157 @@ int main()
     glEnable(GL_DEPTH_TEST);
 
     initCellsComputeShader();
+    if (tableRule) {
+        if (options.engine == "cpu") {
+            syncCellsFromGPU();
+            tableEngine = new RuleTableEngine();
+            tableEngine->setRule(ruleTable);
+            tableEngine->loadCells(newCells, NUMCELLS_X, NUMCELLS_Y);
+        }
+        else gpuTable = new GpuRuleTableEngine(NUMCELLS_X, NUMCELLS_Y, ruleTable);     // Steps the board buffers themselves
+        std::cout << "Rule table " << ruleTable.name << ": " << ruleTable.states << " states, " << ruleTable.transitions() << " transitions, "
+                  << (ruleTable.dense() ? "dense" : "perfect hashed") << " lookup" << std::endl;
+    }
+    else if (continuous) {
+        if (options.engine == "cpu") {
+            syncCellsFromGPU();
+            continuousEngine = new ContinuousEngine();
+            continuousEngine->setRule(continuousRule);
+            continuousEngine->loadCells(newCells, NUMCELLS_X, NUMCELLS_Y);
+        }
+        else {
+            gpuContinuous = new GpuContinuousEngine(NUMCELLS_X, NUMCELLS_Y, continuousRule);
+            gpuContinuous->load(newCells);
+        }
+        std::cout << "Continuous rule " << continuousRule.toString() << ": kernel radius " << continuousRule.kernelRadius() << std::endl;
+    }
+    else if (margolus) {
+        if (options.engine == "cpu") {
+            syncCellsFromGPU();
+            margolusEngine = new MargolusEngine();
+            margolusEngine->setRule(margolusRule);
+            margolusEngine->loadCells(newCells, NUMCELLS_X, NUMCELLS_Y);
+        }
+        else gpuMargolus = new GpuMargolusEngine(NUMCELLS_X, NUMCELLS_Y, margolusRule);     // Steps the board buffer itself
+    }
+    else if (largerThanLife) {
+        if (options.engine == "cpu") {
+            syncCellsFromGPU();
+            ltlEngine = new LtlEngine();
+            ltlEngine->setRule(ltlRule);
+            ltlEngine->loadCells(newCells, NUMCELLS_X, NUMCELLS_Y);
+        }
+        else gpuLtl = new GpuLtlEngine(NUMCELLS_X, NUMCELLS_Y, ltlRule);
+    }
+    else if (rule.isGenerations()) {
+        syncCellsFromGPU();
+        if (options.engine == "cpu") {
+            generationsEngine = new GenerationsEngine();
+            generationsEngine->setRule(rule);
+            generationsEngine->loadCells(newCells, NUMCELLS_X, NUMCELLS_Y);
+        }
+        else {
+            gpuGenerations = new GpuGenerationsEngine(NUMCELLS_X, NUMCELLS_Y, rule);
+            gpuGenerations->load(newCells);
+            // The 4 byte per cell board buffers would be 8x the packed states & go unused: give their memory back
+            for (GLuint buffer : { prevCellsBuf, newCellsBuf }) {
+                glBindBuffer(GL_SHADER_STORAGE_BUFFER, buffer);
+                glBufferData(GL_SHADER_STORAGE_BUFFER, 0, NULL, GL_DYNAMIC_DRAW);
+            }
+        }
+    }
+    else if (options.engine == "cpu") {
+        syncCellsFromGPU();
+        cpuEngine = new CpuLifeEngine();
+        cpuEngine->setRule(rule);
+        cpuEngine->loadCells(newCells, NUMCELLS_X, NUMCELLS_Y);
+    }
+    if (cpuEngine)
+        cpuStepper = { [](GenerationStats* stats) { cpuEngine->step(stats); }, [](std::vector<uint32>& cells) { cpuEngine->board().toCells(cells); } };
+    else if (ltlEngine)
+        cpuStepper = { [](GenerationStats* stats) { ltlEngine->step(stats); }, [](std::vector<uint32>& cells) { ltlEngine->toCells(cells); } };
+    else if (generationsEngine)
+        cpuStepper = { [](GenerationStats* stats) { generationsEngine->step(stats); }, [](std::vector<uint32>& cells) { generationsEngine->toCells(cells); } };
+    else if (tableEngine)
+        cpuStepper = { [](GenerationStats* stats) { tableEngine->step(stats); }, [](std::vector<uint32>& cells) { tableEngine->toCells(cells); } };
+    else if (margolusEngine)
+        cpuStepper = { [](GenerationStats* stats) { margolusEngine->step(runningBackward, stats); }, [](std::vector<uint32>& cells) { margolusEngine->toCells(cells); } };
+    else if (continuousEngine)
+        cpuStepper = { [](GenerationStats*) { continuousEngine->step(); }, [](std::vector<uint32>& cells) { continuousEngine->toCells(cells); }, false };
+    if (!options.statsPath.empty()) {
+        statsWriter = new StatsWriter();
+        if (!statsWriter->open(options.statsPath)) return -1;
+    }
+    if (options.maxPeriod > 0) periodDetector = new PeriodDetector(options.maxPeriod);
+    if (!options.emissionsPath.empty()) {
+        // Watches the whole board but for the band at its edges, so leaving ships are caught there
+        const int band = EmissionDetector::BAND, width = NUMCELLS_X, height = NUMCELLS_Y;
+        emissionDetector = new EmissionDetector(width, height, { band, band, width - 1 - band, height - 1 - band }, rule);
+        if (!cpuEngine) {
+            emissionBand.resize(NUMCELLS_X, NUMCELLS_Y);
+            size_t bandCells = 0;
+            for (const EmissionDetector::Rect& strip : emissionDetector->band())
+                bandCells += static_cast<size_t>(strip.x1 - strip.x0 + 1) * (strip.y1 - strip.y0 + 1);
+            emissionReadback = new ReadbackRing(1, bandCells * sizeof(uint32), GL_STREAM_READ);
+        }
+    }
+    // The board hash comes with the stats, reduced on the GPU
+    if ((statsWriter || periodDetector) && (gpuGenerations || gpuLtl || gpuTable || gpuMargolus)) {
+        std::cout << "Stats & period detection with Generations, Larger than Life, rule table & Margolus rules need --engine cpu" << std::endl;
+        return -1;
+    }
+    if ((statsWriter || periodDetector) && !cpuStepper.step) {
+        gpuStats = new GpuStats();
+        computeShader->use();
+        computeShader->setBool_w_Name("collectStats", true);
+    }
+    if (!options.stampScriptPath.empty()) {
+        if (!stampScript.load(options.stampScriptPath)) return -1;
+        applyScriptedStamps();
+    }
     initGridShader();
     initLiveCellsShader();
+    if (options.tileView) initTileView();
+    if (!options.offscreen && !patternViewOnly) boardReduction = new GpuReduction();
+
+    if (options.offscreen) {
+        capture = new OffscreenCapture(SCR_WIDTH, SCR_HEIGHT);
+        if (!options.pngPattern.empty()) capture->openPngSequence(options.pngPattern);
+        if (!options.rawPipeCommand.empty() && !capture->openRawPipe(options.rawPipeCommand)) return -1;
+        capture->bindFramebuffer();
+    }
+
+    if (!options.recordPath.empty()) {
+        recorder = new GenerationRecorder();
+        if (!recorder->open(options.recordPath, NUMCELLS_X, NUMCELLS_Y, rule, options.keyframeInterval)) return -1;
+        syncCellsFromGPU();
+        recorder->record(newCells, generation);     // The starting board is the first keyframe
+    }
+
+    if (!options.checkpointDir.empty()) {
+        checkpointer = new Checkpointer(options.checkpointDir, options.checkpointEvery, options.checkpointSeconds, options.checkpointKeep);
+        if (!checkpointer->start(NUMCELLS_X, NUMCELLS_Y, rule, generation)) return -1;
+    }
+    if (recorder || checkpointer)
+        boardReadback = new ReadbackRing(3, static_cast<size_t>(NUMCELLS_X) * NUMCELLS_Y * sizeof(uint32), GL_STREAM_READ);
     
     float prevUpdateFrame = 0;
 
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
     glClearColor(0.85f, 0.85f, 0.85f, 1.0f);
-    renderGrid();
-    renderLiveCells();
+    if (options.tileView) {
+        if (!patternViewOnly) refreshTileStore();
+        renderTiles();
+    }
+    else {
+        renderGrid();
+        compactLiveCells();
+        renderLiveCells();
+    }
 
     // RENDER LOOP
     // -----------
+    unsigned long long framesRendered = 0;
     while(!glfwWindowShouldClose(window))
     {
         float currentFrame = glfwGetTime();
@@ -105,27 +433,120 @@ int main()
         // RENDER
         // ------        
 
-        if (currentFrame - prevUpdateFrame > 0.05f) {
+        // Offscreen runs aren't watched, so step as fast as possible
+        if (options.offscreen || currentFrame - prevUpdateFrame > 0.05f) {
             glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
             glClearColor(0.85f, 0.85f, 0.85f, 1.0f);
 
-            executeCompShader();
+            if (!options.replayPath.empty()) {
+                advanceReplay();
+            }
+            else if (!patternViewOnly) {
+                stepBoard();
+                generation++;
+                applyScriptedStamps();
+                if (emissionDetector) detectEmissions();
+                if (boardReadback) {
+                    requestBoardReadback();
+                    collectBoardReadbacks(false);
+                }
+            }
+
+            if (patternViewOnly) {
+                streamPatternTiles();
+                renderTiles();
+            }
+            else if (options.tileView) {
+                refreshTileStore();
+                renderTiles();
+            }
+            else {
+                renderGrid();
+                compactLiveCells();
+                renderLiveCells();
+            }
+            framesRendered++;
+
+            if (boardReduction) {
+                // Results come back a frame or two later, without stalling
+                if (gpuGenerations) boardReduction->submit(gpuGenerations->statesBuffer(), NUMCELLS_X, NUMCELLS_Y, generation, gpuGenerations->packedWordsPerRow());
+                else boardReduction->submit(prevCellsBuf, NUMCELLS_X, NUMCELLS_Y, generation);
+                GpuReduction::Result result;
+                while (boardReduction->poll(result)) {
+                    std::string title = "Game of Life - generation " + std::to_string(result.tag) + " - population " + std::to_string(result.count);
+                    if (!result.empty())
+                        title += " - bounding box " + std::to_string(result.maxX - result.minX + 1) + "x" + std::to_string(result.maxY - result.minY + 1);
+                    glfwSetWindowTitle(window, title.c_str());
+                }
+            }
 
-            renderGrid();
-            bindNewLiveCellVertices();
-            renderLiveCells();
+            if (capture) capture->captureFrame();   // Async readback, overlaps with the next steps
 
             // GLFW: POLL & CALL IOEVENTS + SWAP BUFFERS
             // -----------------------------------------
-            glfwSwapBuffers(window);    // For reader - search 'double buffer'
+            if (!capture) glfwSwapBuffers(window);    // For reader - search 'double buffer'
             glfwPollEvents();
             
             prevUpdateFrame = currentFrame;
+
+            if (stopRequested || (options.maxGenerations != 0 && (patternViewOnly ? framesRendered : generation) >= options.maxGenerations))
+                glfwSetWindowShouldClose(window, true);
         }
 
 
     }
 
+    saveBoard();
+    takeCensus();
+    delete boardReduction;
+    delete tileReadback;
+
+    if (gpuStats) {
+        GenerationStats stats;
+        gpuStats->flush();
+        while (gpuStats->poll(stats)) if (statsWriter) statsWriter->push(stats);
+        delete gpuStats;
+    }
+    if (statsWriter) {
+        statsWriter->finish();
+        std::cout << "Wrote stats for " << statsWriter->written() << " generations (" << statsWriter->dropped() << " dropped)" << std::endl;
+        delete statsWriter;
+    }
+    delete periodDetector;
+    if (emissionReadback) {
+        // The last scan's spaceships are logged; they needn't be erased any more
+        emissionReadback->flush([](const void* data, unsigned long long scanGeneration) { scanEmissionBand(data, scanGeneration); });
+        delete emissionReadback;
+    }
+    if (emissionDetector) {
+        emissionDetector->printSummary();
+        emissionDetector->write(options.emissionsPath);
+        delete emissionDetector;
+    }
+
+    if (boardReadback) {
+        collectBoardReadbacks(true);
+        delete boardReadback;
+    }
+    if (checkpointer) {
+        checkpointer->finish();
+        std::cout << "Wrote " << checkpointer->written() << " checkpoints" << std::endl;
+        delete checkpointer;
+    }
+
+    if (recorder) {
+        recorder->finish();
+        std::cout << "Recorded " << recorder->recorded() << " generations (" << recorder->dropped() << " dropped), "
+                  << recorder->bytesWritten() << " bytes" << std::endl;
+        delete recorder;
+    }
+
+    if (capture) {
+        capture->finish();
+        std::cout << "Captured " << capture->framesWritten() << " frames" << std::endl;
+        delete capture;
+    }
+
     // GLFW: TERMINATE GLFW, CLEARING ALL PREVIOUSLY ALLOCATED GLFW RESOURCES
     glfwTerminate();
     return 0;
@@ -133,6 +554,7 @@ int main()
 
 void renderGrid()
 {
+    if (rule.neighbourhood == LifeRule::HEXAGONAL) return;     // The hexagons' gaps stand in for grid lines
     grid.Shader->use();
     int numGridLines = (NUMCELLS_X+1)*2 + (NUMCELLS_Y+1)*2;
     glBindVertexArray(grid.VAO);
@@ -140,26 +562,156 @@ void renderGrid()
     glBindVertexArray(0);
 }
 
+// Draws a quad per live cell, as listed by compactLiveCells(): the instance count is in the indirect command
 void renderLiveCells()
 {
     liveCells.Shader->use();
+    if (liveCells.PaletteBuf) glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 16, liveCells.PaletteBuf);     // Cell states from binding 0, as compacted
     glBindVertexArray(liveCells.VAO);
-    glDrawElements(GL_TRIANGLES, newLiveCellsCount * 6, GL_UNSIGNED_INT, 0);
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, liveCells.DrawCommandBuf);
+    glDrawArraysIndirect(GL_TRIANGLES, 0);
+    glBindVertexArray(0);
+}
+
+// Streams the visible part of the sparse tile store through the GPU tile cache & draws it with a fullscreen pass
+void renderTiles()
+{
+    int64_t minX = static_cast<int64_t>(std::floor(tileView.originX));
+    int64_t minY = static_cast<int64_t>(std::floor(tileView.originY));
+    int64_t maxX = static_cast<int64_t>(std::floor(tileView.originX + SCR_WIDTH * tileView.cellsPerPixel));
+    int64_t maxY = static_cast<int64_t>(std::floor(tileView.originY + SCR_HEIGHT * tileView.cellsPerPixel));
+    tileCache->update(tileStore, minX, minY, maxX, maxY);
+
+    tileView.Shader->use();
+    tileCache->bind(*tileView.Shader);
+    tileView.Shader->set2Floats_w_Name("viewOrigin", static_cast<float>(tileView.originX), static_cast<float>(tileView.originY));
+    tileView.Shader->setFloat_w_Name("cellsPerPixel", static_cast<float>(tileView.cellsPerPixel));
+
+    glDisable(GL_DEPTH_TEST);
+    glBindVertexArray(tileView.VAO);
+    glDrawArrays(GL_TRIANGLES, 0, 3);
+    glBindVertexArray(0);
+    glEnable(GL_DEPTH_TEST);
+}
+
+// Paints the visible window of a view-only macrocell pattern into the tile store.
+// Tiles that already hold the same contents keep their version, so panning only uploads new tiles
+void streamPatternTiles()
+{
+    if (options.loadMacrocell.empty()) return;     // Cell lists are loaded into the store whole
+
+    int64_t minX = static_cast<int64_t>(std::floor(tileView.originX));
+    int64_t minY = static_cast<int64_t>(std::floor(tileView.originY));
+    int64_t maxX = static_cast<int64_t>(std::floor(tileView.originX + SCR_WIDTH * tileView.cellsPerPixel));
+    int64_t maxY = static_cast<int64_t>(std::floor(tileView.originY + SCR_HEIGHT * tileView.cellsPerPixel));
+
+    if (tileStore.tileCount() > 2 * tileCache->capacity()) tileStore.clear();     // Keep the CPU side bounded too
+    macrocell.paintTiles(tileStore, minX, minY, maxX, maxY);
+}
+
+// Shows the next recorded generation (or the one scrubbed to) in place of a compute step
+void advanceReplay()
+{
+    bool changed = false;
+    if (replay.seekPending) {
+        replay.seekPending = false;
+        changed = replay.reader.seek(replay.seekTarget, replay.board, generation);
+    }
+    else if (replay.playing) {
+        changed = replay.reader.next(replay.board, generation);
+        if (!changed) {
+            replay.playing = false;     // End of the recording
+            if (options.offscreen) options.maxGenerations = generation;
+        }
+    }
+    if (changed) {
+        replay.board.toCells(newCells);
+        uploadCells();
+    }
 }
 
 // This shader computes the core logic of the cellular automata (not used for drawing)
 void initCellsComputeShader()
 {
-    computeShader = new ComputeShaderProgram(SHADER_PATH "computeShader.comp");
+    // Hexagonal & von Neumann rules get kernels of their own rather than a masked Moore count
+    const char* neighbourhood = rule.neighbourhood == LifeRule::HEXAGONAL ? "#define HEXAGONAL\n" :
+                                rule.neighbourhood == LifeRule::VON_NEUMANN ? "#define VON_NEUMANN\n" : "";
+    computeShader = new ComputeShaderProgram(SHADER_PATH "computeShader.comp", neighbourhood);
 
     computeShader->use();
     computeShader->setInt_w_Name("numCellsX", NUMCELLS_X);
     computeShader->setInt_w_Name("numCellsY", NUMCELLS_Y);
+    computeShader->setInt_w_Name("birthMask", rule.birthMask);
+    computeShader->setInt_w_Name("surviveMask", rule.surviveMask);
+    if (rule.isotropic) {
+        std::array<uint64_t, 8> table = rule.table();
+        GLuint tableWords[16];
+        for (int i = 0; i < 16; i++) tableWords[i] = static_cast<GLuint>(table[i / 2] >> (32 * (i % 2)));
+        computeShader->setBool_w_Name("isotropic", true);
+        glUniform1uiv(glGetUniformLocation(computeShader->ID, "ruleTable"), 16, tableWords);
+    }
 
     // Create & bind 'cell state' buffers
     // ----------------------------------
+    prevCells.resize(static_cast<size_t>(NUMCELLS_X) * NUMCELLS_Y);
+    newCells.resize(static_cast<size_t>(NUMCELLS_X) * NUMCELLS_Y);
+
     // Init cell data
-    for (int j = 0; j < NUMCELLS_Y; j++) {
+    if (snapshot.isOpen()) {
+        // Unpacked on the GPU straight from the mapping in uploadSnapshot()
+    }
+    else if (!options.replayPath.empty()) {
+        replay.board.toCells(prevCells);
+        newCells = prevCells;
+    }
+    else if (!options.loadRLE.empty() && (tableRule || continuous)) {
+        // States as they are, centred; ones past the table's are taken as state 1. Continuous-state
+        // patterns' are levels, up to 255
+        RLEFile::Header header;
+        RLEFile::readHeader(options.loadRLE, header);
+        std::fill(prevCells.begin(), prevCells.end(), 0);
+        RLEFile::loadStates(options.loadRLE, prevCells, NUMCELLS_X, NUMCELLS_Y,
+                            static_cast<int>((NUMCELLS_X - header.width) / 2), static_cast<int>((NUMCELLS_Y - header.height) / 2));
+        for (uint32& cell : prevCells) {
+            if (tableRule && cell >= static_cast<uint32>(ruleTable.states)) cell = 1;
+            else if (continuous) cell = std::min<uint32>(cell, 255);
+        }
+        newCells = prevCells;
+    }
+    else if (!options.loadRLE.empty()) {
+        // Pattern centred on the board, written straight into a packed grid
+        PackedGrid board(NUMCELLS_X, NUMCELLS_Y);
+        RLEFile::Header header;
+        RLEFile::readHeader(options.loadRLE, header);
+        RLEFile::load(options.loadRLE, board, static_cast<int>((NUMCELLS_X - header.width) / 2), static_cast<int>((NUMCELLS_Y - header.height) / 2));
+        board.toCells(prevCells);
+        newCells = prevCells;
+    }
+    else if (!options.loadMacrocell.empty() && !patternViewOnly) {
+        // Pattern's bounding box centred on the board
+        PackedGrid board(NUMCELLS_X, NUMCELLS_Y);
+        int64_t boxW = patternBox.maxX - patternBox.minX + 1, boxH = patternBox.maxY - patternBox.minY + 1;
+        macrocell.paintGrid(board, (NUMCELLS_X - boxW) / 2 - patternBox.minX, (NUMCELLS_Y - boxH) / 2 - patternBox.minY);
+        board.toCells(prevCells);
+        newCells = prevCells;
+    }
+    else if (!cellListPath.empty() && !patternViewOnly) {
+        PackedGrid board(NUMCELLS_X, NUMCELLS_Y);
+        CellListFile::load(cellListPath, cellListFormat, cellListInfo, board,
+                           static_cast<int>((NUMCELLS_X - cellListInfo.width()) / 2), static_cast<int>((NUMCELLS_Y - cellListInfo.height()) / 2));
+        board.toCells(prevCells);
+        newCells = prevCells;
+    }
+    else if (continuous) {
+        // A filled square would only spread or die out evenly: random levels over the middle of the board instead
+        for (uint j = 0; j < NUMCELLS_Y; j++)
+            for (uint i = 0; i < NUMCELLS_X; i++) {
+                bool middle = i >= NUMCELLS_X / 4 && i <= 3 * NUMCELLS_X / 4 && j >= NUMCELLS_Y / 4 && j <= 3 * NUMCELLS_Y / 4;
+                prevCells[j * NUMCELLS_X + i] = middle ? rand() % 256 : 0;
+            }
+        newCells = prevCells;
+    }
+    else for (int j = 0; j < NUMCELLS_Y; j++) {
         for (int i = 0; i < NUMCELLS_X; i++) {
             int linInd = j * NUMCELLS_X + i;    // Convert 2D index to 1D
             // if (rand()%4 == 1) {
@@ -181,12 +733,507 @@ void initCellsComputeShader()
     glGenBuffers(1, &prevCellsBuf);
     glGenBuffers(1, &newCellsBuf);
 
-    writeToSSBOs();
+    if (snapshot.isOpen()) uploadSnapshot();
+    else writeToSSBOs();
     
     glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, prevCellsBuf);
     glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, newCellsBuf);
 }
 
+// Sizes the board & picks the rule from the options and the pattern file (if any)
+bool configureBoard()
+{
+    NUMCELLS_X = options.boardWidth;
+    NUMCELLS_Y = options.boardHeight;
+
+    if (!options.checkpointDir.empty()) {
+        // A restarted run picks up from its newest good checkpoint instead of its starting pattern
+        std::string latest = Checkpointer::findLatest(options.checkpointDir);
+        if (!latest.empty()) {
+            // The recorder starts its file afresh, which would wipe the recording this run continues
+            if (!options.recordPath.empty()) {
+                std::cout << "Can't --record while resuming from a checkpoint (" << latest << "): it would truncate "
+                          << options.recordPath << std::endl;
+                return false;
+            }
+            std::cout << "Resuming from " << latest << std::endl;
+            options.loadSnapshot = latest;
+            options.loadRLE.clear();
+            options.loadMacrocell.clear();
+            options.loadPlaintext.clear();
+            options.loadLife106.clear();
+        }
+    }
+
+    std::string ruleText = options.rule;
+    if (!options.replayPath.empty()) {
+        if (!replay.reader.open(options.replayPath)) return false;
+        const DeltaFile::Header& header = replay.reader.header();
+        if (header.width > MAX_GPU_BOARD_DIM || header.height > MAX_GPU_BOARD_DIM) {
+            std::cout << "Recording's board " << header.width << "x" << header.height << " is too big for the GPU board: "
+                      << options.replayPath << std::endl;
+            return false;
+        }
+        NUMCELLS_X = header.width;
+        NUMCELLS_Y = header.height;
+        rule.birthMask = header.birthMask;
+        rule.surviveMask = header.surviveMask;
+        if (!replay.reader.seek(options.replayFrom, replay.board, generation)) {
+            std::cout << "Recording has no keyframes: " << options.replayPath << std::endl;
+            return false;
+        }
+        std::cout << "Replaying generations " << replay.reader.firstGeneration() << " - " << replay.reader.lastGeneration() << std::endl;
+    }
+    else if (!options.loadSnapshot.empty()) {
+        if (!snapshot.open(options.loadSnapshot)) return false;
+        const SnapshotFile::Header& header = snapshot.header();
+        if (header.topology != SnapshotFile::BOUNDED) {
+            std::cout << "Snapshot topology " << header.topology << " isn't supported by the engine" << std::endl;
+            return false;
+        }
+        if (header.width > MAX_GPU_BOARD_DIM || header.height > MAX_GPU_BOARD_DIM) {
+            std::cout << "Snapshot board " << header.width << "x" << header.height << " is larger than the engine's "
+                      << MAX_GPU_BOARD_DIM << "x" << MAX_GPU_BOARD_DIM << " limit: " << options.loadSnapshot << std::endl;
+            snapshot.close();
+            return false;
+        }
+        // The snapshot fixes the board exactly; it's restarted where it left off
+        NUMCELLS_X = header.width;
+        NUMCELLS_Y = header.height;
+        generation = header.generation;
+        rule = snapshot.rule();
+    }
+    else if (!options.loadRLE.empty()) {
+        RLEFile::Header header;
+        if (!RLEFile::readHeader(options.loadRLE, header)) {
+            std::cout << "Failed to read RLE header: " << options.loadRLE << std::endl;
+            return false;
+        }
+        if (header.width > MAX_GPU_BOARD_DIM || header.height > MAX_GPU_BOARD_DIM) {
+            // RLE is decoded onto the flat board, so there's no view only fallback as for the sparse formats
+            std::cout << "Pattern is " << header.width << "x" << header.height << " cells, too big for the GPU board: "
+                      << options.loadRLE << std::endl;
+            return false;
+        }
+        NUMCELLS_X = std::max<uint>(NUMCELLS_X, static_cast<uint>(header.width));
+        NUMCELLS_Y = std::max<uint>(NUMCELLS_Y, static_cast<uint>(header.height));
+        if (ruleText.empty()) ruleText = header.rule;
+    }
+    else if (!options.loadMacrocell.empty()) {
+        std::string mcRule;
+        if (!MacrocellFile::load(options.loadMacrocell, macrocell, &mcRule, &generation)) {
+            std::cout << "Failed to load macrocell file: " << options.loadMacrocell << std::endl;
+            return false;
+        }
+        if (ruleText.empty()) ruleText = mcRule;
+
+        patternBox = macrocell.boundingBox();
+        int64_t boxW = patternBox.empty() ? 0 : patternBox.maxX - patternBox.minX + 1;
+        int64_t boxH = patternBox.empty() ? 0 : patternBox.maxY - patternBox.minY + 1;
+        if (boxW > MAX_GPU_BOARD_DIM || boxH > MAX_GPU_BOARD_DIM) {
+            // Never expanded to a flat grid: the visible window is painted from the quadtree each frame
+            std::cout << "Pattern is " << boxW << "x" << boxH << " cells, too big to simulate on the GPU board - view only" << std::endl;
+            patternViewOnly = true;
+            options.tileView = true;
+        }
+        else {
+            NUMCELLS_X = std::max<uint>(NUMCELLS_X, static_cast<uint>(boxW));
+            NUMCELLS_Y = std::max<uint>(NUMCELLS_Y, static_cast<uint>(boxH));
+        }
+    }
+    else if (!options.loadPlaintext.empty() || !options.loadLife106.empty()) {
+        cellListPath = options.loadPlaintext.empty() ? options.loadLife106 : options.loadPlaintext;
+        cellListFormat = options.loadPlaintext.empty() ? CellListFile::LIFE_106 : CellListFile::PLAINTEXT;
+        if (!CellListFile::scan(cellListPath, cellListFormat, cellListInfo)) {
+            std::cout << "Failed to read pattern: " << cellListPath << std::endl;
+            return false;
+        }
+
+        long long boxW = cellListInfo.width(), boxH = cellListInfo.height();
+        if (boxW > MAX_GPU_BOARD_DIM || boxH > MAX_GPU_BOARD_DIM) {
+            // Straight into the sparse store, bounding box at the origin
+            std::cout << "Pattern is " << boxW << "x" << boxH << " cells, too big to simulate on the GPU board - view only" << std::endl;
+            patternViewOnly = true;
+            options.tileView = true;
+            patternBox = { 0, 0, boxW - 1, boxH - 1 };
+            if (!CellListFile::load(cellListPath, cellListFormat, cellListInfo, tileStore, 0, 0)) return false;
+        }
+        else {
+            NUMCELLS_X = std::max<uint>(NUMCELLS_X, static_cast<uint>(boxW));
+            NUMCELLS_Y = std::max<uint>(NUMCELLS_Y, static_cast<uint>(boxH));
+        }
+    }
+
+    if (!options.ruleTable.empty()) {
+        tableRule = ruleTable.load(options.ruleTable);
+        return tableRule;
+    }
+    if (!ruleText.empty() && !rule.parse(ruleText)) {
+        largerThanLife = ltlRule.parse(ruleText);
+        if (largerThanLife) return true;
+        continuous = continuousRule.parse(ruleText);
+        if (continuous) return true;
+        margolus = margolusRule.parse(ruleText);
+        if (margolus) return true;
+
+        // As Golly does, a rule it doesn't know may be a rule table: looked for next to the pattern
+        std::string pattern = !options.loadRLE.empty() ? options.loadRLE : options.loadMacrocell;
+        size_t slash = pattern.find_last_of("/\\");
+        std::string tablePath = (slash == std::string::npos ? std::string() : pattern.substr(0, slash + 1)) + ruleText + ".rule";
+        if (!pattern.empty() && std::ifstream(tablePath).good()) {
+            tableRule = ruleTable.load(tablePath);
+            return tableRule;
+        }
+        std::cout << "Unsupported rule: " << ruleText << std::endl;
+        return false;
+    }
+    return true;
+}
+
+// Rejects the options the loaded rule can't be used with. Recordings, snapshots & checkpoints keep 2 states & a
+// B/S rule (a replay plays its own); macrocells 2 states; the census, emission catalogue & tile view assume 2
+// states, square cells & their 8 neighbours
+bool checkRuleSupport()
+{
+    enum Feature { CENSUS, EMISSIONS, RECORD, REPLAY, CHECKPOINT, LOAD_SNAPSHOT, SAVE_SNAPSHOT, SAVE_MC, TILE_VIEW, STATS, FEATURE_COUNT };
+    const char* flags[FEATURE_COUNT] = { "--census", "--emissions", "--record", "--replay", "--checkpoint-dir", "--snapshot",
+                                         "--save-snapshot", "--save-mc", "--tile-view", "--stats / --detect-period" };
+    const bool used[FEATURE_COUNT] = { !options.censusPath.empty(), !options.emissionsPath.empty(), !options.recordPath.empty(),
+                                       !options.replayPath.empty(), !options.checkpointDir.empty(), !options.loadSnapshot.empty(),
+                                       !options.saveSnapshot.empty(), !options.saveMacrocell.empty(), options.tileView,
+                                       !options.statsPath.empty() || options.maxPeriod > 0 };
+
+    struct RuleKind {
+        const char* name;
+        bool active;
+        bool supports[FEATURE_COUNT];   // In Feature order
+    };
+    const RuleKind kinds[] = {
+        //                                                              census emiss. record replay ckpt   load   save   mc     tiles  stats
+        { "Generations",                  rule.isGenerations(),          { false, false, false, false, false, true,  false, false, false, true  } },
+        { "Larger than Life",             largerThanLife,                { false, false, false, false, false, true,  false, true,  false, true  } },
+        { "Margolus",                     margolus,                      { false, false, false, false, false, true,  false, true,  false, true  } },
+        { "Isotropic non-totalistic",     rule.isotropic,                { true,  true,  false, false, false, true,  false, true,  true,  true  } },
+        { "Rule table",                   tableRule,                     { false, false, false, false, false, true,  false, false, false, true  } },
+        { "Continuous-state",             continuous,                    { false, false, false, false, false, false, false, false, false, false } },
+        { "Hexagonal & von Neumann",      rule.neighbourhood != LifeRule::MOORE,
+                                                                         { false, false, false, false, false, true,  false, true,  false, true  } },
+    };
+
+    bool ok = true;
+    for (const RuleKind& kind : kinds) {
+        if (!kind.active) continue;
+        std::string unsupported;
+        for (int f = 0; f < FEATURE_COUNT; f++)
+            if (used[f] && !kind.supports[f]) unsupported += (unsupported.empty() ? "" : ", ") + std::string(flags[f]);
+        if (unsupported.empty()) continue;
+        std::cout << kind.name << " rules don't support " << unsupported << std::endl;
+        ok = false;
+    }
+    return ok;
+}
+
+void saveBoard()
+{
+    if (options.saveRLE.empty() && options.saveMacrocell.empty() && options.saveSnapshot.empty()) return;
+
+    if (!patternViewOnly) syncCellsFromGPU();
+    if (tableRule || continuous) {
+        if (!options.saveRLE.empty() && !RLEFile::saveStates(options.saveRLE, newCells, NUMCELLS_X, NUMCELLS_Y,
+                                                             tableRule ? ruleTable.name : continuousRule.toString()))
+            std::cout << "Failed to save RLE: " << options.saveRLE << std::endl;
+        return;
+    }
+    PackedGrid board;
+    board.fromCells(newCells, NUMCELLS_X, NUMCELLS_Y);
+    std::string ruleName = margolus ? margolusRule.toString() : largerThanLife ? ltlRule.toString() : rule.toString();
+    if (!options.saveRLE.empty() && !RLEFile::save(options.saveRLE, board, ruleName))
+        std::cout << "Failed to save RLE: " << options.saveRLE << std::endl;
+
+    if (!options.saveMacrocell.empty()) {
+        // A view-only pattern is written back from its quadtree as is
+        if (!patternViewOnly) macrocell.buildFromGrid(board);
+        if (!MacrocellFile::save(options.saveMacrocell, macrocell, ruleName, generation))
+            std::cout << "Failed to save macrocell file: " << options.saveMacrocell << std::endl;
+    }
+
+    if (!options.saveSnapshot.empty() && !SnapshotFile::save(options.saveSnapshot, board.view(), rule, generation))
+        std::cout << "Failed to save snapshot: " << options.saveSnapshot << std::endl;
+}
+
+// Soup search mode (--soup-search): headless, all on the CPU
+int runSoupSearch()
+{
+    SoupSearch::Settings settings;
+    settings.seed = options.soupSeed;
+    settings.soups = options.soupCount;
+    if (options.maxPeriod > 0) settings.maxPeriod = options.maxPeriod;
+    if (!options.rule.empty() && (!settings.rule.parse(options.rule) || settings.rule.isGenerations() ||
+                                   settings.rule.neighbourhood != LifeRule::MOORE)) {
+        std::cout << "Unsupported rule: " << options.rule << std::endl;
+        return -1;
+    }
+
+    SoupSearch search(settings);
+    search.run();
+    std::cout << settings.soups << " soups in " << search.seconds() << " s (" << static_cast<uint64_t>(settings.soups / search.seconds())
+              << " soups/s), " << search.unsettled() << " unsettled" << std::endl;
+
+    // The most common objects, then the whole table to the census file
+    std::vector<std::pair<std::string, uint64_t>> top(search.census().table().begin(), search.census().table().end());
+    std::stable_sort(top.begin(), top.end(), [](const auto& a, const auto& b) { return a.second > b.second; });
+    for (size_t i = 0; i < top.size() && i < 10; i++) std::cout << "  " << top[i].first << " " << top[i].second << std::endl;
+    if (!options.censusPath.empty() && !search.census().write(options.censusPath)) return -1;
+    return 0;
+}
+
+// Parameter sweep mode (--sweep-seeds): every rule x density x seed is a universe of one batch, stepped
+// --generations on either engine (the GPU one headless, in a hidden window's context)
+int runSweep()
+{
+    auto split = [](const std::string& list) {
+        std::vector<std::string> items;
+        std::stringstream stream(list);
+        for (std::string item; std::getline(stream, item, ',');)
+            if (!item.empty()) items.push_back(item);
+        return items;
+    };
+
+    std::vector<LifeRule> rules;
+    for (const std::string& text : split(options.sweepRules.empty() ? (options.rule.empty() ? "B3/S23" : options.rule) : options.sweepRules)) {
+        LifeRule sweepRule;
+        if (!sweepRule.parse(text) || sweepRule.isGenerations() || sweepRule.isotropic || sweepRule.neighbourhood != LifeRule::MOORE) {
+            std::cout << "Unsupported rule: " << text << std::endl;
+            return -1;
+        }
+        rules.push_back(sweepRule);
+    }
+    std::vector<double> densities;
+    for (const std::string& text : split(options.sweepDensities)) {
+        char* end = nullptr;
+        double density = strtod(text.c_str(), &end);
+        if (*end != '\0' || !(density >= 0.0 && density <= 1.0)) {
+            std::cout << "Sweep density must be between 0 & 1: " << text << std::endl;
+            return -1;
+        }
+        densities.push_back(density);
+    }
+    if (rules.empty() || densities.empty()) {
+        std::cout << "Sweep needs at least one rule & one density" << std::endl;
+        return -1;
+    }
+    int seeds = options.sweepSeeds;
+    int generations = options.maxGenerations > 0 ? static_cast<int>(options.maxGenerations) : 1000;
+
+    // Universe (rule, density, seed) fills from the seed alone, so every rule & density starts from comparable soups
+    int universes = static_cast<int>(rules.size() * densities.size()) * seeds;
+    UniverseBatch batch(options.boardWidth, options.boardHeight, universes);
+    for (int u = 0; u < universes; u++) {
+        int seed = u % seeds;
+        double density = densities[(u / seeds) % densities.size()];
+        batch.setRule(u, rules[u / seeds / densities.size()]);
+
+        std::mt19937_64 random(seed);
+        std::uniform_real_distribution<double> uniform(0.0, 1.0);
+        for (int y = 0; y < batch.height(); y++)
+            for (int x = 0; x < batch.width(); x++)
+                batch.set(u, x, y, uniform(random) < density);
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    if (options.engine == "gpu") {
+        GLFWwindow* window = configGLFW(true);
+        if (window == NULL) return -1;
+        if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress)) {
+            std::cout << "Failed to initialize GLAD" << std::endl;
+            return -1;
+        }
+        {
+            GpuUniverseBatch gpuBatch(batch);
+            gpuBatch.step(generations);
+            gpuBatch.download(batch);
+        }
+        glfwTerminate();
+    }
+    else {
+        batch.step(generations);
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout << universes << " universes x " << generations << " generations in " << seconds << " s ("
+              << static_cast<uint64_t>(universes * static_cast<double>(generations) * batch.width() * batch.height() / seconds / 1e6)
+              << " M cell updates/s)" << std::endl;
+
+    std::vector<uint64_t> populations = batch.populations();
+    if (!options.sweepPath.empty()) {
+        std::ofstream file(options.sweepPath);
+        if (!file) {
+            std::cout << "Failed to open sweep output: " << options.sweepPath << std::endl;
+            return -1;
+        }
+        file << "rule,density,seed,population\n";
+        for (int u = 0; u < universes; u++)
+            file << rules[u / seeds / densities.size()].toString() << "," << densities[(u / seeds) % densities.size()] << ","
+                 << u % seeds << "," << populations[u] << "\n";
+        return 0;
+    }
+
+    // Mean final population of each rule & density
+    for (size_t r = 0; r < rules.size(); r++)
+        for (size_t d = 0; d < densities.size(); d++) {
+            uint64_t total = 0;
+            for (int seed = 0; seed < seeds; seed++) total += populations[(r * densities.size() + d) * seeds + seed];
+            std::cout << "  " << rules[r].toString() << " density " << densities[d] << ": mean population "
+                      << static_cast<double>(total) / seeds << std::endl;
+        }
+    return 0;
+}
+
+// 3D mode (--volume): a random block in the middle of the volume, stepped on the CPU each frame & drawn by
+// raymarching the packed volume. The view orbits slowly by itself unless it's being dragged
+int runVolume()
+{
+    Rule3D volumeRule;
+    if (!options.rule.empty() && !volumeRule.parse(options.rule)) {
+        std::cout << "Unsupported 3D rule: " << options.rule << std::endl;
+        return -1;
+    }
+
+    VoxelEngine engine;
+    engine.setRule(volumeRule);
+    engine.resize(options.volumeWidth, options.volumeHeight, options.volumeDepth);
+    std::mt19937_64 random(static_cast<uint64_t>(time(NULL)));
+    std::uniform_real_distribution<double> uniform(0.0, 1.0);
+    for (int z = engine.depth() / 4; z < engine.depth() * 3 / 4; z++)
+        for (int y = engine.height() / 4; y < engine.height() * 3 / 4; y++)
+            for (int x = engine.width() / 4; x < engine.width() * 3 / 4; x++)
+                if (uniform(random) < options.volumeDensity) engine.set(x, y, z, true);
+
+    GLFWwindow* window = configGLFW(options.offscreen);
+    if (window == NULL) return -1;
+    if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress)) {
+        std::cout << "Failed to initialize GLAD" << std::endl;
+        return -1;
+    }
+    if (options.offscreen) {
+        capture = new OffscreenCapture(SCR_WIDTH, SCR_HEIGHT);
+        if (!options.pngPattern.empty()) capture->openPngSequence(options.pngPattern);
+        if (!options.rawPipeCommand.empty() && !capture->openRawPipe(options.rawPipeCommand)) return -1;
+        capture->bindFramebuffer();
+    }
+
+    double stepSeconds = 0.0;
+    {
+        VolumeRenderer renderer(engine);
+        while (!glfwWindowShouldClose(window)) {
+            processInput(window);
+
+            auto start = std::chrono::steady_clock::now();
+            engine.step();
+            generation++;
+            stepSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+            if (glfwGetMouseButton(window, GLFW_MOUSE_BUTTON_LEFT) != GLFW_PRESS) volumeView.yaw += 0.005f;
+            renderer.upload(engine);
+            glClearColor(0.85f, 0.85f, 0.85f, 1.0f);
+            glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+            renderer.render(volumeView.yaw, volumeView.pitch, volumeView.distance, SCR_WIDTH, SCR_HEIGHT);
+
+            if (capture) capture->captureFrame();
+            else {
+                std::string title = "3D Life " + volumeRule.toString() + " - generation " + std::to_string(generation) + " - population " +
+                                    std::to_string(engine.population()) + " - " + std::to_string(engine.activeBricks()) + " active bricks";
+                glfwSetWindowTitle(window, title.c_str());
+                glfwSwapBuffers(window);
+            }
+            glfwPollEvents();
+
+            if (options.maxGenerations != 0 && generation >= options.maxGenerations) glfwSetWindowShouldClose(window, true);
+        }
+    }
+
+    std::cout << generation << " generations of " << volumeRule.toString() << ", " << stepSeconds * 1000.0 / std::max(generation, 1ull)
+              << " ms a step, final population " << engine.population() << std::endl;
+    if (capture) {
+        capture->finish();
+        std::cout << "Captured " << capture->framesWritten() << " frames" << std::endl;
+        delete capture;
+    }
+    glfwTerminate();
+    return 0;
+}
+
+// Tallies the objects left on the final board (--census)
+void takeCensus()
+{
+    if (options.censusPath.empty() || patternViewOnly) return;
+
+    syncCellsFromGPU();
+    PackedGrid board;
+    board.fromCells(newCells, NUMCELLS_X, NUMCELLS_Y);
+
+    ObjectCensus census;
+    census.setRule(rule);
+    double start = glfwGetTime();
+    census.take(board);
+    std::cout << "Census: " << census.objects().size() << " objects, " << census.table().size() << " kinds ("
+              << static_cast<int>((glfwGetTime() - start) * 1000.0) << " ms)" << std::endl;
+    census.write(options.censusPath);
+}
+
+// Logs the spaceships that have left the watched region (--emissions) & erases them. The detector only reads
+// its band: the CPU engine's board is passed as is every CHECK_INTERVAL generations. Off the GPU the band's
+// strips are copied into emissionReadback & scanned once they're back, a generation or two later, without
+// stalling; what's found then is stepped on to the current generation before it's erased. Only one scan is
+// in flight at a time, so a spaceship is erased before the band is copied again & never counted twice
+void detectEmissions()
+{
+    if (cpuEngine) {
+        if (generation % EmissionDetector::CHECK_INTERVAL != 0) return;
+        for (const EmissionDetector::Sighting& sighting : emissionDetector->scan(cpuEngine->board(), generation))
+            stamp(sighting.shape.view(), sighting.x, sighting.y, STAMP_CLEAR);
+        return;
+    }
+
+    std::vector<EmissionDetector::Sighting> sightings;
+    unsigned long long scanGeneration = 0;
+    emissionReadback->poll([&](const void* data, unsigned long long tag) {
+        sightings = scanEmissionBand(data, tag);
+        scanGeneration = tag;
+    });
+    for (const EmissionDetector::Sighting& sighting : sightings) {
+        EmissionDetector::Sighting now = emissionDetector->advance(sighting, static_cast<int>(generation - scanGeneration));
+        stamp(now.shape.view(), now.x, now.y, STAMP_CLEAR);
+    }
+
+    if (emissionReadback->inFlight() > 0 || generation < emissionScanGeneration + EmissionDetector::CHECK_INTERVAL) return;
+    // Whole-row strips are one contiguous range; the others a row segment each
+    glMemoryBarrier(GL_BUFFER_UPDATE_BARRIER_BIT);
+    glBindBuffer(GL_COPY_READ_BUFFER, prevCellsBuf);    // Holds the latest generation
+    glBindBuffer(GL_COPY_WRITE_BUFFER, emissionReadback->next());
+    GLintptr offset = 0;
+    for (const EmissionDetector::Rect& strip : emissionDetector->band()) {
+        int stripWidth = strip.x1 - strip.x0 + 1, rows = strip.y1 - strip.y0 + 1;
+        bool wholeRows = static_cast<uint>(stripWidth) == NUMCELLS_X;
+        GLsizeiptr bytes = static_cast<GLsizeiptr>(stripWidth) * (wholeRows ? rows : 1) * sizeof(uint32);
+        for (int y = strip.y0; y <= (wholeRows ? strip.y0 : strip.y1); y++) {
+            glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, (static_cast<GLintptr>(y) * NUMCELLS_X + strip.x0) * sizeof(uint32), offset, bytes);
+            offset += bytes;
+        }
+    }
+    emissionReadback->submit(generation);
+    emissionScanGeneration = generation;
+}
+
+// Scans a band read back by detectEmissions(), as of 'scanGeneration'
+std::vector<EmissionDetector::Sighting> scanEmissionBand(const void* data, unsigned long long scanGeneration)
+{
+    const uint32_t* cells = static_cast<const uint32_t*>(data);
+    for (const EmissionDetector::Rect& strip : emissionDetector->band())
+        for (int y = strip.y0; y <= strip.y1; y++)
+            for (int x = strip.x0; x <= strip.x1; x++) emissionBand.set(x, y, *cells++ != 0);
+    return emissionDetector->scan(emissionBand, scanGeneration);
+}
+
 // This shader draws an unchanging base grid with lines
 void initGridShader()
 {
@@ -229,78 +1276,268 @@ void initGridShader()
 // This shader draws coloured squares upon only the live cells
 void initLiveCellsShader()
 {
-    liveCells.Shader = new VFShaderProgram(SHADER_PATH "vert.vert", SHADER_PATH "frag.frag");
+    bool hexagonal = rule.neighbourhood == LifeRule::HEXAGONAL;
+    bool multiState = tableRule || continuous;
+    liveCells.Shader = new VFShaderProgram(SHADER_PATH "liveCells.vert", multiState ? SHADER_PATH "stateCells.frag" :
+                                           hexagonal ? SHADER_PATH "hexCells.frag" : SHADER_PATH "frag.frag");
+    liveCells.Shader->use();
+    liveCells.Shader->setInt_w_Name("numCellsX", NUMCELLS_X);
+    liveCells.Shader->setInt_w_Name("numCellsY", NUMCELLS_Y);
+    liveCells.Shader->setBool_w_Name("hexagonal", hexagonal);
+
+    liveCells.CompactShader = new ComputeShaderProgram(SHADER_PATH "compactLiveCells.comp");
+    liveCells.CompactShader->use();
+    liveCells.CompactShader->setInt_w_Name("numCellsX", NUMCELLS_X);
+    liveCells.CompactShader->setInt_w_Name("numCellsY", NUMCELLS_Y);
+    liveCells.CompactShader->setBool_w_Name("allStates", multiState);
+    if (gpuGenerations) liveCells.CompactShader->setInt_w_Name("packedWordsPerRow", gpuGenerations->packedWordsPerRow());
+
+    if (multiState) {
+        std::vector<GLfloat> palette;
+        if (tableRule) {
+            for (uint32_t colour : ruleTable.colours)
+                palette.insert(palette.end(), { ((colour >> 16) & 255) / 255.0f, ((colour >> 8) & 255) / 255.0f, (colour & 255) / 255.0f, 1.0f });
+        }
+        else for (int level = 0; level < 256; level++) {
+            // Continuous levels: pale blue through deep blue to yellow
+            float t = level / 255.0f, low = std::min(t * 2.0f, 1.0f), high = std::max(t * 2.0f - 1.0f, 0.0f);
+            palette.insert(palette.end(), { 0.75f - 0.6f * low + 0.85f * high, 0.8f - 0.55f * low + 0.6f * high, 0.95f - 0.3f * low - 0.55f * high, 1.0f });
+        }
+        glGenBuffers(1, &liveCells.PaletteBuf);
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, liveCells.PaletteBuf);
+        glBufferData(GL_SHADER_STORAGE_BUFFER, palette.size() * sizeof(GLfloat), palette.data(), GL_STATIC_DRAW);
+    }
 
     // Create & bind buffers
     // ---------------------
-    glGenVertexArrays(1, &liveCells.VAO); // // Generates the object and stores the resulting id in passed in integer
+    glGenVertexArrays(1, &liveCells.VAO);
+    glGenBuffers(1, &liveCells.ListBuf);
+    glGenBuffers(1, &liveCells.DrawCommandBuf);
 
-    // INIT, BIND & SET VBO, EBO
-    glGenBuffers(1, &liveCells.VBO);
-    glGenBuffers(1, &liveCells.EBO);
-    bindNewLiveCellVertices();
+    // Room for every cell to be alive
+    glBindBuffer(GL_ARRAY_BUFFER, liveCells.ListBuf);
+    glBufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(NUMCELLS_X) * NUMCELLS_Y * sizeof(GLuint), NULL, GL_DYNAMIC_COPY);
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, liveCells.DrawCommandBuf);
+    glBufferData(GL_DRAW_INDIRECT_BUFFER, 4 * sizeof(GLuint), NULL, GL_DYNAMIC_COPY);
 
-    // Config VAO
-    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(GLfloat), (void*)0);   // Describes to OpenGL how to interpet vertex POSITION data
-    glEnableVertexAttribArray(0);   /// Enables vertex attribute at location = 0, since they are disabled by default
+    // Config VAO: one live cell index per instance, the quad's corners come from gl_VertexID
+    glBindVertexArray(liveCells.VAO);
+    glVertexAttribIPointer(0, 1, GL_UNSIGNED_INT, sizeof(GLuint), (void*)0);
+    glVertexAttribDivisor(0, 1);
+    glEnableVertexAttribArray(0);
+    glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
 
-    // UNBIND VBO FROM CURRENT ACTIVE BUFFER
-    glBindBuffer(GL_ARRAY_BUFFER, 0); // This is allowed, the call to glVertexAttribPointer registered 'VBO' as the vertex attribute's bound VBO, so can safely unbind after
+    compactLiveCells();
 }
 
-void bindNewLiveCellVertices()
+// This shader draws the board from the tile cache, for boards too big to draw as per-cell quads
+void initTileView()
 {
-    std::vector<GLfloat> liveCellVertices; // 4 points (of 2 values) = 8 values for each live cell
-
-    GLfloat scaleX = 2.0f / static_cast<GLfloat>(NUMCELLS_X);
-    GLfloat scaleY = 2.0f / static_cast<GLfloat>(NUMCELLS_Y);
+    tileView.Shader = new VFShaderProgram(SHADER_PATH "tiles.vert", SHADER_PATH "tiles.frag");
+    tileCache = new TileCache(options.tileBudgetMB * 1024 * 1024);
+    glGenVertexArrays(1, &tileView.VAO);   // Core profile needs a VAO bound even though the triangle comes from gl_VertexID
+
+    // Zoom out is limited by how many tiles can be resident at once
+    int maxScreenDim = std::max(SCR_WIDTH, SCR_HEIGHT);
+    tileView.maxCellsPerPixel = static_cast<double>(tileCache->maxVisibleTiles() * TileStore::TILE_SIZE) / maxScreenDim;
+
+    // Start with the whole board in view
+    tileView.cellsPerPixel = std::max(static_cast<double>(NUMCELLS_X) / SCR_WIDTH, static_cast<double>(NUMCELLS_Y) / SCR_HEIGHT);
+    tileView.cellsPerPixel = std::min(std::max(tileView.cellsPerPixel, tileView.minCellsPerPixel), tileView.maxCellsPerPixel);
+    tileView.originX = 0.5 * NUMCELLS_X - 0.5 * SCR_WIDTH * tileView.cellsPerPixel;
+    tileView.originY = 0.5 * NUMCELLS_Y - 0.5 * SCR_HEIGHT * tileView.cellsPerPixel;
+
+    if (patternViewOnly) {
+        // Centre on the pattern, as zoomed out as the cache allows
+        tileView.cellsPerPixel = tileView.maxCellsPerPixel;
+        tileView.originX = 0.5 * (patternBox.minX + patternBox.maxX) - 0.5 * SCR_WIDTH * tileView.cellsPerPixel;
+        tileView.originY = 0.5 * (patternBox.minY + patternBox.maxY) - 0.5 * SCR_HEIGHT * tileView.cellsPerPixel;
+    }
+    else tileReadback = new ReadbackRing(3, static_cast<size_t>(NUMCELLS_X) * NUMCELLS_Y * sizeof(uint32), GL_STREAM_READ);
+}
 
-    newLiveCellsCount = 0;
-    for (GLint y = 0; y < NUMCELLS_Y; ++y) {
-        for (GLint x = 0; x < NUMCELLS_X; ++x) {
-            if (newCells[y*NUMCELLS_X + x] == 0) continue;  // Dead cell
+// Brings the tile store up to the board (only the tiles that changed are re-versioned). A board on the CPU
+// goes straight in; off the GPU it's copied into tileReadback & loaded once the copy is back, so the view
+// runs a frame or two behind the simulation rather than the simulation waiting on the view
+void refreshTileStore()
+{
+    if (!cpuCellsStale) {
+        tileReadback->flush([](const void*, unsigned long long) {});     // Boards older than this one
+        tileStore.loadCells(newCells, NUMCELLS_X, NUMCELLS_Y);
+        return;
+    }
+    if (!tileReadback->full()) {
+        glMemoryBarrier(GL_BUFFER_UPDATE_BARRIER_BIT);
+        glBindBuffer(GL_COPY_READ_BUFFER, prevCellsBuf);    // Holds the latest generation
+        glBindBuffer(GL_COPY_WRITE_BUFFER, tileReadback->next());
+        glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0, static_cast<GLsizeiptr>(tileReadback->bytes()));
+        tileReadback->submit(generation);
+    }
+    // The boards that have come back, oldest first
+    while (tileReadback->poll([](const void* data, unsigned long long) {
+        tileStore.loadCells(static_cast<const uint32_t*>(data), NUMCELLS_X, NUMCELLS_Y);
+    })) {}
+}
 
-            newLiveCellsCount++;
+// Lists the latest generation's live cells for renderLiveCells(), entirely on the GPU
+void compactLiveCells()
+{
+    const GLuint drawCommand[4] = { 6, 0, 0, 0 };     // 6 vertices per quad, instance count filled in by the shader
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, liveCells.DrawCommandBuf);
+    glBufferSubData(GL_DRAW_INDIRECT_BUFFER, 0, sizeof(drawCommand), drawCommand);
+
+    liveCells.CompactShader->use();
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, gpuGenerations ? gpuGenerations->statesBuffer() : prevCellsBuf);   // Holds the latest generation
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 4, liveCells.ListBuf);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 5, liveCells.DrawCommandBuf);
+    glDispatchCompute((NUMCELLS_X+7)/8, (NUMCELLS_Y+7)/8, 1);
+    glMemoryBarrier(GL_VERTEX_ATTRIB_ARRAY_BARRIER_BIT | GL_COMMAND_BARRIER_BIT);
+}
 
-            GLfloat xF = static_cast<GLfloat>(x);   GLfloat yF = static_cast<GLfloat>(y);
+// Advances the board one generation on whichever engine is in use, passing on its stats
+void stepBoard()
+{
+    GenerationStats stats;
+    stats.generation = generation + 1;
+
+    if ((margolusEngine || gpuMargolus) && options.reverseAt > 0 && generation == options.reverseAt) runningBackward = true;
+
+    if (cpuStepper.step) {
+        bool wanted = cpuStepper.keepsStats && (statsWriter || periodDetector);
+        cpuStepper.step(wanted ? &stats : nullptr);
+        cpuStepper.toCells(newCells);
+        uploadCells();      // The renderer draws from the GPU copy
+        if (wanted) handleStats(stats);
+        return;
+    }
+    if (gpuLtl) {
+        gpuLtl->step(prevCellsBuf);
+        cpuCellsStale = true;
+        return;
+    }
+    if (gpuGenerations) {
+        gpuGenerations->step();
+        cpuCellsStale = true;
+        return;
+    }
+    if (gpuContinuous) {
+        gpuContinuous->step(prevCellsBuf);     // Also leaves the levels where the renderer draws from
+        cpuCellsStale = true;
+        return;
+    }
+    if (gpuMargolus) {
+        gpuMargolus->step(prevCellsBuf, runningBackward);
+        cpuCellsStale = true;
+        return;
+    }
+    if (gpuTable) {
+        gpuTable->step(prevCellsBuf, newCellsBuf);
+        cpuCellsStale = true;
+        std::swap(prevCellsBuf, newCellsBuf);
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, prevCellsBuf);
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, newCellsBuf);
+        return;
+    }
 
-            liveCellVertices.push_back(xF * scaleX - 1.0f);     // BOTTOM-LEFT
-            liveCellVertices.push_back(yF * scaleY - 1.0f);
+    if (gpuStats) gpuStats->begin();
+    executeCompShader();
+    if (gpuStats) {
+        gpuStats->end(generation + 1);
+        while (gpuStats->poll(stats)) handleStats(stats);     // Steps the GPU has finished, oldest first
+    }
+}
 
-            liveCellVertices.push_back((xF+1.0f) * scaleX -1.0f); // BOTTOM-RIGHT
-            liveCellVertices.push_back(yF * scaleY - 1.0f);
+// Called from stepBoard() with each generation's stats, in order (a few generations late on the GPU)
+void handleStats(const GenerationStats& stats)
+{
+    if (statsWriter) statsWriter->push(stats);
+    if (!periodDetector) return;
 
-            liveCellVertices.push_back((xF+1.0f) * scaleX -1.0f); // TOP-RIGHT
-            liveCellVertices.push_back((yF+1.0f) * scaleY -1.0f);
+    int period = periodDetector->add(stats.generation, stats.hash);
+    if (!period) return;
+    std::cout << "Board is periodic with period " << period << " since generation " << periodDetector->periodicSince() << std::endl;
 
-            liveCellVertices.push_back(xF * scaleX - 1.0f);     // TOP-LEFT
-            liveCellVertices.push_back((yF+1) * scaleY - 1.0f);
+    if (options.onPeriod == "stop") {
+        stopRequested = true;
+    }
+    else if (options.onPeriod == "skip" && stampScript.finished()) {
+        // The board repeats every 'period' generations, so jumping the counter by a multiple of it leaves
+        // the board correct for the new generation. generation + 1 is the one just stepped
+        unsigned long long next = generation + 1;
+        if (options.maxGenerations > next) {
+            generation += (options.maxGenerations - next) / period * period;
+            std::cout << "Skipped ahead to generation " << generation + 1 << std::endl;
         }
     }
+}
 
-    std::vector<GLint> liveCellIndices; // 2 triangles of 3 indices = 6 ints for each live cell
-
-    for (GLint vertex = 0; vertex < liveCellVertices.size() / 2; vertex += 4) {
-        // First triangle
-        liveCellIndices.push_back(vertex);
-        liveCellIndices.push_back(vertex+1);
-        liveCellIndices.push_back(vertex+2);
+// Places a pattern on the live board (bottom-left corner at (x, y)). Only the covered cells are
+// touched: on the GPU board (which the renderer draws from), and on the CPU engine's board & copy if in use
+void stamp(const PackedGridView& pattern, int x, int y, StampMode mode)
+{
+    if (continuousEngine) {
+        continuousEngine->stamp(pattern, x, y, mode);
+        continuousEngine->toCells(newCells);
+        uploadCells();
+        return;
+    }
+    if (gpuContinuous) {
+        gpuContinuous->stamp(prevCellsBuf, pattern, x, y, mode);
+        cpuCellsStale = true;
+        return;
+    }
+    if (rule.isGenerations() || tableRule) {
+        // The binary stampers would mangle states: stamped on the CPU copy, which is reloaded
+        syncCellsFromGPU();
+        int x0 = std::max(x, 0), x1 = std::min<int>(x + pattern.width, NUMCELLS_X);
+        int y0 = std::max(y, 0), y1 = std::min<int>(y + pattern.height, NUMCELLS_Y);
+        for (int j = y0; j < y1; j++)
+            for (int i = x0; i < x1; i++)
+                newCells[j * NUMCELLS_X + i] = stampState(newCells[j * NUMCELLS_X + i], pattern.get(i - x, j - y), mode);
+        if (gpuGenerations) {
+            gpuGenerations->load(newCells);
+            cpuCellsStale = false;
+            return;
+        }
+        uploadCells();      // All gpuTable needs: it steps the board buffers
+        if (generationsEngine) generationsEngine->loadCells(newCells, NUMCELLS_X, NUMCELLS_Y);
+        else if (tableEngine) tableEngine->loadCells(newCells, NUMCELLS_X, NUMCELLS_Y);
+        return;
+    }
 
-        // Second triangle
-        liveCellIndices.push_back(vertex+2);
-        liveCellIndices.push_back(vertex+3);
-        liveCellIndices.push_back(vertex);
+    if (!gpuStamper) gpuStamper = new GpuStamper();
+    gpuStamper->stamp(prevCellsBuf, NUMCELLS_X, NUMCELLS_Y, pattern, x, y, mode);   // prevCellsBuf holds the latest generation
+    if (!cpuEngine && !ltlEngine && !margolusEngine) {
+        cpuCellsStale = true;
+        return;
     }
 
-    glBindVertexArray(liveCells.VAO); // Binds 'VAO' as current active vertex array object
+    if (cpuEngine) cpuEngine->stamp(pattern, x, y, mode);
+    else if (ltlEngine) ltlEngine->stamp(pattern, x, y, mode);
+    else margolusEngine->stamp(pattern, x, y, mode);
+    int x0 = std::max(x, 0), x1 = std::min<int>(x + pattern.width, NUMCELLS_X);
+    int y0 = std::max(y, 0), y1 = std::min<int>(y + pattern.height, NUMCELLS_Y);
+    for (int j = y0; j < y1; j++)
+        for (int i = x0; i < x1; i++)
+            newCells[j * NUMCELLS_X + i] = stampCell(newCells[j * NUMCELLS_X + i], pattern.get(i - x, j - y), mode);
+}
 
-    // VBO (vertex data)
-    glBindBuffer(GL_ARRAY_BUFFER, liveCells.VBO);  // Binds newly created object to the correct buffer type, which when updated/configured will update 'VBO' (as seen below)
-    glBufferData(GL_ARRAY_BUFFER, liveCellVertices.size() * sizeof(GLfloat), liveCellVertices.data(), GL_DYNAMIC_DRAW);  // Copies vertex data into the buffer
-    
-    // EBO (index data)
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, liveCells.EBO);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, liveCellIndices.size() * sizeof(GLint), liveCellIndices.data(), GL_STATIC_DRAW);
+void applyScriptedStamps()
+{
+    while (const StampScript::Entry* entry = stampScript.next(generation))
+        stamp(stampScript.pattern(entry->pattern).view(), entry->x, entry->y, entry->mode);
+}
+
+// Drops a random 16x16 soup somewhere on the board
+void stampRandomSoup()
+{
+    const int SOUP_SIZE = 16;
+    PackedGrid soup(SOUP_SIZE, SOUP_SIZE);
+    for (int y = 0; y < SOUP_SIZE; y++)
+        for (int x = 0; x < SOUP_SIZE; x++)
+            soup.set(x, y, rand() % 2 == 1);
+    stamp(soup.view(), rand() % std::max<int>(1, NUMCELLS_X - SOUP_SIZE), rand() % std::max<int>(1, NUMCELLS_Y - SOUP_SIZE), STAMP_REPLACE);
 }
 
 void executeCompShader()
@@ -308,26 +1545,12 @@ void executeCompShader()
     computeShader->use();
 
     glDispatchCompute((NUMCELLS_X+7)/8, (NUMCELLS_Y+7)/8, 1);
-    glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT); // Wait for execution to complete so data isn't overwritten
-
-    // glBindBuffer(GL_SHADER_STORAGE_BUFFER, prevCellsBuf);
-    // uint32* temp = static_cast<uint32*>(glMapBufferRange(GL_SHADER_STORAGE_BUFFER, 0, newCells.size() * sizeof(uint32), GL_MAP_READ_BIT));
-    // if (temp)
-    // {
-    //     std::vector<uint32> result(temp, temp + prevCells.size());
-    //     newCells = result;
-    // }
-    // glUnmapBuffer(GL_SHADER_STORAGE_BUFFER);
-
-    // Read from SSBOs
-    glBindBuffer(GL_SHADER_STORAGE_BUFFER, newCellsBuf);
-    // Map buffer for reading
-    uint32* ptr = static_cast<uint32*>(glMapBufferRange(GL_SHADER_STORAGE_BUFFER, 0, newCells.size() * sizeof(uint32), GL_MAP_READ_BIT));
-    if (ptr)
-    {
-        std::copy(ptr, ptr + newCells.size(), newCells.begin());
-    }
-    glUnmapBuffer(GL_SHADER_STORAGE_BUFFER);
+    // Wait for execution to complete so data isn't overwritten, & so the GpuStats counters it wrote are
+    // visible when GpuStats maps them on the CPU
+    glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT | GL_BUFFER_UPDATE_BARRIER_BIT);
+
+    // The board stays on the GPU: newCells is only read back on demand (syncCellsFromGPU())
+    cpuCellsStale = true;
 
     // "New" becomes "Prev"
     std::swap(prevCellsBuf, newCellsBuf);
@@ -339,7 +1562,7 @@ void executeCompShader()
 
 void writeToSSBOs()
 {
-    GLuint bufferSize = prevCells.size() * sizeof(prevCells[0]);
+    GLsizeiptr bufferSize = static_cast<GLsizeiptr>(prevCells.size() * sizeof(prevCells[0]));
 
     glBindBuffer(GL_SHADER_STORAGE_BUFFER, prevCellsBuf);   // Binds the buffer to an SSBO at binding index = 0 in the compute shader
     glBufferData(GL_SHADER_STORAGE_BUFFER, bufferSize, prevCells.data(), GL_DYNAMIC_DRAW);  // Send buffer data to SSBO target
@@ -348,10 +1571,118 @@ void writeToSSBOs()
     glBufferData(GL_SHADER_STORAGE_BUFFER, bufferSize, newCells.data(), GL_DYNAMIC_COPY);
 }
 
+// Seeds both board SSBOs from the mapped snapshot: the packed rows go to the GPU straight from the
+// mapping (the only CPU touch is the driver's copy as pages fault in) & are expanded by a compute pass
+void uploadSnapshot()
+{
+    GLsizeiptr bufferSize = static_cast<GLsizeiptr>(NUMCELLS_X) * NUMCELLS_Y * sizeof(uint32);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, prevCellsBuf);
+    glBufferData(GL_SHADER_STORAGE_BUFFER, bufferSize, NULL, GL_DYNAMIC_DRAW);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, newCellsBuf);
+    glBufferData(GL_SHADER_STORAGE_BUFFER, bufferSize, NULL, GL_DYNAMIC_COPY);
+
+    GLuint packedBuf;
+    glGenBuffers(1, &packedBuf);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, packedBuf);
+    glBufferData(GL_SHADER_STORAGE_BUFFER, static_cast<GLsizeiptr>(snapshot.header().dataBytes), snapshot.data(), GL_STREAM_DRAW);
+
+    ComputeShaderProgram unpackShader(SHADER_PATH "unpackCells.comp");
+    unpackShader.use();
+    unpackShader.setInt_w_Name("numCellsX", NUMCELLS_X);
+    unpackShader.setInt_w_Name("numCellsY", NUMCELLS_Y);
+    unpackShader.setInt_w_Name("packedWordsPerRow", static_cast<int>(snapshot.header().wordsPerRow * 2));
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, prevCellsBuf);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, newCellsBuf);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 2, packedBuf);
+    glDispatchCompute((NUMCELLS_X+7)/8, (NUMCELLS_Y+7)/8, 1);
+    glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT | GL_BUFFER_UPDATE_BARRIER_BIT);
+
+    glDeleteBuffers(1, &packedBuf);
+    snapshot.close();
+    cpuCellsStale = true;
+}
+
+// Copies the CPU board (newCells) into the buffer the renderer & the reductions read, for engines
+// whose board lives on the CPU
+void uploadCells()
+{
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, prevCellsBuf);
+    glBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, newCells.size() * sizeof(uint32), newCells.data());
+    cpuCellsStale = false;
+}
+
+// Brings newCells up to date with the GPU board, for the things that need the cells on the CPU
+// (recording, checkpoints, the tile view, saving). A no-op when nothing has changed since the last read
+void syncCellsFromGPU()
+{
+    if (!cpuCellsStale) return;
+    if (gpuGenerations) {
+        gpuGenerations->toCells(newCells);
+        cpuCellsStale = false;
+        return;
+    }
+    glMemoryBarrier(GL_BUFFER_UPDATE_BARRIER_BIT);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, prevCellsBuf);    // Holds the latest generation
+    glGetBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, newCells.size() * sizeof(uint32), newCells.data());
+    cpuCellsStale = false;
+}
+
+// Sends the latest generation to the recorder and / or a checkpoint, if either can take it right now. Off
+// the GPU the board is copied into a staging buffer of boardReadback & fenced: collectBoardReadbacks() hands
+// it over once the copy is done, so the step loop never waits for it (nor reads back boards that would be dropped)
+void requestBoardReadback()
+{
+    bool record = recorder && recorder->hasRoom();
+    bool checkpoint = checkpointer && !checkpointReadPending && checkpointer->due(generation);
+    if (recorder && !record) recorder->drop();
+    if (!record && !checkpoint) return;
+
+    if (!cpuCellsStale) {
+        // The board is on the CPU already
+        if (record) recorder->record(newCells, generation);
+        if (checkpoint) {
+            // newCells is handed over as is (& swapped for a spare), so it must be read back again after
+            checkpointer->submit(newCells, generation);
+            cpuCellsStale = true;
+        }
+        return;
+    }
+    if (boardReadback->full()) {
+        // The GPU is a few frames behind: skip this generation rather than wait
+        if (record) recorder->drop();
+        return;
+    }
+
+    glMemoryBarrier(GL_BUFFER_UPDATE_BARRIER_BIT);
+    glBindBuffer(GL_COPY_READ_BUFFER, prevCellsBuf);    // Holds the latest generation
+    glBindBuffer(GL_COPY_WRITE_BUFFER, boardReadback->next());
+    glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0, static_cast<GLsizeiptr>(boardReadback->bytes()));
+    boardReadback->submit(generation);
+    boardReadbacks.push_back({ record, checkpoint });
+    checkpointReadPending |= checkpoint;
+}
+
+// Hands the boards whose readback has finished to the recorder / checkpointer, oldest first ('wait': all of them)
+void collectBoardReadbacks(bool wait)
+{
+    auto consume = [](const void* data, unsigned long long readGeneration) {
+        BoardReadback request = boardReadbacks.front();
+        boardReadbacks.pop_front();
+        const uint32_t* cells = static_cast<const uint32_t*>(data);
+        if (request.record) recorder->record(cells, readGeneration);
+        if (request.checkpoint) {
+            checkpointer->submit(cells, readGeneration);
+            checkpointReadPending = false;
+        }
+    };
+    if (wait) boardReadback->flush(consume);
+    else while (boardReadback->poll(consume)) {}
+}
+
 
 // GLFW: INIT & SETUP WINDOW OBJECT
 // --------------------------------
-GLFWwindow* configGLFW()
+GLFWwindow* configGLFW(bool offscreen)
 {
     if (!glfwInit())
     {
@@ -361,6 +1692,16 @@ GLFWwindow* configGLFW()
     glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
     glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
     glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+
+    if (offscreen) {
+        // The window only exists to own the context; all drawing goes to the capture FBO
+        glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+#ifdef GOL_HEADLESS
+        glfwWindowHint(GLFW_CONTEXT_CREATION_API, GLFW_OSMESA_CONTEXT_API);     // GLFW built with OSMesa: no display needed at all
+#else
+        glfwWindowHint(GLFW_CONTEXT_CREATION_API, GLFW_EGL_CONTEXT_API);
+#endif
+    }
   
     // CREATE WINDOW OBJ
     // -----------------
@@ -379,6 +1720,7 @@ GLFWwindow* configGLFW()
     glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
     glfwSetCursorPosCallback(window, mouseMoveCallback);
     glfwSetScrollCallback(window, mouseScrollCallback);
+    glfwSetKeyCallback(window, keyCallback);
     return window;
 }
 
@@ -421,12 +1763,75 @@ void outputGLLimits()
 void framebufferSizeCallback(GLFWwindow* window, int width, int height)
 {
     glViewport(0, 0, width, height);
+    SCR_WIDTH = width;  SCR_HEIGHT = height;
 }
 
+// Drag with the left button to pan the tile view, or orbit the volume
 void mouseMoveCallback(GLFWwindow* window, double mouseX, double mouseY)
 {
+    if (options.volumeWidth > 0) {
+        if (glfwGetMouseButton(window, GLFW_MOUSE_BUTTON_LEFT) == GLFW_PRESS) {
+            volumeView.yaw -= static_cast<float>(mouseX - volumeView.lastMouseX) * 0.01f;
+            volumeView.pitch = std::min(std::max(volumeView.pitch + static_cast<float>(mouseY - volumeView.lastMouseY) * 0.01f, -1.5f), 1.5f);
+        }
+        volumeView.lastMouseX = mouseX;     volumeView.lastMouseY = mouseY;
+        return;
+    }
+
+    if (options.tileView && glfwGetMouseButton(window, GLFW_MOUSE_BUTTON_LEFT) == GLFW_PRESS) {
+        tileView.originX -= (mouseX - tileView.lastMouseX) * tileView.cellsPerPixel;
+        tileView.originY += (mouseY - tileView.lastMouseY) * tileView.cellsPerPixel;  // Window y points down, board y up
+    }
+    tileView.lastMouseX = mouseX;   tileView.lastMouseY = mouseY;
 }
 
+// Scroll to zoom the tile view about the centre of the screen, or the volume view in & out
 void mouseScrollCallback(GLFWwindow* window, double xoffset, double yoffset)
 {
-}
\ No newline at end of file
+    if (options.volumeWidth > 0) {
+        volumeView.distance = std::min(std::max(volumeView.distance * static_cast<float>(std::pow(1.1, -yoffset)), 0.2f), 5.0f);
+        return;
+    }
+    if (!options.tileView) return;
+
+    double centreX = tileView.originX + 0.5 * SCR_WIDTH * tileView.cellsPerPixel;
+    double centreY = tileView.originY + 0.5 * SCR_HEIGHT * tileView.cellsPerPixel;
+    tileView.cellsPerPixel *= std::pow(1.25, -yoffset);
+    tileView.cellsPerPixel = std::min(std::max(tileView.cellsPerPixel, tileView.minCellsPerPixel), tileView.maxCellsPerPixel);
+    tileView.originX = centreX - 0.5 * SCR_WIDTH * tileView.cellsPerPixel;
+    tileView.originY = centreY - 0.5 * SCR_HEIGHT * tileView.cellsPerPixel;
+}
+
+// R stamps a random soup onto a running board.
+// Replay controls: space plays / pauses, left / right step a generation, page up / down jump 5% of the
+// recording, home / end go to its ends
+void keyCallback(GLFWwindow* window, int key, int scancode, int action, int mods)
+{
+    if (options.volumeWidth > 0) return;    // No 2D board to stamp on
+    if (key == GLFW_KEY_R && action != GLFW_RELEASE && options.replayPath.empty() && !patternViewOnly) {
+        stampRandomSoup();
+        return;
+    }
+    if (key == GLFW_KEY_B && action == GLFW_PRESS && margolus && margolusRule.reversible()) {
+        runningBackward = !runningBackward;
+        return;
+    }
+    if (options.replayPath.empty() || action == GLFW_RELEASE) return;
+
+    unsigned long long first = replay.reader.firstGeneration(), last = replay.reader.lastGeneration();
+    unsigned long long jump = std::max(1ull, (last - first) / 20);
+    unsigned long long target = generation;
+    switch (key) {
+        case GLFW_KEY_SPACE:        if (action == GLFW_PRESS) replay.playing = !replay.playing; return;
+        case GLFW_KEY_RIGHT:        target = generation + 1; break;
+        case GLFW_KEY_LEFT:         target = generation > first ? generation - 1 : first; break;
+        case GLFW_KEY_PAGE_UP:      target = generation + jump; break;
+        case GLFW_KEY_PAGE_DOWN:    target = generation > first + jump ? generation - jump : first; break;
+        case GLFW_KEY_HOME:         target = first; break;
+        case GLFW_KEY_END:          target = last; break;
+        default:                    return;
+    }
+    replay.playing = false;
+    replay.seekTarget = std::min(target, last);
+    replay.seekPending = true;
+}
@@ -0,0 +1,224 @@
+#include <iostream>
+#include <cstring>
+#include <cstdlib>
+#include <cstdio>
+#include "app_options.h"
+
+void printUsage(const char* programName)
+{
+    std::cout << "Usage: " << programName << " [options]\n"
+              << "  --board-size WxH        Board dimensions in cells (default 75x75)\n"
+              << "  --rule RULE             Life-like rule, e.g. B36/S23 or B2-a/S12 (default: the pattern's, else B3/S23)\n"
+              << "                          also Generations (B2/S/C3) & Larger than Life (R5,C0,M1,S33..57,B34..45,NM)\n"
+              << "                          H / V after a rule: hexagonal (B2/S34H) or von Neumann (B1/S012V) neighbours\n"
+              << "                          continuous states: Lenia:R=13,T=10,m=0.15,s=0.015,b=1 or SmoothLife:ri=7,ra=21\n"
+              << "                          Margolus blocks: MS,D0;8;4;3;2;5;9;7;1;6;10;11;12;13;14;15, BBM, Critters or Tron\n"
+              << "  --rule-table FILE       Run a Golly rule table (.rule with @TABLE, e.g. WireWorld) with up to 256 states\n"
+              << "                          (a pattern's rule is also looked for as RULE.rule next to the pattern)\n"
+              << "  --engine gpu|cpu        Step on the GPU (default) or the bit-parallel CPU engine\n"
+              << "  --reverse-at N          Reversible (Margolus) rules: step backwards from generation N, undoing the run\n"
+              << "  --rle FILE              Seed the board from an RLE pattern\n"
+              << "  --save-rle FILE         Save the board as RLE on exit\n"
+              << "  --mc FILE               Seed from a macrocell (.mc) pattern; huge ones are shown view-only\n"
+              << "  --save-mc FILE          Save the board as macrocell on exit\n"
+              << "  --cells FILE            Seed from a plaintext (.cells) pattern\n"
+              << "  --life106 FILE          Seed from a Life 1.06 coordinate list\n"
+              << "  --stamp-script FILE     Stamp patterns during the run: \"generation x y or|xor|replace|clear file.rle\" lines\n"
+              << "  --snapshot FILE         Resume from a binary snapshot (memory mapped, no parsing)\n"
+              << "  --save-snapshot FILE    Save the board as a binary snapshot on exit\n"
+              << "  --record FILE           Record the run's history, delta compressed, to FILE\n"
+              << "  --keyframe-interval N   Generations between keyframes in a recording (default 1000)\n"
+              << "  --replay FILE           Play back a recording (space: pause, arrows: step, page up/down: jump)\n"
+              << "  --replay-from G         Start the replay at generation G\n"
+              << "  --stats FILE            Write per-generation population/births/deaths/bounding box (.csv or binary)\n"
+              << "  --detect-period P       Detect the board repeating with a period of up to P generations\n"
+              << "  --on-period ACTION      report (default), stop the run, or skip ahead to --generations\n"
+              << "  --census FILE           Write a census of the objects on the final board (apgcodes, CSV)\n"
+              << "  --emissions FILE        Log spaceships leaving the board (gun output) to FILE & remove them\n"
+              << "  --soup-search N         Evolve N random 16x16 soups to stability on all cores & census the results\n"
+              << "  --soup-seed S           Seed of the soups (default 0)\n"
+              << "  --sweep-seeds N         Sweep N random fills of each rule & density, all stepped as one batch\n"
+              << "  --sweep-rules LIST      Comma separated rules to sweep (default --rule)\n"
+              << "  --sweep-densities LIST  Comma separated fill densities to sweep (default 0.5)\n"
+              << "  --sweep-out FILE        Write each universe's final population (CSV)\n"
+              << "  --volume WxHxD          Run a 3D rule (--rule, e.g. 4555 or B5/S45, V for 6 neighbours) in a\n"
+              << "                          WxHxD volume, drawn raymarched (orbit: drag, zoom: scroll)\n"
+              << "  --volume-density D      Fill density of the random block seeding the volume (default 0.2)\n"
+              << "  --checkpoint-dir DIR    Checkpoint into DIR & resume from its newest valid checkpoint\n"
+              << "  --checkpoint-every N    Checkpoint every N generations\n"
+              << "  --checkpoint-seconds T  Checkpoint every T seconds (default 300, 0 = off)\n"
+              << "  --checkpoint-keep K     Keep the newest K checkpoints (default 3)\n"
+              << "  --offscreen             Render into an FBO with no visible window\n"
+              << "  --generations N         Stop after N generations\n"
+              << "  --png PATTERN           Write frames as a PNG sequence, e.g. out/frame_%06d.png\n"
+              << "  --raw-pipe COMMAND      Pipe raw RGBA frames (top row first) into COMMAND's stdin\n"
+              << "  --tile-view             Render through the streamed GPU tile cache (pan: drag, zoom: scroll)\n"
+              << "  --tile-budget-mb N      Tile atlas memory budget in MB (default 64)\n"
+              << "  --help                  Show this message\n";
+}
+
+bool parseAppOptions(int argc, char** argv, AppOptions& options)
+{
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        bool hasValue = i + 1 < argc;
+
+        if (strcmp(arg, "--board-size") == 0 && hasValue) {
+            if (sscanf(argv[++i], "%dx%d", &options.boardWidth, &options.boardHeight) != 2 || options.boardWidth <= 0 || options.boardHeight <= 0) {
+                std::cout << "Bad board size: " << argv[i] << std::endl;
+                return false;
+            }
+        }
+        else if (strcmp(arg, "--rule") == 0 && hasValue) {
+            options.rule = argv[++i];
+        }
+        else if (strcmp(arg, "--rule-table") == 0 && hasValue) {
+            options.ruleTable = argv[++i];
+        }
+        else if (strcmp(arg, "--reverse-at") == 0 && hasValue) {
+            options.reverseAt = strtoull(argv[++i], NULL, 10);
+        }
+        else if (strcmp(arg, "--engine") == 0 && hasValue) {
+            options.engine = argv[++i];
+            if (options.engine != "gpu" && options.engine != "cpu") {
+                std::cout << "Unknown engine: " << options.engine << std::endl;
+                return false;
+            }
+        }
+        else if (strcmp(arg, "--rle") == 0 && hasValue) {
+            options.loadRLE = argv[++i];
+        }
+        else if (strcmp(arg, "--save-rle") == 0 && hasValue) {
+            options.saveRLE = argv[++i];
+        }
+        else if (strcmp(arg, "--mc") == 0 && hasValue) {
+            options.loadMacrocell = argv[++i];
+        }
+        else if (strcmp(arg, "--save-mc") == 0 && hasValue) {
+            options.saveMacrocell = argv[++i];
+        }
+        else if (strcmp(arg, "--cells") == 0 && hasValue) {
+            options.loadPlaintext = argv[++i];
+        }
+        else if (strcmp(arg, "--life106") == 0 && hasValue) {
+            options.loadLife106 = argv[++i];
+        }
+        else if (strcmp(arg, "--stamp-script") == 0 && hasValue) {
+            options.stampScriptPath = argv[++i];
+        }
+        else if (strcmp(arg, "--snapshot") == 0 && hasValue) {
+            options.loadSnapshot = argv[++i];
+        }
+        else if (strcmp(arg, "--save-snapshot") == 0 && hasValue) {
+            options.saveSnapshot = argv[++i];
+        }
+        else if (strcmp(arg, "--record") == 0 && hasValue) {
+            options.recordPath = argv[++i];
+        }
+        else if (strcmp(arg, "--keyframe-interval") == 0 && hasValue) {
+            options.keyframeInterval = static_cast<unsigned>(strtoul(argv[++i], NULL, 10));
+        }
+        else if (strcmp(arg, "--replay") == 0 && hasValue) {
+            options.replayPath = argv[++i];
+        }
+        else if (strcmp(arg, "--replay-from") == 0 && hasValue) {
+            options.replayFrom = strtoull(argv[++i], NULL, 10);
+        }
+        else if (strcmp(arg, "--stats") == 0 && hasValue) {
+            options.statsPath = argv[++i];
+        }
+        else if (strcmp(arg, "--detect-period") == 0 && hasValue) {
+            options.maxPeriod = atoi(argv[++i]);
+        }
+        else if (strcmp(arg, "--on-period") == 0 && hasValue) {
+            options.onPeriod = argv[++i];
+            if (options.onPeriod != "report" && options.onPeriod != "stop" && options.onPeriod != "skip") {
+                std::cout << "Unknown period action: " << options.onPeriod << std::endl;
+                return false;
+            }
+        }
+        else if (strcmp(arg, "--census") == 0 && hasValue) {
+            options.censusPath = argv[++i];
+        }
+        else if (strcmp(arg, "--emissions") == 0 && hasValue) {
+            options.emissionsPath = argv[++i];
+        }
+        else if (strcmp(arg, "--soup-search") == 0 && hasValue) {
+            options.soupCount = strtoull(argv[++i], NULL, 10);
+        }
+        else if (strcmp(arg, "--soup-seed") == 0 && hasValue) {
+            options.soupSeed = strtoull(argv[++i], NULL, 10);
+        }
+        else if (strcmp(arg, "--sweep-seeds") == 0 && hasValue) {
+            options.sweepSeeds = atoi(argv[++i]);
+        }
+        else if (strcmp(arg, "--sweep-rules") == 0 && hasValue) {
+            options.sweepRules = argv[++i];
+        }
+        else if (strcmp(arg, "--sweep-densities") == 0 && hasValue) {
+            options.sweepDensities = argv[++i];
+        }
+        else if (strcmp(arg, "--sweep-out") == 0 && hasValue) {
+            options.sweepPath = argv[++i];
+        }
+        else if (strcmp(arg, "--volume") == 0 && hasValue) {
+            if (sscanf(argv[++i], "%dx%dx%d", &options.volumeWidth, &options.volumeHeight, &options.volumeDepth) != 3 ||
+                options.volumeWidth <= 0 || options.volumeHeight <= 0 || options.volumeDepth <= 0) {
+                std::cout << "Bad volume size: " << argv[i] << std::endl;
+                return false;
+            }
+        }
+        else if (strcmp(arg, "--volume-density") == 0 && hasValue) {
+            options.volumeDensity = atof(argv[++i]);
+        }
+        else if (strcmp(arg, "--checkpoint-dir") == 0 && hasValue) {
+            options.checkpointDir = argv[++i];
+        }
+        else if (strcmp(arg, "--checkpoint-every") == 0 && hasValue) {
+            options.checkpointEvery = strtoull(argv[++i], NULL, 10);
+        }
+        else if (strcmp(arg, "--checkpoint-seconds") == 0 && hasValue) {
+            options.checkpointSeconds = atof(argv[++i]);
+        }
+        else if (strcmp(arg, "--checkpoint-keep") == 0 && hasValue) {
+            options.checkpointKeep = atoi(argv[++i]);
+        }
+        else if (strcmp(arg, "--offscreen") == 0) {
+            options.offscreen = true;
+        }
+        else if (strcmp(arg, "--generations") == 0 && hasValue) {
+            options.maxGenerations = strtoull(argv[++i], NULL, 10);
+        }
+        else if (strcmp(arg, "--png") == 0 && hasValue) {
+            options.pngPattern = argv[++i];
+        }
+        else if (strcmp(arg, "--raw-pipe") == 0 && hasValue) {
+            options.rawPipeCommand = argv[++i];
+        }
+        else if (strcmp(arg, "--tile-view") == 0) {
+            options.tileView = true;
+        }
+        else if (strcmp(arg, "--tile-budget-mb") == 0 && hasValue) {
+            options.tileBudgetMB = strtoull(argv[++i], NULL, 10);
+        }
+        else {
+            if (strcmp(arg, "--help") != 0)
+                std::cout << "Unknown or incomplete option: " << arg << std::endl;
+            printUsage(argv[0]);
+            return false;
+        }
+    }
+
+    // The searches & the volume are 2-state modes of their own
+    if (!options.ruleTable.empty() && (options.soupCount > 0 || options.sweepSeeds > 0 || options.volumeWidth > 0)) {
+        std::cout << "--rule-table can't be used with --soup-search, --sweep-seeds or --volume" << std::endl;
+        return false;
+    }
+
+    // Offscreen runs need a way to end
+    if (options.offscreen && options.maxGenerations == 0) {
+        std::cout << "--offscreen requires --generations N" << std::endl;
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,206 @@
+#include <cstring>
+#include <iostream>
+#include <algorithm>
+#include <thread>
+#include <vector>
+#include "cell_list_file.h"
+#include "mapped_file.h"
+#include "bit_utils.h"
+
+namespace {
+
+const size_t MIN_CHUNK_BYTES = 1 << 20;     // Smaller files aren't worth the threads
+
+// Splits [data, data + size) into up to one chunk per hardware thread, each starting at a line start.
+// Returns the chunk boundaries (chunks + 1 pointers)
+std::vector<const char*> splitChunks(const char* data, size_t size)
+{
+    size_t threads = std::max(1u, std::thread::hardware_concurrency());
+    size_t count = std::max<size_t>(1, std::min(threads, size / MIN_CHUNK_BYTES));
+
+    std::vector<const char*> bounds(1, data);
+    const char* end = data + size;
+    for (size_t i = 1; i < count; i++) {
+        const char* p = std::max(data + size / count * i, bounds.back());
+        const char* eol = static_cast<const char*>(memchr(p, '\n', end - p));
+        p = eol ? eol + 1 : end;
+        if (p > bounds.back() && p < end) bounds.push_back(p);
+    }
+    bounds.push_back(end);
+    return bounds;
+}
+
+// Runs fn(i) for every chunk, one thread each
+template <typename Fn>
+void forEachChunk(size_t chunks, Fn fn)
+{
+    std::vector<std::thread> threads;
+    for (size_t i = 1; i < chunks; i++) threads.emplace_back(fn, i);
+    fn(0);
+    for (std::thread& t : threads) t.join();
+}
+
+inline const char* lineEnd(const char* p, const char* end)
+{
+    const char* eol = static_cast<const char*>(memchr(p, '\n', end - p));
+    return eol ? eol : end;
+}
+
+// Plaintext rows in [p, end); visit(x, row) for each live cell. Returns the number of rows
+template <typename Visit>
+long long parsePlaintext(const char* p, const char* end, long long row, Visit visit)
+{
+    long long first = row;
+    while (p < end) {
+        const char* eol = lineEnd(p, end);
+        if (*p != '!') {
+            for (const char* c = p; c < eol; c++)
+                if (*c == 'O' || *c == '*') visit(static_cast<long long>(c - p), row);
+            row++;
+        }
+        p = eol < end ? eol + 1 : end;
+    }
+    return row - first;
+}
+
+inline bool parseInt(const char*& p, const char* end, long long& value)
+{
+    while (p < end && (*p == ' ' || *p == '\t')) p++;
+    bool negative = p < end && *p == '-';
+    if (p < end && (*p == '-' || *p == '+')) p++;
+    if (p >= end || *p < '0' || *p > '9') return false;
+    value = 0;
+    while (p < end && *p >= '0' && *p <= '9') value = value * 10 + (*p++ - '0');
+    if (negative) value = -value;
+    return true;
+}
+
+// Life 1.06 lines in [p, end); visit(x, y) for each cell. Returns false on a malformed line
+template <typename Visit>
+bool parseLife106(const char* p, const char* end, Visit visit)
+{
+    while (p < end) {
+        const char* eol = lineEnd(p, end);
+        const char* c = p;
+        while (c < eol && (*c == ' ' || *c == '\t' || *c == '\r')) c++;
+        if (c < eol && *c != '#') {
+            long long x, y;
+            if (!parseInt(c, eol, x) || !parseInt(c, eol, y)) return false;
+            visit(x, y);
+        }
+        p = eol < end ? eol + 1 : end;
+    }
+    return true;
+}
+
+struct ChunkResult {
+    CellListFile::Info box;
+    long long rows = 0;
+    bool ok = true;
+};
+
+void addToBox(CellListFile::Info& box, long long x, long long y)
+{
+    if (box.cells == 0) {
+        box.minX = box.maxX = x;
+        box.minY = box.maxY = y;
+    }
+    else {
+        box.minX = std::min(box.minX, x);   box.maxX = std::max(box.maxX, x);
+        box.minY = std::min(box.minY, y);   box.maxY = std::max(box.maxY, y);
+    }
+    box.cells++;
+}
+
+// Runs the format's parser over every chunk in parallel. Plaintext rows are numbered across chunks,
+// which takes a (cheap) row counting pass first
+template <typename MakeVisitor>
+bool parseChunks(const MappedFile& file, CellListFile::Format format, MakeVisitor makeVisitor)
+{
+    const char* data = reinterpret_cast<const char*>(file.data());
+    std::vector<const char*> bounds = splitChunks(data, file.size());
+    size_t chunks = bounds.size() - 1;
+    std::vector<char> ok(chunks, 1);
+
+    if (format == CellListFile::PLAINTEXT) {
+        std::vector<long long> firstRow(chunks + 1, 0);
+        forEachChunk(chunks, [&](size_t i) {
+            firstRow[i + 1] = parsePlaintext(bounds[i], bounds[i + 1], 0, [](long long, long long) {});
+        });
+        for (size_t i = 0; i < chunks; i++) firstRow[i + 1] += firstRow[i];
+        forEachChunk(chunks, [&](size_t i) { parsePlaintext(bounds[i], bounds[i + 1], firstRow[i], makeVisitor(i)); });
+    }
+    else {
+        forEachChunk(chunks, [&](size_t i) { ok[i] = parseLife106(bounds[i], bounds[i + 1], makeVisitor(i)); });
+    }
+    return std::find(ok.begin(), ok.end(), 0) == ok.end();
+}
+
+size_t chunkCount(const MappedFile& file)
+{
+    return splitChunks(reinterpret_cast<const char*>(file.data()), file.size()).size() - 1;
+}
+
+}
+
+bool CellListFile::scan(const std::string& path, Format format, Info& info)
+{
+    MappedFile file;
+    if (!file.open(path)) return false;
+
+    std::vector<Info> boxes(chunkCount(file));
+    bool ok = parseChunks(file, format, [&](size_t i) {
+        return [&box = boxes[i]](long long x, long long y) { addToBox(box, x, y); };
+    });
+    if (!ok) {
+        std::cout << "ERROR::CELL_LIST::BAD_LINE: " << path << std::endl;
+        return false;
+    }
+
+    info = Info();
+    for (const Info& box : boxes) {
+        if (box.cells == 0) continue;
+        unsigned long long cells = info.cells;
+        addToBox(info, box.minX, box.minY);
+        addToBox(info, box.maxX, box.maxY);
+        info.cells = cells + box.cells;
+    }
+    return true;
+}
+
+bool CellListFile::load(const std::string& path, Format format, const Info& info, PackedGrid& grid, int offsetX, int offsetY)
+{
+    MappedFile file;
+    if (!file.open(path)) return false;
+
+    const long long width = grid.width(), height = grid.height();
+    return parseChunks(file, format, [&](size_t) {
+        return [&](long long x, long long y) {
+            long long gx = offsetX + x - info.minX, gy = offsetY + info.maxY - y;
+            if (gx < 0 || gx >= width || gy < 0 || gy >= height) return;
+            // Life 1.06 lines can land anywhere, so words are shared between threads
+            atomicOr64(&grid.row(static_cast<int>(gy))[gx >> 6], 1ull << (gx & 63));
+        };
+    });
+}
+
+bool CellListFile::load(const std::string& path, Format format, const Info& info, TileStore& store, int64_t offsetX, int64_t offsetY)
+{
+    MappedFile file;
+    if (!file.open(path)) return false;
+
+    // Each chunk fills its own store; they're merged at the end, & only if every chunk parsed, so a bad
+    // file leaves 'store' as it was
+    std::vector<TileStore> partial(chunkCount(file));
+    bool ok = parseChunks(file, format, [&](size_t i) {
+        return [&, &part = partial[i]](long long x, long long y) {
+            part.set(offsetX + x - info.minX, offsetY + info.maxY - y, true);
+        };
+    });
+    if (!ok) {
+        std::cout << "ERROR::CELL_LIST::BAD_LINE: " << path << std::endl;
+        return false;
+    }
+    for (const TileStore& part : partial) store.merge(part);
+    return true;
+}
@@ -0,0 +1,158 @@
+#include <cstdio>
+#include <iostream>
+#include <algorithm>
+#include <filesystem>
+#include "checkpointer.h"
+#include "snapshot_file.h"
+
+namespace {
+
+// Checkpoints in 'directory' as (generation, path), oldest first
+std::vector<std::pair<unsigned long long, std::string>> listCheckpoints(const std::string& directory)
+{
+    std::vector<std::pair<unsigned long long, std::string>> found;
+    std::error_code error;
+    for (const auto& entry : std::filesystem::directory_iterator(directory, error)) {
+        std::string name = entry.path().filename().string();
+        unsigned long long generation;
+        char tail[8] = "";
+        if (sscanf(name.c_str(), "checkpoint_%llu.%7s", &generation, tail) == 2 && std::string(tail) == "snap")
+            found.push_back({ generation, entry.path().string() });
+    }
+    std::sort(found.begin(), found.end());
+    return found;
+}
+
+}
+
+Checkpointer::Checkpointer(const std::string& directory, unsigned long long everyGenerations, double everySeconds, int keep)
+    : directory(directory), everyGenerations(everyGenerations), everySeconds(everySeconds), keep(std::max(keep, 1))
+{
+}
+
+bool Checkpointer::start(int width, int height, const LifeRule& rule, unsigned long long generation)
+{
+    std::error_code error;
+    std::filesystem::create_directories(directory, error);
+    if (error) {
+        std::cout << "ERROR::CHECKPOINT::CANT_CREATE_DIRECTORY: " << directory << std::endl;
+        return false;
+    }
+
+    this->width = width;
+    this->height = height;
+    this->rule = rule;
+    lastGeneration = generation;
+    lastTime = std::chrono::steady_clock::now();
+    spare.resize(static_cast<size_t>(width) * height);
+
+    writer = std::thread(&Checkpointer::writerLoop, this);
+    return true;
+}
+
+bool Checkpointer::due(unsigned long long generation) const
+{
+    if (busy || !writer.joinable()) return false;
+    if (everyGenerations != 0 && generation - lastGeneration >= everyGenerations) return true;
+    if (everySeconds > 0.0 && std::chrono::duration<double>(std::chrono::steady_clock::now() - lastTime).count() >= everySeconds) return true;
+    return false;
+}
+
+bool Checkpointer::submit(std::vector<uint32_t>& cells, unsigned long long generation)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (busy || !writer.joinable()) return false;
+        pending.swap(cells);
+        cells.swap(spare);      // The spare becomes the caller's buffer; 'spare' is empty until the writer returns one
+        pendingGeneration = generation;
+        busy = true;
+    }
+    cv.notify_all();
+
+    lastGeneration = generation;
+    lastTime = std::chrono::steady_clock::now();
+    return true;
+}
+
+bool Checkpointer::submit(const uint32_t* cells, unsigned long long generation)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (busy || !writer.joinable()) return false;
+        pending.swap(spare);    // 'spare' is empty until the writer returns it
+        pending.assign(cells, cells + static_cast<size_t>(width) * height);
+        pendingGeneration = generation;
+        busy = true;
+    }
+    cv.notify_all();
+
+    lastGeneration = generation;
+    lastTime = std::chrono::steady_clock::now();
+    return true;
+}
+
+void Checkpointer::finish()
+{
+    if (!writer.joinable()) return;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    cv.notify_all();
+    writer.join();
+}
+
+void Checkpointer::writerLoop()
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        cv.wait(lock, [this] { return stopping || busy; });
+        if (!busy) return;  // Stopping with nothing in flight
+
+        std::vector<uint32_t> cells;
+        cells.swap(pending);
+        unsigned long long generation = pendingGeneration;
+        lock.unlock();
+
+        write(cells, generation);
+
+        lock.lock();
+        spare.swap(cells);
+        busy = false;
+    }
+}
+
+void Checkpointer::write(const std::vector<uint32_t>& cells, unsigned long long generation)
+{
+    PackedGrid board;
+    board.fromCells(cells, width, height);
+
+    char name[64];
+    snprintf(name, sizeof(name), "checkpoint_%012llu.snap", generation);
+    std::string path = (std::filesystem::path(directory) / name).string();
+    if (!SnapshotFile::save(path, board.view(), rule, generation, SnapshotFile::BOUNDED, true)) return;
+
+    _written++;
+    prune();
+}
+
+void Checkpointer::prune()
+{
+    auto found = listCheckpoints(directory);
+    for (size_t i = 0; i + keep < found.size(); i++) {
+        std::error_code error;
+        std::filesystem::remove(found[i].second, error);
+    }
+}
+
+std::string Checkpointer::findLatest(const std::string& directory)
+{
+    auto found = listCheckpoints(directory);
+    for (auto it = found.rbegin(); it != found.rend(); ++it) {
+        SnapshotFile snapshot;
+        if (snapshot.open(it->second) && snapshot.verifyChecksum()) return it->second;
+        std::cout << "Skipping damaged checkpoint: " << it->second << std::endl;
+    }
+    return "";
+}
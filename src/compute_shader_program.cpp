@@ -1,10 +1,10 @@
 #include "compute_shader_program.h"
 
-ComputeShaderProgram::ComputeShaderProgram(const char* computePath)
+ComputeShaderProgram::ComputeShaderProgram(const char* computePath, const std::string& prelude)
 {
     // 1. retrieve the computer shader source code from file path and compile
     unsigned computeShader = glCreateShader(GL_COMPUTE_SHADER);
-    readAndCompileShaderFile(computePath, computeShader, "COMPUTE");
+    readAndCompileShaderFile(computePath, computeShader, "COMPUTE", prelude);
     checkCompileErrors(computeShader, "COMPUTE");   // print compile errors if any
 
     // 2. create shader Program
@@ -0,0 +1,162 @@
+#include <algorithm>
+#include <thread>
+#include "continuous_engine.h"
+
+namespace {
+
+// An FFT's cost per value is a few times a neighbour count's, so bands can be smaller
+const size_t MIN_VALUES_PER_THREAD = 1 << 14;
+
+}
+
+ContinuousEngine::ContinuousEngine(int threads)
+    : threads(threads > 0 ? threads : static_cast<int>(std::max(1u, std::thread::hardware_concurrency())))
+{
+}
+
+void ContinuousEngine::setRule(const ContinuousRule& rule)
+{
+    this->rule = rule;
+    if (_width > 0) plan();
+}
+
+void ContinuousEngine::loadCells(const std::vector<uint32_t>& cells, int width, int height)
+{
+    _width = width;
+    _height = height;
+    field.resize(static_cast<size_t>(width) * height);
+    for (size_t i = 0; i < field.size(); i++) field[i] = toValue(cells[i]);
+
+    plan();
+}
+
+void ContinuousEngine::toCells(std::vector<uint32_t>& cells) const
+{
+    cells.resize(field.size());
+    for (size_t i = 0; i < field.size(); i++) cells[i] = toLevel(field[i]);
+}
+
+void ContinuousEngine::stamp(const PackedGridView& pattern, int x, int y, StampMode mode)
+{
+    int x0 = std::max(x, 0), x1 = std::min(x + pattern.width, _width);
+    int y0 = std::max(y, 0), y1 = std::min(y + pattern.height, _height);
+    for (int j = y0; j < y1; j++)
+        for (int i = x0; i < x1; i++) {
+            float& value = field[static_cast<size_t>(j) * _width + i];
+            bool cell = pattern.get(i - x, j - y);
+            if (cell || mode == STAMP_REPLACE) value = stampState(value > 0.0f, cell, mode) ? 1.0f : 0.0f;
+        }
+}
+
+// Sizes the padded board for the rule's reach & works out the kernels' spectra: the kernels laid out as the
+// board is, centred on (0, 0) & wrapped around the padded board, then transformed as step() transforms it
+void ContinuousEngine::plan()
+{
+    // A potential reaches kernelRadius() cells, so that much padding keeps the wrapped part off the board
+    const int r = rule.kernelRadius(), size = 2 * r + 1;
+    int px = Fft::nextPowerOfTwo(std::max(_width + r, 2)), py = Fft::nextPowerOfTwo(std::max(_height + r, 2));
+    if (px != paddedX || py != paddedY) {
+        paddedX = px;
+        paddedY = py;
+        bins = paddedX / 2 + 1;
+        rowFft = Fft(paddedX);
+        columnFft = Fft(paddedY);
+    }
+    spectrum.assign(static_cast<size_t>(bins) * paddedY, Complex());
+
+    const float scale = 1.0f / (static_cast<float>(paddedX) * paddedY);
+    std::vector<float> row(paddedX);
+    std::vector<Complex> rowBins(bins), scratch(paddedX / 2);
+
+    kernelSpectra.assign(rule.kernelCount(), std::vector<Complex>(static_cast<size_t>(bins) * paddedY));
+    potentials.assign(rule.kernelCount(), std::vector<Complex>(static_cast<size_t>(bins) * _height));
+    for (int k = 0; k < rule.kernelCount(); k++) {
+        std::vector<float> weights = rule.kernel(k);
+        std::vector<Complex>& spectrumK = kernelSpectra[k];
+        for (int y = 0; y < paddedY; y++) {
+            std::fill(row.begin(), row.end(), 0.0f);
+            for (int dy = -r; dy <= r; dy++) {
+                if (((dy % paddedY) + paddedY) % paddedY != y) continue;
+                for (int dx = -r; dx <= r; dx++)
+                    row[((dx % paddedX) + paddedX) % paddedX] += weights[static_cast<size_t>(dy + r) * size + dx + r];
+            }
+            rowFft.forwardReal(row.data(), rowBins.data(), scratch.data());
+            for (int b = 0; b < bins; b++) spectrumK[static_cast<size_t>(b) * paddedY + y] = rowBins[b];
+        }
+        for (int b = 0; b < bins; b++) {
+            Complex* col = spectrumK.data() + static_cast<size_t>(b) * paddedY;
+            columnFft.transform(col, false);
+            for (int y = 0; y < paddedY; y++) col[y] *= scale;
+        }
+    }
+}
+
+void ContinuousEngine::step()
+{
+    runBands(&ContinuousEngine::forwardRows, _height, static_cast<size_t>(paddedX) * _height);
+    runBands(&ContinuousEngine::convolveColumns, bins, static_cast<size_t>(paddedX) * paddedY);
+    runBands(&ContinuousEngine::updateRows, _height, static_cast<size_t>(paddedX) * _height);
+}
+
+// Splits [0, count) into bands, one per thread, where there's enough work ('values') for them
+void ContinuousEngine::runBands(void (ContinuousEngine::*pass)(int, int), int count, size_t values)
+{
+    int bands = static_cast<int>(std::min<size_t>(threads, std::max<size_t>(1, values / MIN_VALUES_PER_THREAD)));
+    bands = std::max(1, std::min(bands, count));
+
+    std::vector<std::thread> workers;
+    for (int b = 1; b < bands; b++)
+        workers.emplace_back(pass, this, count * b / bands, count * (b + 1) / bands);
+    (this->*pass)(0, count / bands);
+    for (std::thread& t : workers) t.join();
+}
+
+void ContinuousEngine::forwardRows(int y0, int y1)
+{
+    std::vector<float> row(paddedX, 0.0f);      // Past the board's width stays 0
+    std::vector<Complex> rowBins(bins), scratch(paddedX / 2);
+    for (int y = y0; y < y1; y++) {
+        std::copy_n(field.begin() + static_cast<size_t>(y) * _width, _width, row.begin());
+        rowFft.forwardReal(row.data(), rowBins.data(), scratch.data());
+        for (int b = 0; b < bins; b++) spectrum[static_cast<size_t>(b) * paddedY + y] = rowBins[b];
+    }
+}
+
+void ContinuousEngine::convolveColumns(int x0, int x1)
+{
+    std::vector<Complex> column(paddedY), product(paddedY);
+    for (int b = x0; b < x1; b++) {
+        const size_t offset = static_cast<size_t>(b) * paddedY;
+        std::copy_n(spectrum.begin() + offset, paddedY, column.begin());
+        columnFft.transform(column.data(), false);
+
+        for (size_t k = 0; k < kernelSpectra.size(); k++) {
+            const Complex* kernel = kernelSpectra[k].data() + offset;
+            for (int y = 0; y < paddedY; y++) {
+                Complex a = column[y], w = kernel[y];
+                product[y] = Complex(a.real() * w.real() - a.imag() * w.imag(), a.real() * w.imag() + a.imag() * w.real());
+            }
+            columnFft.transform(product.data(), true);
+            std::copy_n(product.begin(), _height, potentials[k].begin() + static_cast<size_t>(b) * _height);
+        }
+    }
+}
+
+void ContinuousEngine::updateRows(int y0, int y1)
+{
+    const int kernels = rule.kernelCount();
+    std::vector<Complex> rowBins(bins), scratch(paddedX / 2);
+    std::vector<float> rows(static_cast<size_t>(kernels) * paddedX);
+    float u[2];
+    for (int y = y0; y < y1; y++) {
+        for (int k = 0; k < kernels; k++) {
+            for (int b = 0; b < bins; b++) rowBins[b] = potentials[k][static_cast<size_t>(b) * _height + y];
+            rowFft.inverseReal(rowBins.data(), rows.data() + static_cast<size_t>(k) * paddedX, scratch.data());
+        }
+        float* cells = field.data() + static_cast<size_t>(y) * _width;
+        for (int x = 0; x < _width; x++) {
+            for (int k = 0; k < kernels; k++) u[k] = rows[static_cast<size_t>(k) * paddedX + x];
+            cells[x] = rule.next(cells[x], u);
+        }
+    }
+}
@@ -0,0 +1,197 @@
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdlib>
+#include <sstream>
+#include "continuous_rule.h"
+
+namespace {
+
+// A decimal number filling 'text', or a fraction "a/b"
+bool parseNumber(const std::string& text, float& value)
+{
+    size_t slash = text.find('/');
+    if (slash != std::string::npos) {
+        float num, den;
+        if (!parseNumber(text.substr(0, slash), num) || !parseNumber(text.substr(slash + 1), den) || den == 0.0f) return false;
+        value = num / den;
+        return true;
+    }
+    if (text.empty()) return false;
+    char* end = nullptr;
+    value = strtof(text.c_str(), &end);
+    return *end == '\0' && std::isfinite(value);
+}
+
+bool parseShape(const std::string& text, ContinuousRule::Shape& shape)
+{
+    if (text == "exp" || text == "gauss") shape = ContinuousRule::EXPONENTIAL;
+    else if (text == "poly") shape = ContinuousRule::POLYNOMIAL;
+    else if (text == "step") shape = ContinuousRule::STEP;
+    else return false;
+    return true;
+}
+
+std::string lower(const std::string& text)
+{
+    std::string out = text;
+    for (char& c : out) c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+    return out;
+}
+
+// Lenia's kernel core: a bump over r in [0, 1]
+float core(float r, ContinuousRule::Shape shape)
+{
+    if (r <= 0.0f || r >= 1.0f) return 0.0f;
+    switch (shape) {
+        case ContinuousRule::EXPONENTIAL:   return std::exp(4.0f - 1.0f / (r * (1.0f - r)));
+        case ContinuousRule::POLYNOMIAL:    return std::pow(4.0f * r * (1.0f - r), 4.0f);
+        default:                            return r >= 0.25f && r <= 0.75f ? 1.0f : 0.0f;
+    }
+}
+
+float sigmoid(float x, float a, float alpha)
+{
+    return 1.0f / (1.0f + std::exp(-(x - a) * 4.0f / alpha));
+}
+
+}
+
+bool ContinuousRule::parse(const std::string& text)
+{
+    size_t colon = text.find(':');
+    if (colon == std::string::npos) return false;
+    ContinuousRule rule;
+    std::string name = lower(text.substr(0, colon));
+    if (name == "lenia") rule.kind = LENIA;
+    else if (name == "smoothlife") rule.kind = SMOOTH_LIFE;
+    else return false;
+
+    size_t pos = colon + 1;
+    while (pos < text.size()) {
+        size_t comma = text.find(',', pos);
+        if (comma == std::string::npos) comma = text.size();
+        std::string token;
+        for (size_t i = pos; i < comma; i++)
+            if (text[i] != ' ') token += text[i];
+        pos = comma + 1;
+
+        size_t equals = token.find('=');
+        if (equals == std::string::npos) return false;
+        std::string key = token.substr(0, equals), value = token.substr(equals + 1);
+        float number = 0.0f;
+        bool numeric = parseNumber(value, number);
+
+        if (rule.kind == LENIA) {
+            if (key == "R" || key == "r") {
+                if (!numeric || number < 1.0f || number > MAX_RADIUS || number != std::floor(number)) return false;
+                rule.radius = static_cast<int>(number);
+            }
+            else if (key == "T") { if (!numeric || number <= 0.0f) return false; rule.timeSteps = number; }
+            else if (key == "m") { if (!numeric) return false; rule.growthCentre = number; }
+            else if (key == "s") { if (!numeric || number <= 0.0f) return false; rule.growthWidth = number; }
+            else if (key == "b") {
+                rule.shells.clear();
+                std::stringstream peaks(value);
+                std::string peak;
+                while (std::getline(peaks, peak, ';')) {
+                    if (!parseNumber(peak, number) || number < 0.0f) return false;
+                    rule.shells.push_back(number);
+                }
+                if (rule.shells.empty() || rule.shells.size() > MAX_SHELLS) return false;
+            }
+            else if (key == "kernel") { if (!parseShape(value, rule.kernelShape)) return false; }
+            else if (key == "growth") { if (!parseShape(value, rule.growthShape)) return false; }
+            else return false;
+        }
+        else {
+            float* target = key == "ri" ? &rule.innerRadius : key == "ra" ? &rule.outerRadius :
+                            key == "b1" ? &rule.birthLow : key == "b2" ? &rule.birthHigh :
+                            key == "d1" ? &rule.deathLow : key == "d2" ? &rule.deathHigh :
+                            key == "an" ? &rule.alphaN : key == "am" ? &rule.alphaM : key == "dt" ? &rule.dt : nullptr;
+            if (!target || !numeric) return false;
+            *target = number;
+        }
+    }
+    if (rule.kind == SMOOTH_LIFE && (rule.innerRadius <= 0.0f || rule.outerRadius <= rule.innerRadius || rule.outerRadius > MAX_RADIUS - 1 ||
+                                     rule.alphaN <= 0.0f || rule.alphaM <= 0.0f || rule.dt < 0.0f || rule.dt > 1.0f))
+        return false;
+
+    *this = rule;
+    return true;
+}
+
+std::string ContinuousRule::toString() const
+{
+    std::ostringstream out;
+    if (kind == LENIA) {
+        static const char* SHAPES[] = { "exp", "poly", "step" };
+        static const char* GROWTHS[] = { "gauss", "poly", "step" };
+        out << "Lenia:R=" << radius << ",T=" << timeSteps << ",m=" << growthCentre << ",s=" << growthWidth << ",b=";
+        for (size_t i = 0; i < shells.size(); i++) out << (i ? ";" : "") << shells[i];
+        out << ",kernel=" << SHAPES[kernelShape] << ",growth=" << GROWTHS[growthShape];
+    }
+    else {
+        out << "SmoothLife:ri=" << innerRadius << ",ra=" << outerRadius << ",b1=" << birthLow << ",b2=" << birthHigh
+            << ",d1=" << deathLow << ",d2=" << deathHigh << ",an=" << alphaN << ",am=" << alphaM << ",dt=" << dt;
+    }
+    return out.str();
+}
+
+int ContinuousRule::kernelRadius() const
+{
+    // SmoothLife's discs are anti-aliased over half a cell past their radius
+    return kind == LENIA ? radius : static_cast<int>(std::ceil(outerRadius + 0.5f));
+}
+
+std::vector<float> ContinuousRule::kernel(int k) const
+{
+    const int r = kernelRadius(), size = 2 * r + 1;
+    std::vector<float> weights(static_cast<size_t>(size) * size);
+    double total = 0.0;
+    for (int dy = -r; dy <= r; dy++)
+        for (int dx = -r; dx <= r; dx++) {
+            float d = std::sqrt(static_cast<float>(dx * dx + dy * dy)), w;
+            if (kind == LENIA) {
+                // Shell i covers distances [i, i + 1) * R / shells, each a core bump scaled by its peak
+                float br = d / radius * shells.size();
+                size_t shell = static_cast<size_t>(br);
+                w = shell < shells.size() ? shells[shell] * core(br - shell, kernelShape) : 0.0f;
+            }
+            else {
+                float disc = std::min(std::max(innerRadius + 0.5f - d, 0.0f), 1.0f);
+                w = k == 0 ? disc : std::min(std::max(outerRadius + 0.5f - d, 0.0f), 1.0f) - disc;
+            }
+            weights[static_cast<size_t>(dy + r) * size + dx + r] = w;
+            total += w;
+        }
+    if (total > 0.0)
+        for (float& w : weights) w = static_cast<float>(w / total);
+    return weights;
+}
+
+float ContinuousRule::growth(float u) const
+{
+    float d = u - growthCentre;
+    switch (growthShape) {
+        case EXPONENTIAL:   return 2.0f * std::exp(-d * d / (2.0f * growthWidth * growthWidth)) - 1.0f;
+        case POLYNOMIAL:    return 2.0f * std::pow(std::max(0.0f, 1.0f - d * d / (9.0f * growthWidth * growthWidth)), 4.0f) - 1.0f;
+        default:            return std::abs(d) <= growthWidth ? 1.0f : -1.0f;
+    }
+}
+
+float ContinuousRule::smoothLifeNext(float value, float n, float m) const
+{
+    float aliveness = sigmoid(m, 0.5f, alphaM);
+    float low = birthLow * (1.0f - aliveness) + deathLow * aliveness;
+    float high = birthHigh * (1.0f - aliveness) + deathHigh * aliveness;
+    float s = sigmoid(n, low, alphaN) * (1.0f - sigmoid(n, high, alphaN));
+    if (dt == 0.0f) return s;
+    return std::min(std::max(value + dt * (2.0f * s - 1.0f), 0.0f), 1.0f);
+}
+
+float ContinuousRule::next(float value, const float* u) const
+{
+    if (kind == SMOOTH_LIFE) return smoothLifeNext(value, u[1], u[0]);
+    return std::min(std::max(value + growth(u[0]) / timeSteps, 0.0f), 1.0f);
+}
@@ -0,0 +1,203 @@
+#include <algorithm>
+#include <thread>
+#include "cpu_life_engine.h"
+#include "bit_utils.h"
+#include "cell_hash.h"
+
+namespace {
+
+const size_t MIN_CELLS_PER_THREAD = 1 << 18;
+
+}
+
+CpuLifeEngine::CpuLifeEngine(int threads)
+    : threads(threads > 0 ? threads : static_cast<int>(std::max(1u, std::thread::hardware_concurrency())))
+{
+    setRule(LifeRule());
+}
+
+void CpuLifeEngine::setRule(const LifeRule& rule)
+{
+    birthMask = rule.birthMask;
+    surviveMask = rule.surviveMask;
+    neighbourhood = rule.neighbourhood;
+    isotropic = rule.isotropic;
+    if (isotropic) diagram.build(rule.table());
+}
+
+void CpuLifeEngine::load(const PackedGrid& board)
+{
+    current.assign(board.view());
+    next.resize(board.width(), board.height());
+    zeroRow.assign(current.wordsPerRow(), 0);
+    resetTiles();
+}
+
+void CpuLifeEngine::loadCells(const std::vector<uint32_t>& cells, int width, int height)
+{
+    current.fromCells(cells, width, height);
+    next.resize(width, height);
+    zeroRow.assign(current.wordsPerRow(), 0);
+    resetTiles();
+}
+
+void CpuLifeEngine::stamp(const PackedGridView& pattern, int x, int y, StampMode mode)
+{
+    stampGrid(current, pattern, x, y, mode);
+    int tileRows = (current.height() + TILE_ROWS - 1) / TILE_ROWS;
+    hashTiles(current, std::clamp(y / TILE_ROWS, 0, tileRows), std::clamp((y + pattern.height + TILE_ROWS - 1) / TILE_ROWS, 0, tileRows), false);
+}
+
+uint64_t CpuLifeEngine::hash() const
+{
+    TileHash total;
+    for (const TileHash& tile : tileHashes) {
+        total.lo += tile.lo;
+        total.hi += tile.hi;
+    }
+    return (static_cast<uint64_t>(total.hi) << 32) | total.lo;
+}
+
+void CpuLifeEngine::resetTiles()
+{
+    int tileRows = (current.height() + TILE_ROWS - 1) / TILE_ROWS;
+    tileHashes.assign(tileRows * current.usedWordsPerRow(), TileHash());
+    tileChanged.assign(tileHashes.size(), 0);
+    hashTiles(current, 0, tileRows, false);
+}
+
+void CpuLifeEngine::hashTiles(const PackedGrid& grid, int tileY0, int tileY1, bool changedOnly)
+{
+    const size_t words = grid.usedWordsPerRow();
+    for (int ty = tileY0; ty < tileY1; ty++) {
+        for (size_t w = 0; w < words; w++) {
+            size_t tile = ty * words + w;
+            if (changedOnly && !tileChanged[tile]) continue;
+            tileChanged[tile] = 0;
+
+            TileHash sum;
+            int y1 = std::min(grid.height(), (ty + 1) * TILE_ROWS);
+            for (int y = ty * TILE_ROWS; y < y1; y++) {
+                for (uint64_t bits = grid.row(y)[w]; bits; bits &= bits - 1) {
+                    uint32_t lo, hi;
+                    cellHash(static_cast<uint32_t>(w * 64 + countTrailingZeros64(bits)), static_cast<uint32_t>(y), lo, hi);
+                    sum.lo += lo;
+                    sum.hi += hi;
+                }
+            }
+            tileHashes[tile] = sum;
+        }
+    }
+}
+
+void CpuLifeEngine::step(GenerationStats* stats)
+{
+    const int height = current.height();
+    size_t cells = static_cast<size_t>(current.width()) * height;
+    int bands = static_cast<int>(std::min<size_t>(threads, std::max<size_t>(1, cells / MIN_CELLS_PER_THREAD)));
+    bands = std::max(1, std::min(bands, height));
+
+    // Band edges fall on tile rows, so each tile's changed flag & hash belong to one band
+    auto bandStart = [&](int b) { return b == bands ? height : (height * b / bands) / TILE_ROWS * TILE_ROWS; };
+
+    std::vector<GenerationStats> bandStats(bands);
+    std::vector<std::thread> workers;
+    for (int b = 1; b < bands; b++)
+        workers.emplace_back(&CpuLifeEngine::stepRows, this, bandStart(b), bandStart(b + 1), std::ref(bandStats[b]));
+    stepRows(0, bandStart(1), bandStats[0]);
+    for (std::thread& t : workers) t.join();
+
+    std::swap(current, next);
+
+    if (stats) {
+        GenerationStats total;
+        for (const GenerationStats& part : bandStats) addStats(total, part);
+        total.generation = stats->generation;
+        total.hash = hash();
+        *stats = total;
+    }
+}
+
+void CpuLifeEngine::stepRows(int y0, int y1, GenerationStats& stats)
+{
+    const int width = current.width(), height = current.height();
+    const size_t words = current.usedWordsPerRow();
+    const uint64_t lastMask = (width & 63) ? ~0ull >> (64 - (width & 63)) : ~0ull;
+
+    for (int y = y0; y < y1; y++) {
+        const uint64_t* rows[3] = {
+            y > 0 ? current.row(y - 1) : zeroRow.data(),
+            current.row(y),
+            y + 1 < height ? current.row(y + 1) : zeroRow.data()
+        };
+        uint64_t* out = next.row(y);
+        int firstWord = -1, lastWord = -1;
+
+        for (size_t w = 0; w < words; w++) {
+            uint64_t west[3], centre[3], east[3];
+            for (int r = 0; r < 3; r++) {
+                const uint64_t* row = rows[r];
+                centre[r] = row[w];
+                west[r] = (centre[r] << 1) | (w > 0 ? row[w - 1] >> 63 : 0);     // Bit x = cell x-1
+                east[r] = (centre[r] >> 1) | (w + 1 < words ? row[w + 1] << 63 : 0);
+            }
+
+            uint64_t alive = rows[1][w], result;
+            if (isotropic) {
+                // Table index order: N, NE, E, SE, S, SW, W, NW (row 0 is y-1), then the cell
+                const uint64_t in[9] = { centre[0], east[0], east[1], east[2], centre[2], west[2], west[1], west[0], alive };
+                result = diagram.evaluate(in);
+            }
+            else if (neighbourhood == LifeRule::HEXAGONAL) {
+                // Golly's NE & SW are (x+1, y+1) & (x-1, y-1), north being +y once RLE rows are flipped. The rest,
+                // (x, y-1) (x+1, y-1) (x-1, y) | (x+1, y) (x, y+1) (x-1, y+1): two full adders, then their sums & carries added
+                uint64_t sumA, carryA, sumB, carryB;
+                fullAdd(centre[0], east[0], west[1], sumA, carryA);
+                fullAdd(east[1], centre[2], west[2], sumB, carryB);
+                uint64_t s0 = sumA ^ sumB, k = sumA & sumB;
+                uint64_t s1 = carryA ^ carryB ^ k, s2 = (carryA & carryB) | (k & (carryA ^ carryB));
+                result = (alive & countIn(surviveMask, s0, s1, s2, 0)) | (~alive & countIn(birthMask, s0, s1, s2, 0));
+            }
+            else if (neighbourhood == LifeRule::VON_NEUMANN) {
+                // N, W, E in a full adder, then S
+                uint64_t sum, carry;
+                fullAdd(centre[0], west[1], east[1], sum, carry);
+                uint64_t s0 = sum ^ centre[2], k = sum & centre[2];
+                uint64_t s1 = carry ^ k, s2 = carry & k;
+                result = (alive & countIn(surviveMask, s0, s1, s2, 0)) | (~alive & countIn(birthMask, s0, s1, s2, 0));
+            }
+            else {
+                uint64_t s0 = 0, s1 = 0, s2 = 0, s3 = 0;
+                for (int r = 0; r < 3; r++) {
+                    addPlane(west[r], s0, s1, s2, s3);
+                    addPlane(east[r], s0, s1, s2, s3);
+                    if (r != 1) addPlane(centre[r], s0, s1, s2, s3);
+                }
+                result = (alive & countIn(surviveMask, s0, s1, s2, s3)) | (~alive & countIn(birthMask, s0, s1, s2, s3));
+            }
+            if (w + 1 == words) result &= lastMask;     // Padding bits stay dead
+            out[w] = result;
+
+            if (result != alive) tileChanged[(y / TILE_ROWS) * words + w] = 1;
+            stats.population += popcount64(result);
+            stats.births += popcount64(result & ~alive);
+            stats.deaths += popcount64(alive & ~result);
+            if (result) {
+                if (firstWord < 0) firstWord = static_cast<int>(w);
+                lastWord = static_cast<int>(w);
+            }
+        }
+
+        if (firstWord < 0) continue;
+        int minX = firstWord * 64 + countTrailingZeros64(out[firstWord]);
+        int maxX = lastWord * 64 + highestBit64(out[lastWord]);
+        if (stats.maxX < stats.minX) {
+            stats.minX = minX; stats.maxX = maxX; stats.minY = y;
+        }
+        stats.minX = std::min(stats.minX, minX);
+        stats.maxX = std::max(stats.maxX, maxX);
+        stats.maxY = y;
+    }
+
+    hashTiles(next, y0 / TILE_ROWS, (y1 + TILE_ROWS - 1) / TILE_ROWS, true);
+}
@@ -0,0 +1,295 @@
+#include <cstring>
+#include <iostream>
+#include <algorithm>
+#include "delta_file.h"
+
+#ifdef _WIN32
+#define fseek64 _fseeki64
+#define ftell64 _ftelli64
+#else
+#define fseek64 fseeko
+#define ftell64 ftello
+#endif
+
+namespace {
+
+const char MAGIC[8] = { 'G', 'O', 'L', 'D', 'E', 'L', 'T', 'A' };
+const char INDEX_MAGIC[8] = { 'G', 'O', 'L', 'D', 'I', 'D', 'X', '\0' };
+
+void putVarint(std::vector<uint8_t>& out, uint64_t value)
+{
+    while (value >= 0x80) {
+        out.push_back(static_cast<uint8_t>(value) | 0x80);
+        value >>= 7;
+    }
+    out.push_back(static_cast<uint8_t>(value));
+}
+
+bool getVarint(const uint8_t*& p, const uint8_t* end, uint64_t& value)
+{
+    value = 0;
+    for (int shift = 0; shift < 64 && p < end; shift += 7) {
+        uint8_t byte = *p++;
+        value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+        if (!(byte & 0x80)) return true;
+    }
+    return false;
+}
+
+bool readVarint(FILE* file, uint64_t& value)
+{
+    value = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+        int c = fgetc(file);
+        if (c == EOF) return false;
+        value |= static_cast<uint64_t>(c & 0x7F) << shift;
+        if (!(c & 0x80)) return true;
+    }
+    return false;
+}
+
+// Word in row 'r' of tile (tx, ty), 0 past the bottom edge
+inline uint64_t tileWord(const PackedGrid& grid, size_t tx, int ty, int r)
+{
+    int y = ty * DeltaFile::TILE_ROWS + r;
+    return y < grid.height() ? grid.row(y)[tx] : 0;
+}
+
+}
+
+DeltaFile::Header DeltaFile::makeHeader(int width, int height, const LifeRule& rule)
+{
+    Header header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = VERSION;
+    header.width = static_cast<uint32_t>(width);
+    header.height = static_cast<uint32_t>(height);
+    header.birthMask = rule.birthMask;
+    header.surviveMask = rule.surviveMask;
+    return header;
+}
+
+bool DeltaFile::checkHeader(const Header& header)
+{
+    return std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) == 0 && header.version == VERSION;
+}
+
+DeltaFile::IndexHeader DeltaFile::makeIndexHeader(uint32_t keyframeInterval)
+{
+    IndexHeader header;
+    std::memcpy(header.magic, INDEX_MAGIC, sizeof(INDEX_MAGIC));
+    header.version = VERSION;
+    header.keyframeInterval = keyframeInterval;
+    return header;
+}
+
+void DeltaFile::encodeRecord(const PackedGrid& previous, const PackedGrid& current, unsigned long long generation,
+                             RecordType type, std::vector<uint8_t>& out)
+{
+    const size_t tilesX = current.usedWordsPerRow();
+    const int tilesY = (current.height() + TILE_ROWS - 1) / TILE_ROWS;
+    const bool key = type == KEYFRAME;
+
+    std::vector<uint8_t> body;
+    uint64_t changedTiles = 0, lastTile = 0;
+    uint64_t diff[TILE_ROWS];
+    for (int ty = 0; ty < tilesY; ty++) {
+        for (size_t tx = 0; tx < tilesX; tx++) {
+            uint64_t any = 0;
+            for (int r = 0; r < TILE_ROWS; r++) {
+                diff[r] = tileWord(current, tx, ty, r) ^ (key ? 0 : tileWord(previous, tx, ty, r));
+                any |= diff[r];
+            }
+            if (!any) continue;
+
+            uint64_t tile = static_cast<uint64_t>(ty) * tilesX + tx;
+            putVarint(body, changedTiles == 0 ? tile : tile - lastTile - 1);
+            lastTile = tile;
+            changedTiles++;
+
+            for (int r = 0; r < TILE_ROWS; ) {
+                int zeros = 0, literals = 0;
+                while (r + zeros < TILE_ROWS && diff[r + zeros] == 0) zeros++;
+                while (r + zeros + literals < TILE_ROWS && diff[r + zeros + literals] != 0) literals++;
+                putVarint(body, zeros);
+                putVarint(body, literals);
+                for (int i = 0; i < literals; i++) {
+                    uint64_t w = diff[r + zeros + i];
+                    for (int b = 0; b < 8; b++) body.push_back(static_cast<uint8_t>(w >> (8 * b)));
+                }
+                r += zeros + literals;
+            }
+        }
+    }
+
+    std::vector<uint8_t> head;
+    head.push_back(type);
+    putVarint(head, generation);
+    putVarint(head, changedTiles);
+
+    putVarint(out, head.size() + body.size());
+    out.insert(out.end(), head.begin(), head.end());
+    out.insert(out.end(), body.begin(), body.end());
+}
+
+bool DeltaFile::applyRecord(const uint8_t* payload, size_t size, PackedGrid& grid, unsigned long long& generation, RecordType& type)
+{
+    const uint8_t* p = payload;
+    const uint8_t* end = payload + size;
+    if (p >= end || *p > KEYFRAME) return false;
+    type = static_cast<RecordType>(*p++);
+
+    uint64_t gen, changedTiles;
+    if (!getVarint(p, end, gen) || !getVarint(p, end, changedTiles)) return false;
+    generation = gen;
+    if (type == KEYFRAME) grid.clear();
+
+    const size_t tilesX = grid.usedWordsPerRow();
+    const uint64_t numTiles = tilesX * static_cast<uint64_t>((grid.height() + TILE_ROWS - 1) / TILE_ROWS);
+    uint64_t tile = 0;
+    for (uint64_t t = 0; t < changedTiles; t++) {
+        uint64_t gap;
+        if (!getVarint(p, end, gap)) return false;
+        tile = t == 0 ? gap : tile + gap + 1;
+        if (tile >= numTiles) return false;
+        size_t tx = static_cast<size_t>(tile % tilesX);
+        int y0 = static_cast<int>(tile / tilesX) * TILE_ROWS;
+
+        for (int r = 0; r < TILE_ROWS; ) {
+            uint64_t zeros, literals;
+            if (!getVarint(p, end, zeros) || !getVarint(p, end, literals)) return false;
+            if (r + zeros + literals > TILE_ROWS || static_cast<size_t>(end - p) < literals * 8) return false;
+            if (zeros + literals == 0) return false;
+            r += static_cast<int>(zeros);
+            for (uint64_t i = 0; i < literals; i++, r++) {
+                uint64_t w = 0;
+                for (int b = 0; b < 8; b++) w |= static_cast<uint64_t>(*p++) << (8 * b);
+                if (y0 + r < grid.height()) grid.row(y0 + r)[tx] ^= w;
+            }
+        }
+    }
+    return p == end;
+}
+
+bool DeltaFile::Reader::open(const std::string& path)
+{
+    close();
+    file = fopen(path.c_str(), "rb");
+    if (!file) {
+        std::cout << "ERROR::DELTA_FILE::FILE_NOT_FOUND: " << path << std::endl;
+        return false;
+    }
+    if (fread(&_header, sizeof(_header), 1, file) != 1 || !checkHeader(_header)) {
+        std::cout << "ERROR::DELTA_FILE::BAD_HEADER: " << path << std::endl;
+        close();
+        return false;
+    }
+
+    fseek64(file, 0, SEEK_END);
+    fileSize = static_cast<uint64_t>(ftell64(file));
+    loadIndex(path);
+    scanRecords(keyframes.empty() ? sizeof(Header) : keyframes.back().offset);
+
+    fseek64(file, sizeof(Header), SEEK_SET);
+    return true;
+}
+
+void DeltaFile::Reader::close()
+{
+    if (file) fclose(file);
+    file = nullptr;
+    keyframes.clear();
+    _lastGeneration = 0;
+}
+
+void DeltaFile::Reader::loadIndex(const std::string& path)
+{
+    FILE* index = fopen(indexPath(path).c_str(), "rb");
+    if (!index) return;
+
+    IndexHeader header;
+    if (fread(&header, sizeof(header), 1, index) == 1 && std::memcmp(header.magic, INDEX_MAGIC, sizeof(INDEX_MAGIC)) == 0) {
+        IndexEntry entry;
+        // Entries pointing past the data (the run died before the records were flushed) are dropped
+        while (fread(&entry, sizeof(entry), 1, index) == 1 && entry.offset < fileSize)
+            if (keyframes.empty() || entry.generation > keyframes.back().generation) keyframes.push_back(entry);
+    }
+    fclose(index);
+}
+
+// Walks the records from 'offset' to the end, reading only each one's type & generation
+void DeltaFile::Reader::scanRecords(uint64_t offset)
+{
+    fseek64(file, static_cast<int64_t>(offset), SEEK_SET);
+    uint8_t head[16];
+    while (true) {
+        uint64_t start = static_cast<uint64_t>(ftell64(file)), size;
+        if (!readVarint(file, size) || size == 0) break;
+        uint64_t payloadStart = static_cast<uint64_t>(ftell64(file));
+
+        size_t headBytes = static_cast<size_t>(std::min<uint64_t>(size, sizeof(head)));
+        if (fread(head, 1, headBytes, file) != headBytes) break;
+        const uint8_t* p = head + 1;
+        uint64_t generation;
+        if (!getVarint(p, head + headBytes, generation)) break;
+        if (payloadStart + size > fileSize) break;     // Cut off by a crash
+        fseek64(file, static_cast<int64_t>(payloadStart + size), SEEK_SET);
+
+        if (head[0] == KEYFRAME && (keyframes.empty() || generation > keyframes.back().generation))
+            keyframes.push_back({ generation, start });
+        _lastGeneration = generation;
+    }
+}
+
+bool DeltaFile::Reader::readPayload()
+{
+    uint64_t size;
+    if (!readVarint(file, size)) return false;      // End of file
+    payload.resize(static_cast<size_t>(size));
+    return fread(payload.data(), 1, payload.size(), file) == payload.size();    // Else truncated (e.g. the run was killed)
+}
+
+bool DeltaFile::Reader::next(PackedGrid& grid, unsigned long long& generation, RecordType* type)
+{
+    if (!file) return false;
+    if (grid.width() != static_cast<int>(_header.width) || grid.height() != static_cast<int>(_header.height))
+        grid.resize(_header.width, _header.height);
+
+    if (!readPayload()) return false;
+
+    RecordType recordType;
+    if (!applyRecord(payload.data(), payload.size(), grid, generation, recordType)) {
+        std::cout << "ERROR::DELTA_FILE::BAD_RECORD" << std::endl;
+        return false;
+    }
+    if (type) *type = recordType;
+    return true;
+}
+
+bool DeltaFile::Reader::seek(unsigned long long target, PackedGrid& grid, unsigned long long& generation)
+{
+    if (!file || keyframes.empty()) return false;
+
+    // Last keyframe at or before the target
+    auto it = std::upper_bound(keyframes.begin(), keyframes.end(), target,
+                               [](unsigned long long g, const IndexEntry& e) { return g < e.generation; });
+    if (it != keyframes.begin()) --it;
+    fseek64(file, static_cast<int64_t>(it->offset), SEEK_SET);
+    if (!next(grid, generation)) return false;
+
+    // Deltas up to the target, stopping before any record past it
+    while (generation < target) {
+        int64_t recordStart = ftell64(file);
+        if (!readPayload()) break;
+        const uint8_t* p = payload.data() + 1;
+        uint64_t recordGeneration;
+        if (payload.empty() || !getVarint(p, payload.data() + payload.size(), recordGeneration) || recordGeneration > target) {
+            fseek64(file, recordStart, SEEK_SET);
+            break;
+        }
+        RecordType type;
+        if (!applyRecord(payload.data(), payload.size(), grid, generation, type)) return false;
+    }
+    return true;
+}
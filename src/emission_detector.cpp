@@ -0,0 +1,198 @@
+#include <algorithm>
+#include <cstdio>
+#include <iostream>
+#include <map>
+#include <tuple>
+#include "emission_detector.h"
+#include "cpu_life_engine.h"
+#include "bit_utils.h"
+
+namespace {
+
+const int REACH = 2;    // Cells this close can interact (as in the census)
+
+struct Cell { int x, y; };
+
+int findRoot(std::vector<int>& parent, int i)
+{
+    while (parent[i] != i) i = parent[i] = parent[parent[i]];
+    return i;
+}
+
+}
+
+EmissionDetector::EmissionDetector(int boardWidth, int boardHeight, const Rect& watched, const LifeRule& rule)
+    : watched(watched), rule(rule), census(1)
+{
+    census.setRule(rule);
+
+    // Above & below span the band's full width; left & right only the rectangle's rows
+    const Rect candidates[4] = {
+        { watched.x0 - BAND, watched.y1 + 1, watched.x1 + BAND, watched.y1 + BAND },
+        { watched.x0 - BAND, watched.y0 - BAND, watched.x1 + BAND, watched.y0 - 1 },
+        { watched.x0 - BAND, watched.y0, watched.x0 - 1, watched.y1 },
+        { watched.x1 + 1, watched.y0, watched.x1 + BAND, watched.y1 },
+    };
+    for (Rect strip : candidates) {
+        strip.x0 = std::max(strip.x0, 0);   strip.x1 = std::min(strip.x1, boardWidth - 1);
+        strip.y0 = std::max(strip.y0, 0);   strip.y1 = std::min(strip.y1, boardHeight - 1);
+        if (strip.x0 <= strip.x1 && strip.y0 <= strip.y1) strips.push_back(strip);
+    }
+}
+
+std::vector<EmissionDetector::Sighting> EmissionDetector::scan(const PackedGrid& board, unsigned long long generation)
+{
+    std::vector<Sighting> sightings;
+
+    // Live band cells, a word at a time. A band full of junk isn't worth picking through
+    std::vector<Cell> cells;
+    for (const Rect& strip : strips) {
+        for (int y = strip.y0; y <= strip.y1; y++) {
+            const uint64_t* row = board.row(y);
+            for (int w = strip.x0 >> 6; w <= strip.x1 >> 6; w++) {
+                uint64_t bits = row[w];
+                if (w == strip.x0 >> 6) bits &= ~0ull << (strip.x0 & 63);
+                if (w == strip.x1 >> 6) bits &= ~0ull >> (63 - (strip.x1 & 63));
+                for (; bits; bits &= bits - 1) cells.push_back({ w * 64 + countTrailingZeros64(bits), y });
+            }
+        }
+    }
+    if (cells.empty() || cells.size() > static_cast<size_t>(MAX_CELLS) * 64) return sightings;
+
+    // Cluster: cells within REACH join. Sorted by row then column, so each cell need only look back
+    std::sort(cells.begin(), cells.end(), [](const Cell& a, const Cell& b) { return std::tie(a.y, a.x) < std::tie(b.y, b.x); });
+    std::vector<int> parent(cells.size());
+    for (size_t i = 0; i < cells.size(); i++) {
+        parent[i] = static_cast<int>(i);
+        for (size_t j = i; j-- > 0 && cells[i].y - cells[j].y <= REACH;) {
+            if (std::abs(cells[i].x - cells[j].x) > REACH) continue;
+            int a = findRoot(parent, static_cast<int>(i)), b = findRoot(parent, static_cast<int>(j));
+            if (a != b) parent[std::max(a, b)] = std::min(a, b);
+        }
+    }
+    std::map<int, std::vector<Cell>> clusters;
+    for (size_t i = 0; i < cells.size(); i++) clusters[findRoot(parent, static_cast<int>(i))].push_back(cells[i]);
+
+    for (const auto& [root, members] : clusters) {
+        if (members.size() > static_cast<size_t>(MAX_CELLS)) continue;
+        Rect box = { members[0].x, members[0].y, members[0].x, members[0].y };
+        for (const Cell& cell : members) {
+            box.x0 = std::min(box.x0, cell.x);  box.x1 = std::max(box.x1, cell.x);
+            box.y0 = std::min(box.y0, cell.y);  box.y1 = std::max(box.y1, cell.y);
+        }
+
+        // Still within reach of the rectangle: it may not have left yet
+        if (box.x1 >= watched.x0 - REACH && box.x0 <= watched.x1 + REACH && box.y1 >= watched.y0 - REACH && box.y0 <= watched.y1 + REACH) continue;
+        // Within reach of the band's outer edge (short of the board's): part of it may be outside the band
+        bool cutOff = false;
+        for (const Rect& strip : strips) {
+            if (box.x1 < strip.x0 || box.x0 > strip.x1 || box.y1 < strip.y0 || box.y0 > strip.y1) continue;
+            if ((box.x0 - REACH < watched.x0 - BAND && strip.x0 > 0) || (box.x1 + REACH > watched.x1 + BAND && strip.x1 < board.width() - 1) ||
+                (box.y0 - REACH < watched.y0 - BAND && strip.y0 > 0) || (box.y1 + REACH > watched.y1 + BAND && strip.y1 < board.height() - 1))
+                cutOff = true;
+        }
+        if (cutOff) continue;
+
+        Sighting sighting = { PackedGrid(box.x1 - box.x0 + 1, box.y1 - box.y0 + 1), box.x0, box.y0 };
+        for (const Cell& cell : members) sighting.shape.set(cell.x - box.x0, cell.y - box.y0, true);
+        Motion motion = identify(sighting.shape);
+        if (motion.period == 0) continue;
+
+        _emissions.push_back({ generation, motion.code, box.x0, box.y0, motion.dx, motion.dy, motion.period });
+        sightings.push_back(std::move(sighting));
+    }
+    return sightings;
+}
+
+EmissionDetector::Motion EmissionDetector::identify(const PackedGrid& shape)
+{
+    int width = shape.width();
+    std::string key(reinterpret_cast<const char*>(&width), sizeof(int));
+    for (int y = 0; y < shape.height(); y++)
+        key.append(reinterpret_cast<const char*>(shape.row(y)), shape.usedWordsPerRow() * sizeof(uint64_t));
+    auto cached = motionCache.find(key);
+    if (cached != motionCache.end()) return cached->second;
+
+    // A single spaceship (a cluster of several independent objects waits until they've drifted apart)
+    Motion motion;
+    census.take(shape);
+    if (census.objects().size() == 1 && census.objects()[0].code.compare(0, 2, "xq") == 0) {
+        motion.code = census.objects()[0].code;
+        int period = atoi(motion.code.c_str() + 2);
+
+        // Its displacement over a period: how far its bounding box has moved
+        const int margin = period + 2;
+        PackedGrid board(shape.width() + 2 * margin, shape.height() + 2 * margin);
+        for (int y = 0; y < shape.height(); y++)
+            for (int x = 0; x < shape.width(); x++)
+                if (shape.get(x, y)) board.set(margin + x, margin + y, true);
+        CpuLifeEngine engine(1);
+        engine.setRule(rule);
+        engine.load(board);
+        GenerationStats stats;
+        for (int t = 0; t < period; t++) engine.step(&stats);
+        motion.dx = stats.minX - margin;
+        motion.dy = stats.minY - margin;
+        motion.period = period;
+    }
+    motionCache.emplace(key, motion);
+    return motion;
+}
+
+EmissionDetector::Sighting EmissionDetector::advance(const Sighting& sighting, int generations) const
+{
+    if (generations <= 0) return sighting;
+
+    // Nothing moves faster than a cell a generation
+    const int margin = generations + 2;
+    const PackedGrid& shape = sighting.shape;
+    PackedGrid board(shape.width() + 2 * margin, shape.height() + 2 * margin);
+    for (int y = 0; y < shape.height(); y++)
+        for (int x = 0; x < shape.width(); x++)
+            if (shape.get(x, y)) board.set(margin + x, margin + y, true);
+    CpuLifeEngine engine(1);
+    engine.setRule(rule);
+    engine.load(board);
+    GenerationStats stats;
+    for (int t = 0; t < generations; t++) engine.step(&stats);
+
+    Sighting moved = { PackedGrid(std::max(stats.maxX - stats.minX + 1, 1), std::max(stats.maxY - stats.minY + 1, 1)),
+                       sighting.x + stats.minX - margin, sighting.y + stats.minY - margin };
+    for (int y = stats.minY; y <= stats.maxY; y++)
+        for (int x = stats.minX; x <= stats.maxX; x++)
+            if (engine.board().get(x, y)) moved.shape.set(x - stats.minX, y - stats.minY, true);
+    return moved;
+}
+
+bool EmissionDetector::write(const std::string& path) const
+{
+    FILE* file = fopen(path.c_str(), "w");
+    if (!file) {
+        std::cout << "ERROR::EMISSIONS::CANT_CREATE: " << path << std::endl;
+        return false;
+    }
+
+    fprintf(file, "generation,code,x,y,dx,dy,period\n");
+    for (const Emission& e : _emissions)
+        fprintf(file, "%llu,%s,%d,%d,%d,%d,%d\n", e.generation, e.code.c_str(), e.x, e.y, e.dx, e.dy, e.period);
+    return fclose(file) == 0;
+}
+
+void EmissionDetector::printSummary() const
+{
+    struct Stream { size_t count = 0; unsigned long long first = 0, last = 0; };
+    std::map<std::tuple<std::string, int, int, int>, Stream> streams;
+    for (const Emission& e : _emissions) {
+        Stream& stream = streams[std::make_tuple(e.code, e.dx, e.dy, e.period)];
+        if (stream.count++ == 0) stream.first = e.generation;
+        stream.last = e.generation;
+    }
+
+    std::cout << _emissions.size() << " spaceships emitted" << std::endl;
+    for (const auto& [kind, stream] : streams) {
+        std::cout << "  " << std::get<0>(kind) << " moving (" << std::get<1>(kind) << ", " << std::get<2>(kind) << ")/" << std::get<3>(kind)
+                  << ": " << stream.count;
+        if (stream.count > 1) std::cout << ", one every " << static_cast<double>(stream.last - stream.first) / (stream.count - 1) << " generations";
+        std::cout << std::endl;
+    }
+}
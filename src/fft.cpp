@@ -0,0 +1,97 @@
+#include <cmath>
+#include <utility>
+#include "fft.h"
+
+namespace {
+
+// Spelled out: std::complex's operator* goes through a NaN-checking library call
+inline Fft::Complex mul(Fft::Complex a, Fft::Complex b)
+{
+    return { a.real() * b.real() - a.imag() * b.imag(), a.real() * b.imag() + a.imag() * b.real() };
+}
+
+std::vector<uint32_t> bitReversal(int length)
+{
+    std::vector<uint32_t> order(length);
+    int bits = 0;
+    while ((1 << bits) < length) bits++;
+    for (int i = 0; i < length; i++) {
+        uint32_t r = 0;
+        for (int b = 0; b < bits; b++) r |= ((i >> b) & 1u) << (bits - 1 - b);
+        order[i] = r;
+    }
+    return order;
+}
+
+}
+
+Fft::Fft(int length)
+    : n(length), twiddles(length / 2), reversed(bitReversal(length)), halfReversed(bitReversal(length / 2))
+{
+    const double TAU = 6.283185307179586;
+    for (int k = 0; k < n / 2; k++)
+        twiddles[k] = Complex(static_cast<float>(std::cos(TAU * k / n)), static_cast<float>(-std::sin(TAU * k / n)));
+}
+
+int Fft::nextPowerOfTwo(int n)
+{
+    int p = 1;
+    while (p < n) p <<= 1;
+    return p;
+}
+
+void Fft::transform(Complex* data, bool inverse) const
+{
+    transform(data, n, reversed, inverse);
+}
+
+// Iterative decimation in time: inputs into bit reversed order, then butterflies of doubling span.
+// 'length' is n or n / 2, whose twiddles are every (n / length)th of n's
+void Fft::transform(Complex* data, int length, const std::vector<uint32_t>& order, bool inverse) const
+{
+    for (int i = 0; i < length; i++)
+        if (static_cast<int>(order[i]) > i) std::swap(data[i], data[order[i]]);
+
+    for (int span = 1; span < length; span <<= 1) {
+        const int stride = n / (2 * span);
+        for (int i = 0; i < length; i += 2 * span)
+            for (int j = 0; j < span; j++) {
+                Complex w = twiddles[j * stride];
+                if (inverse) w = std::conj(w);
+                Complex u = data[i + j], v = mul(data[i + j + span], w);
+                data[i + j] = u + v;
+                data[i + j + span] = u - v;
+            }
+    }
+}
+
+// The even & odd samples go in as the real & imaginary parts of a half length transform, whose output
+// is then split into the two real transforms' (each mirror symmetric) & combined
+void Fft::forwardReal(const float* in, Complex* out, Complex* scratch) const
+{
+    const int half = n / 2;
+    for (int k = 0; k < half; k++) scratch[k] = Complex(in[2 * k], in[2 * k + 1]);
+    transform(scratch, half, halfReversed, false);
+
+    out[0] = Complex(scratch[0].real() + scratch[0].imag(), 0.0f);
+    out[half] = Complex(scratch[0].real() - scratch[0].imag(), 0.0f);
+    for (int k = 1; k < half; k++) {
+        Complex z = scratch[k], zm = std::conj(scratch[half - k]);
+        Complex even = 0.5f * (z + zm), odd = mul(mul(Complex(0.0f, -0.5f), z - zm), twiddles[k]);
+        out[k] = even + odd;
+    }
+}
+
+void Fft::inverseReal(const Complex* in, float* out, Complex* scratch) const
+{
+    const int half = n / 2;
+    for (int k = 0; k < half; k++) {
+        Complex x = in[k], xm = std::conj(in[half - k]);
+        scratch[k] = (x + xm) + mul(mul(Complex(0.0f, 1.0f), x - xm), std::conj(twiddles[k]));
+    }
+    transform(scratch, half, halfReversed, true);
+    for (int k = 0; k < half; k++) {
+        out[2 * k] = scratch[k].real();
+        out[2 * k + 1] = scratch[k].imag();
+    }
+}
@@ -0,0 +1,121 @@
+#include <iostream>
+#include <algorithm>
+#include "generation_recorder.h"
+
+bool GenerationRecorder::open(const std::string& path, int width, int height, const LifeRule& rule, unsigned keyframeInterval)
+{
+    file = fopen(path.c_str(), "wb");
+    indexFile = fopen(DeltaFile::indexPath(path).c_str(), "wb");
+    if (!file || !indexFile) {
+        std::cout << "ERROR::RECORDER::CANT_CREATE: " << path << std::endl;
+        if (file) fclose(file);
+        if (indexFile) fclose(indexFile);
+        file = indexFile = nullptr;
+        return false;
+    }
+    ioBuffer.resize(1 << 20);
+    setvbuf(file, ioBuffer.data(), _IOFBF, ioBuffer.size());
+
+    this->width = width;
+    this->height = height;
+    this->keyframeInterval = std::max(keyframeInterval, 1u);
+    DeltaFile::Header header = DeltaFile::makeHeader(width, height, rule);
+    fwrite(&header, sizeof(header), 1, file);
+    DeltaFile::IndexHeader indexHeader = DeltaFile::makeIndexHeader(this->keyframeInterval);
+    fwrite(&indexHeader, sizeof(indexHeader), 1, indexFile);
+    _bytesWritten = sizeof(header);
+
+    lastWritten.resize(width, height);
+    writer = std::thread(&GenerationRecorder::writerLoop, this);
+    return true;
+}
+
+void GenerationRecorder::record(const uint32_t* cells, unsigned long long generation)
+{
+    if (!file) return;
+
+    Frame frame;
+    frame.generation = generation;
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        if (queue.size() >= MAX_QUEUED_FRAMES) {
+            _dropped++;
+            return;
+        }
+        if (!freeGrids.empty()) {
+            frame.grid = std::move(freeGrids.back());
+            freeGrids.pop_back();
+        }
+    }
+    frame.grid.fromCells(cells, width, height);
+
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        queue.push_back(std::move(frame));
+    }
+    queueCV.notify_all();
+}
+
+bool GenerationRecorder::hasRoom() const
+{
+    std::lock_guard<std::mutex> lock(queueMutex);
+    return file && queue.size() < MAX_QUEUED_FRAMES;
+}
+
+void GenerationRecorder::finish()
+{
+    if (!writer.joinable()) return;
+
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        stopping = true;
+    }
+    queueCV.notify_all();
+    writer.join();
+
+    fclose(file);
+    fclose(indexFile);
+    file = indexFile = nullptr;
+}
+
+void GenerationRecorder::writerLoop()
+{
+    while (true) {
+        Frame frame;
+        {
+            std::unique_lock<std::mutex> lock(queueMutex);
+            queueCV.wait(lock, [this] { return stopping || !queue.empty(); });
+            if (queue.empty()) return;  // Stopping & drained
+            frame = std::move(queue.front());
+            queue.pop_front();
+        }
+
+        writeFrame(frame);
+
+        // The frame's grid becomes the reference for the next delta; the old reference is recycled
+        std::swap(frame.grid, lastWritten);
+        std::lock_guard<std::mutex> lock(queueMutex);
+        freeGrids.push_back(std::move(frame.grid));
+    }
+}
+
+void GenerationRecorder::writeFrame(const Frame& frame)
+{
+    bool key = !wroteAny || frame.generation - lastKeyframe >= keyframeInterval;
+    encoded.clear();
+    DeltaFile::encodeRecord(lastWritten, frame.grid, frame.generation, key ? DeltaFile::KEYFRAME : DeltaFile::DELTA, encoded);
+    fwrite(encoded.data(), 1, encoded.size(), file);
+
+    if (key) {
+        // The record is flushed before its index entry, so a reader never finds an entry ahead of the data
+        DeltaFile::IndexEntry entry = { frame.generation, _bytesWritten };
+        fflush(file);
+        fwrite(&entry, sizeof(entry), 1, indexFile);
+        fflush(indexFile);
+        lastKeyframe = frame.generation;
+    }
+
+    wroteAny = true;
+    _bytesWritten += encoded.size();
+    _recorded++;
+}
@@ -0,0 +1,86 @@
+#include <algorithm>
+#include <cstring>
+#include <chrono>
+#include <iostream>
+#include "generation_stats.h"
+
+void addStats(GenerationStats& total, const GenerationStats& part)
+{
+    total.population += part.population;
+    total.births += part.births;
+    total.deaths += part.deaths;
+    if (part.maxX < part.minX) return;
+    if (total.maxX < total.minX) {
+        total.minX = part.minX; total.minY = part.minY; total.maxX = part.maxX; total.maxY = part.maxY;
+        return;
+    }
+    total.minX = std::min(total.minX, part.minX);   total.maxX = std::max(total.maxX, part.maxX);
+    total.minY = std::min(total.minY, part.minY);   total.maxY = std::max(total.maxY, part.maxY);
+}
+
+bool StatsWriter::open(const std::string& path)
+{
+    csv = path.size() >= 4 && path.compare(path.size() - 4, 4, ".csv") == 0;
+    file = fopen(path.c_str(), csv ? "w" : "wb");
+    if (!file) {
+        std::cout << "ERROR::STATS::CANT_CREATE: " << path << std::endl;
+        return false;
+    }
+
+    if (csv) {
+        fprintf(file, "generation,population,births,deaths,hash,minX,minY,maxX,maxY\n");
+    }
+    else {
+        char header[16] = { 'G', 'O', 'L', 'S', 'T', 'A', 'T', 'S' };
+        uint32_t version = VERSION, recordBytes = sizeof(GenerationStats);
+        std::memcpy(header + 8, &version, 4);
+        std::memcpy(header + 12, &recordBytes, 4);
+        fwrite(header, sizeof(header), 1, file);
+    }
+
+    writer = std::thread(&StatsWriter::writerLoop, this);
+    return true;
+}
+
+void StatsWriter::push(const GenerationStats& stats)
+{
+    if (!file || !queue.push(stats)) _dropped++;
+}
+
+void StatsWriter::finish()
+{
+    if (!writer.joinable()) return;
+    stopping = true;
+    writer.join();
+    fclose(file);
+    file = nullptr;
+}
+
+void StatsWriter::writerLoop()
+{
+    GenerationStats stats;
+    while (true) {
+        bool stop = stopping;   // Read before draining, so nothing pushed before finish() is missed
+        bool any = false;
+        while (queue.pop(stats)) {
+            write(stats);
+            any = true;
+        }
+        if (stop) return;
+        if (!any) std::this_thread::sleep_for(std::chrono::milliseconds(1));    // Idle: no need to spin
+    }
+}
+
+void StatsWriter::write(const GenerationStats& stats)
+{
+    if (csv) {
+        fprintf(file, "%llu,%llu,%llu,%llu,%016llx,", static_cast<unsigned long long>(stats.generation), static_cast<unsigned long long>(stats.population),
+                static_cast<unsigned long long>(stats.births), static_cast<unsigned long long>(stats.deaths), static_cast<unsigned long long>(stats.hash));
+        if (stats.maxX < stats.minX) fprintf(file, ",,,\n");
+        else fprintf(file, "%d,%d,%d,%d\n", stats.minX, stats.minY, stats.maxX, stats.maxY);
+    }
+    else {
+        fwrite(&stats, sizeof(stats), 1, file);
+    }
+    _written++;
+}
@@ -0,0 +1,217 @@
+#include <algorithm>
+#include <thread>
+#include "generations_engine.h"
+#include "bit_utils.h"
+#include "cell_hash.h"
+
+namespace {
+
+const size_t MIN_CELLS_PER_THREAD = 1 << 18;
+
+}
+
+GenerationsEngine::GenerationsEngine(int threads)
+    : threads(threads > 0 ? threads : static_cast<int>(std::max(1u, std::thread::hardware_concurrency())))
+{
+    setRule(LifeRule());
+}
+
+void GenerationsEngine::setRule(const LifeRule& rule)
+{
+    birthMask = rule.birthMask;
+    surviveMask = rule.surviveMask;
+    states = rule.states;
+    planes = 1;
+    while ((1 << planes) < states) planes++;
+}
+
+void GenerationsEngine::loadCells(const std::vector<uint32_t>& cells, int width, int height)
+{
+    current.assign(planes, PackedGrid(width, height));
+    next.assign(planes, PackedGrid(width, height));
+    zeroRow.assign(current[0].wordsPerRow(), 0);
+    for (int y = 0; y < height; y++)
+        for (int x = 0; x < width; x++) {
+            unsigned state = cells[static_cast<size_t>(y) * width + x];
+            set(x, y, state < static_cast<unsigned>(states) ? state : 1);
+        }
+}
+
+void GenerationsEngine::toCells(std::vector<uint32_t>& cells) const
+{
+    cells.resize(static_cast<size_t>(width()) * height());
+    for (int y = 0; y < height(); y++)
+        for (int x = 0; x < width(); x++)
+            cells[static_cast<size_t>(y) * width() + x] = get(x, y);
+}
+
+size_t GenerationsEngine::sizeInBytes() const
+{
+    return current[0].sizeInBytes() * planes;
+}
+
+unsigned GenerationsEngine::get(int x, int y) const
+{
+    unsigned state = 0;
+    for (int p = 0; p < planes; p++) state |= static_cast<unsigned>(current[p].get(x, y)) << p;
+    return state;
+}
+
+void GenerationsEngine::set(int x, int y, unsigned state)
+{
+    for (int p = 0; p < planes; p++) current[p].set(x, y, (state >> p) & 1);
+}
+
+void GenerationsEngine::stamp(const PackedGridView& pattern, int x, int y, StampMode mode)
+{
+    int x0 = std::max(x, 0), x1 = std::min(x + pattern.width, width());
+    int y0 = std::max(y, 0), y1 = std::min(y + pattern.height, height());
+    for (int j = y0; j < y1; j++)
+        for (int i = x0; i < x1; i++)
+            set(i, j, stampState(get(i, j), pattern.get(i - x, j - y), mode));
+}
+
+void GenerationsEngine::step(GenerationStats* stats)
+{
+    hashing = stats != nullptr;
+    const int h = height();
+    size_t cells = static_cast<size_t>(width()) * h;
+    int bands = static_cast<int>(std::min<size_t>(threads, std::max<size_t>(1, cells / MIN_CELLS_PER_THREAD)));
+    bands = std::max(1, std::min(bands, h));
+
+    std::vector<GenerationStats> bandStats(bands);
+    std::vector<uint32_t> hashLo(bands, 0), hashHi(bands, 0);
+    std::vector<std::thread> workers;
+    for (int b = 1; b < bands; b++)
+        workers.emplace_back(&GenerationsEngine::stepRows, this, h * b / bands, h * (b + 1) / bands,
+                             std::ref(bandStats[b]), std::ref(hashLo[b]), std::ref(hashHi[b]));
+    stepRows(0, h / bands, bandStats[0], hashLo[0], hashHi[0]);
+    for (std::thread& t : workers) t.join();
+
+    std::swap(current, next);
+
+    if (stats) {
+        GenerationStats total;
+        uint32_t lo = 0, hi = 0;
+        for (int b = 0; b < bands; b++) {
+            addStats(total, bandStats[b]);
+            lo += hashLo[b];
+            hi += hashHi[b];
+        }
+        total.generation = stats->generation;
+        total.hash = (static_cast<uint64_t>(hi) << 32) | lo;
+        *stats = total;
+    }
+}
+
+void GenerationsEngine::stepRows(int y0, int y1, GenerationStats& stats, uint32_t& hashLo, uint32_t& hashHi)
+{
+    const int w = width(), h = height();
+    const size_t words = current[0].usedWordsPerRow();
+    const uint64_t lastMask = (w & 63) ? ~0ull >> (64 - (w & 63)) : ~0ull;
+    const bool wraps = (1 << planes) != states;     // Else the carry out of the top plane wraps to 0 by itself
+
+    // Live (state 1) rows y-1, y, y+1, derived from the planes as they're needed
+    std::vector<uint64_t> liveRows[3];
+    for (std::vector<uint64_t>& row : liveRows) row.assign(words, 0);
+    auto deriveLive = [&](int y, std::vector<uint64_t>& out) {
+        if (y < 0 || y >= h) {
+            std::fill(out.begin(), out.end(), 0);
+            return;
+        }
+        for (size_t i = 0; i < words; i++) {
+            uint64_t live = current[0].row(y)[i];
+            for (int p = 1; p < planes; p++) live &= ~current[p].row(y)[i];
+            out[i] = live;
+        }
+    };
+    deriveLive(y0 - 1, liveRows[0]);
+    deriveLive(y0, liveRows[1]);
+
+    for (int y = y0; y < y1; y++) {
+        deriveLive(y + 1, liveRows[(y - y0 + 2) % 3]);
+        const uint64_t* rows[3] = { liveRows[(y - y0) % 3].data(), liveRows[(y - y0 + 1) % 3].data(), liveRows[(y - y0 + 2) % 3].data() };
+        const uint64_t* in[MAX_PLANES];
+        uint64_t* out[MAX_PLANES];
+        for (int p = 0; p < MAX_PLANES; p++) {
+            in[p] = p < planes ? current[p].row(y) : zeroRow.data();
+            out[p] = p < planes ? next[p].row(y) : nullptr;
+        }
+        int firstWord = -1, lastWord = -1;
+
+        for (size_t i = 0; i < words; i++) {
+            uint64_t s0 = 0, s1 = 0, s2 = 0, s3 = 0;
+            for (int r = 0; r < 3; r++) {
+                const uint64_t* row = rows[r];
+                uint64_t centre = row[i];
+                uint64_t west = (centre << 1) | (i > 0 ? row[i - 1] >> 63 : 0);     // Bit x = cell x-1
+                uint64_t east = (centre >> 1) | (i + 1 < words ? row[i + 1] << 63 : 0);
+                addPlane(west, s0, s1, s2, s3);
+                addPlane(east, s0, s1, s2, s3);
+                if (r != 1) addPlane(centre, s0, s1, s2, s3);
+            }
+
+            uint64_t live = rows[1][i];
+            uint64_t occupied = in[0][i] | in[1][i] | in[2][i] | in[3][i];
+            uint64_t born = ~occupied & countIn(birthMask, s0, s1, s2, s3);
+            uint64_t stays = live & countIn(surviveMask, s0, s1, s2, s3);
+            uint64_t decaying = occupied & ~stays;
+
+            // Decaying cells' states + 1, then those that went past the last state back to 0
+            uint64_t stepped[MAX_PLANES], carry = decaying;
+            for (int p = 0; p < MAX_PLANES; p++) {
+                stepped[p] = (in[p][i] ^ carry) & decaying;
+                carry &= in[p][i];
+            }
+            if (wraps) {
+                uint64_t last = decaying;
+                for (int p = 0; p < planes; p++) last &= ((states >> p) & 1) ? stepped[p] : ~stepped[p];
+                for (int p = 0; p < planes; p++) stepped[p] &= ~last;
+            }
+            stepped[0] |= born | stays;
+            uint64_t mask = i + 1 == words ? lastMask : ~0ull;      // Padding bits stay dead
+            for (int p = 0; p < planes; p++) out[p][i] = stepped[p] & mask;
+
+            uint64_t nowLive = (born | stays) & mask;
+            stats.population += popcount64(nowLive);
+            stats.births += popcount64(born & mask);
+            stats.deaths += popcount64(live & ~stays);
+            if (nowLive) {
+                if (firstWord < 0) firstWord = static_cast<int>(i);
+                lastWord = static_cast<int>(i);
+            }
+
+            // Hash of every non-zero state: a live cell's cellHash(), mixed with the state for the others
+            if (!hashing) continue;
+            uint64_t any = 0;
+            for (int p = 0; p < planes; p++) any |= out[p][i];
+            for (uint64_t bits = any; bits; bits &= bits - 1) {
+                int bit = countTrailingZeros64(bits);
+                uint32_t lo, hi, state = 0;
+                for (int p = 0; p < planes; p++) state |= static_cast<uint32_t>((out[p][i] >> bit) & 1) << p;
+                cellHash(static_cast<uint32_t>(i * 64 + bit), static_cast<uint32_t>(y), lo, hi);
+                if (state > 1) {
+                    lo = lowbias32(lo + state);
+                    hi = lowbias32(hi + state);
+                }
+                hashLo += lo;
+                hashHi += hi;
+            }
+        }
+
+        if (firstWord < 0) continue;
+        uint64_t firstLive = (next[0].row(y)[firstWord]), lastLive = next[0].row(y)[lastWord];
+        for (int p = 1; p < planes; p++) {
+            firstLive &= ~next[p].row(y)[firstWord];
+            lastLive &= ~next[p].row(y)[lastWord];
+        }
+        int minX = firstWord * 64 + countTrailingZeros64(firstLive);
+        int maxX = lastWord * 64 + highestBit64(lastLive);
+        if (stats.maxX < stats.minX) {
+            stats.minX = minX; stats.maxX = maxX; stats.minY = y;
+        }
+        stats.minX = std::min(stats.minX, minX);
+        stats.maxX = std::max(stats.maxX, maxX);
+        stats.maxY = y;
+    }
+}
@@ -0,0 +1,156 @@
+#include <algorithm>
+#include "gpu_continuous_engine.h"
+#include "continuous_engine.h"
+#include "fft.h"
+
+GpuContinuousEngine::GpuContinuousEngine(int width, int height, const ContinuousRule& rule)
+    : fftShader(SHADER_PATH "fftPass.comp"),
+      stepShader(SHADER_PATH "continuousStep.comp", rule.kernelCount() == 2 ? "#define TWO_KERNELS\n" : ""),
+      width(width), height(height)
+{
+    const int r = rule.kernelRadius(), size = 2 * r + 1;
+    paddedX = Fft::nextPowerOfTwo(std::max(width + r, 2));
+    paddedY = Fft::nextPowerOfTwo(std::max(height + r, 2));
+    const size_t padded = static_cast<size_t>(paddedX) * paddedY;
+
+    // The kernels' full spectra, wrapped around the padded board as ContinuousEngine lays them out: a complex
+    // value per frequency, or (first kernel, second kernel) pairs of them with two kernels
+    Fft rowFft(paddedX), columnFft(paddedY);
+    const size_t stride = 2 * static_cast<size_t>(rule.kernelCount());
+    std::vector<GLfloat> spectra(padded * stride, 0.0f);
+    std::vector<Fft::Complex> board(padded), column(paddedY);
+    const float scale = 1.0f / static_cast<float>(padded);
+    for (int k = 0; k < rule.kernelCount(); k++) {
+        std::vector<float> weights = rule.kernel(k);
+        std::fill(board.begin(), board.end(), Fft::Complex());
+        for (int dy = -r; dy <= r; dy++)
+            for (int dx = -r; dx <= r; dx++)
+                board[static_cast<size_t>((dy % paddedY + paddedY) % paddedY) * paddedX + (dx % paddedX + paddedX) % paddedX] +=
+                    weights[static_cast<size_t>(dy + r) * size + dx + r];
+        for (int y = 0; y < paddedY; y++) rowFft.transform(board.data() + static_cast<size_t>(y) * paddedX, false);
+        for (int x = 0; x < paddedX; x++) {
+            for (int y = 0; y < paddedY; y++) column[y] = board[static_cast<size_t>(y) * paddedX + x];
+            columnFft.transform(column.data(), false);
+            for (int y = 0; y < paddedY; y++) {
+                size_t i = static_cast<size_t>(y) * paddedX + x;
+                spectra[i * stride + 2 * k] = column[y].real() * scale;
+                spectra[i * stride + 2 * k + 1] = column[y].imag() * scale;
+            }
+        }
+    }
+
+    glGenBuffers(1, &fieldBuf);
+    glGenBuffers(2, workBufs);
+    glGenBuffers(1, &spectraBuf);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, fieldBuf);
+    glBufferData(GL_SHADER_STORAGE_BUFFER, static_cast<size_t>(width) * height * sizeof(GLfloat), NULL, GL_DYNAMIC_COPY);
+    for (GLuint buf : workBufs) {
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, buf);
+        glBufferData(GL_SHADER_STORAGE_BUFFER, padded * 2 * sizeof(GLfloat), NULL, GL_DYNAMIC_COPY);
+    }
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, spectraBuf);
+    glBufferData(GL_SHADER_STORAGE_BUFFER, spectra.size() * sizeof(GLfloat), spectra.data(), GL_STATIC_DRAW);
+
+    stepShader.use();
+    stepShader.setInt_w_Name("numCellsX", width);
+    stepShader.setInt_w_Name("numCellsY", height);
+    stepShader.setInt_w_Name("paddedX", paddedX);
+    stepShader.setInt_w_Name("paddedY", paddedY);
+    stepShader.setBool_w_Name("smoothLife", rule.kind == ContinuousRule::SMOOTH_LIFE);
+    stepShader.setFloat_w_Name("timeSteps", rule.timeSteps);
+    stepShader.setFloat_w_Name("growthCentre", rule.growthCentre);
+    stepShader.setFloat_w_Name("growthWidth", rule.growthWidth);
+    stepShader.setInt_w_Name("growthShape", rule.growthShape);
+    stepShader.setFloat_w_Name("birthLow", rule.birthLow);
+    stepShader.setFloat_w_Name("birthHigh", rule.birthHigh);
+    stepShader.setFloat_w_Name("deathLow", rule.deathLow);
+    stepShader.setFloat_w_Name("deathHigh", rule.deathHigh);
+    stepShader.setFloat_w_Name("alphaN", rule.alphaN);
+    stepShader.setFloat_w_Name("alphaM", rule.alphaM);
+    stepShader.setFloat_w_Name("dt", rule.dt);
+}
+
+GpuContinuousEngine::~GpuContinuousEngine()
+{
+    glDeleteBuffers(1, &fieldBuf);
+    glDeleteBuffers(2, workBufs);
+    glDeleteBuffers(1, &spectraBuf);
+}
+
+void GpuContinuousEngine::load(const std::vector<uint32_t>& cells)
+{
+    std::vector<GLfloat> values(cells.size());
+    for (size_t i = 0; i < cells.size(); i++) values[i] = ContinuousEngine::toValue(cells[i]);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, fieldBuf);
+    glBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, values.size() * sizeof(GLfloat), values.data());
+}
+
+void GpuContinuousEngine::stamp(GLuint cellsBuf, const PackedGridView& pattern, int x, int y, StampMode mode)
+{
+    std::vector<GLfloat> values(static_cast<size_t>(width) * height);
+    glMemoryBarrier(GL_BUFFER_UPDATE_BARRIER_BIT);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, fieldBuf);
+    glGetBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, values.size() * sizeof(GLfloat), values.data());
+
+    int x0 = std::max(x, 0), x1 = std::min(x + pattern.width, width);
+    int y0 = std::max(y, 0), y1 = std::min(y + pattern.height, height);
+    for (int j = y0; j < y1; j++)
+        for (int i = x0; i < x1; i++) {
+            GLfloat& value = values[static_cast<size_t>(j) * width + i];
+            bool cell = pattern.get(i - x, j - y);
+            if (cell || mode == STAMP_REPLACE) value = stampState(value > 0.0f, cell, mode) ? 1.0f : 0.0f;
+        }
+    glBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, values.size() * sizeof(GLfloat), values.data());
+
+    if (x0 >= x1) return;
+    std::vector<GLuint> levels(x1 - x0);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, cellsBuf);
+    for (int j = y0; j < y1; j++) {
+        for (int i = x0; i < x1; i++) levels[i - x0] = ContinuousEngine::toLevel(values[static_cast<size_t>(j) * width + i]);
+        glBufferSubData(GL_SHADER_STORAGE_BUFFER, (static_cast<size_t>(j) * width + x0) * sizeof(GLuint), levels.size() * sizeof(GLuint), levels.data());
+    }
+}
+
+void GpuContinuousEngine::step(GLuint cellsBuf)
+{
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, cellsBuf);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, FIELD_BINDING, fieldBuf);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, SPECTRA_BINDING, spectraBuf);
+
+    runStage(LOAD, 0);
+    int work = transform(0, paddedX, 1, paddedX, paddedY, false);
+    work = transform(work, paddedY, paddedX, 1, paddedX, false);
+    runStage(MULTIPLY, work);
+    work = transform(work, paddedY, paddedX, 1, paddedX, true);
+    work = transform(work, paddedX, 1, paddedX, height, true);     // Only the board's rows are read
+    runStage(UPDATE, work);
+}
+
+int GpuContinuousEngine::transform(int from, int length, int stride, int lineStride, int lines, bool inverse)
+{
+    fftShader.use();
+    fftShader.setInt_w_Name("lineLength", length);
+    fftShader.setInt_w_Name("stride", stride);
+    fftShader.setInt_w_Name("lineStride", lineStride);
+    fftShader.setInt_w_Name("lines", lines);
+    fftShader.setBool_w_Name("inverse", inverse);
+    for (int span = 1; span < length; span <<= 1) {
+        fftShader.setInt_w_Name("span", span);
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, WORK_BINDING, workBufs[from]);
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, OUTPUT_BINDING, workBufs[1 - from]);
+        glDispatchCompute((length / 2 + 63) / 64, lines, 1);
+        glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+        from = 1 - from;
+    }
+    return from;
+}
+
+void GpuContinuousEngine::runStage(Stage stage, int work)
+{
+    stepShader.use();
+    stepShader.setInt_w_Name("stage", stage);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, WORK_BINDING, workBufs[work]);
+    if (stage == UPDATE) glDispatchCompute((width + 7) / 8, (height + 7) / 8, 1);
+    else glDispatchCompute((paddedX + 7) / 8, (paddedY + 7) / 8, 1);
+    glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+}
@@ -0,0 +1,61 @@
+#include "gpu_generations_engine.h"
+
+GpuGenerationsEngine::GpuGenerationsEngine(int width, int height, const LifeRule& rule)
+    : shader(SHADER_PATH "generationsStep.comp"), width(width), height(height),
+      wordsPerRow((width + CELLS_PER_WORD - 1) / CELLS_PER_WORD)
+{
+    glGenBuffers(2, statesBufs);
+    for (GLuint buffer : statesBufs) {
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, buffer);
+        glBufferData(GL_SHADER_STORAGE_BUFFER, sizeInBytes(), NULL, GL_DYNAMIC_COPY);
+    }
+
+    shader.use();
+    shader.setInt_w_Name("numCellsX", width);
+    shader.setInt_w_Name("numCellsY", height);
+    shader.setInt_w_Name("wordsPerRow", wordsPerRow);
+    shader.setInt_w_Name("birthMask", rule.birthMask);
+    shader.setInt_w_Name("surviveMask", rule.surviveMask);
+    shader.setInt_w_Name("states", rule.states);
+    sourceLoc = glGetUniformLocation(shader.ID, "source");
+}
+
+GpuGenerationsEngine::~GpuGenerationsEngine()
+{
+    glDeleteBuffers(2, statesBufs);
+}
+
+void GpuGenerationsEngine::load(const std::vector<uint32_t>& cells)
+{
+    std::vector<GLuint> words(static_cast<size_t>(wordsPerRow) * height, 0);
+    for (int y = 0; y < height; y++)
+        for (int x = 0; x < width; x++)
+            words[static_cast<size_t>(y) * wordsPerRow + x / CELLS_PER_WORD] |= (cells[static_cast<size_t>(y) * width + x] & 15u) << (4 * (x % CELLS_PER_WORD));
+    currentBuf = 0;
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, statesBufs[currentBuf]);
+    glBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, sizeInBytes(), words.data());
+}
+
+void GpuGenerationsEngine::toCells(std::vector<uint32_t>& cells) const
+{
+    std::vector<GLuint> words(static_cast<size_t>(wordsPerRow) * height);
+    glMemoryBarrier(GL_BUFFER_UPDATE_BARRIER_BIT);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, statesBufs[currentBuf]);
+    glGetBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, sizeInBytes(), words.data());
+
+    cells.resize(static_cast<size_t>(width) * height);
+    for (int y = 0; y < height; y++)
+        for (int x = 0; x < width; x++)
+            cells[static_cast<size_t>(y) * width + x] = (words[static_cast<size_t>(y) * wordsPerRow + x / CELLS_PER_WORD] >> (4 * (x % CELLS_PER_WORD))) & 15u;
+}
+
+void GpuGenerationsEngine::step()
+{
+    shader.use();
+    shader.setInt_w_Loc(sourceLoc, currentBuf);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, STATES0_BINDING, statesBufs[0]);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, STATES1_BINDING, statesBufs[1]);
+    glDispatchCompute((wordsPerRow + 7) / 8, (height + 7) / 8, 1);
+    glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+    currentBuf ^= 1;
+}
@@ -0,0 +1,46 @@
+#include "gpu_ltl_engine.h"
+
+GpuLtlEngine::GpuLtlEngine(int width, int height, const LtlRule& rule)
+    : prefixSumsShader(SHADER_PATH "ltlPrefixSums.comp"), stepShader(SHADER_PATH "ltlStep.comp"), width(width), height(height)
+{
+    glGenBuffers(1, &sumsBuf);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, sumsBuf);
+    glBufferData(GL_SHADER_STORAGE_BUFFER, static_cast<size_t>(width) * height * sizeof(GLuint), NULL, GL_DYNAMIC_COPY);
+
+    for (ComputeShaderProgram* shader : { &prefixSumsShader, &stepShader }) {
+        shader->use();
+        shader->setInt_w_Name("numCellsX", width);
+        shader->setInt_w_Name("numCellsY", height);
+    }
+    alongColumnsLoc = glGetUniformLocation(prefixSumsShader.ID, "alongColumns");
+    stepShader.setInt_w_Name("range", rule.range);
+    stepShader.setInt_w_Name("birthMin", rule.birthMin);
+    stepShader.setInt_w_Name("birthMax", rule.birthMax);
+    stepShader.setInt_w_Name("surviveMin", rule.surviveMin);
+    stepShader.setInt_w_Name("surviveMax", rule.surviveMax);
+    stepShader.setBool_w_Name("countsSelf", rule.countsSelf);
+}
+
+GpuLtlEngine::~GpuLtlEngine()
+{
+    glDeleteBuffers(1, &sumsBuf);
+}
+
+void GpuLtlEngine::step(GLuint cellsBuf)
+{
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, cellsBuf);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, SUMS_BINDING, sumsBuf);
+
+    // Rows, then columns: 32 lines per workgroup
+    prefixSumsShader.use();
+    prefixSumsShader.setBool_w_Loc(alongColumnsLoc, false);
+    glDispatchCompute((height + 31) / 32, 1, 1);
+    glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+    prefixSumsShader.setBool_w_Loc(alongColumnsLoc, true);
+    glDispatchCompute((width + 31) / 32, 1, 1);
+    glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+
+    stepShader.use();
+    glDispatchCompute((width + 7) / 8, (height + 7) / 8, 1);
+    glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+}
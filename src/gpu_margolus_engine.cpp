@@ -0,0 +1,40 @@
+#include "gpu_margolus_engine.h"
+
+GpuMargolusEngine::GpuMargolusEngine(int width, int height, const MargolusRule& rule)
+    : shader(SHADER_PATH "margolusStep.comp"), reversible(rule.reversible()), width(width), height(height)
+{
+    std::array<uint8_t, 16> inverse = rule.inverse();
+    for (int i = 0; i < 16; i++) {
+        forwardTable[i] = rule.table[i];
+        backwardTable[i] = inverse[i];
+    }
+
+    shader.use();
+    shader.setInt_w_Name("numCellsX", width);
+    shader.setInt_w_Name("numCellsY", height);
+    setTable(false);
+}
+
+void GpuMargolusEngine::setTable(bool backward)
+{
+    glUniform1uiv(glGetUniformLocation(shader.ID, "blockTable"), 16, backward ? backwardTable.data() : forwardTable.data());
+    tableBackward = backward;
+}
+
+void GpuMargolusEngine::step(GLuint cellsBuf, bool backward)
+{
+    if (backward && !reversible) return;
+
+    // Undoing a step cuts the board as that step did: the partition before it
+    if (backward) _time--;
+    const int offset = static_cast<int>(_time & 1);
+    if (!backward) _time++;
+
+    shader.use();
+    if (backward != tableBackward) setTable(backward);
+    shader.setInt_w_Name("offset", offset);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, cellsBuf);
+    int blocksX = (width - offset) / 2, blocksY = (height - offset) / 2;
+    glDispatchCompute((blocksX + 7) / 8, (blocksY + 7) / 8, 1);
+    glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+}
@@ -0,0 +1,62 @@
+#include <climits>
+#include <cstring>
+#include "gpu_reduction.h"
+
+GpuReduction::GpuReduction(int slots)
+    : shader(SHADER_PATH "reduce.comp"), ring(slots, sizeof(Block))
+{
+}
+
+void GpuReduction::submit(GLuint cellsBuf, int width, int height, unsigned long long tag, int packedWordsPerRow)
+{
+    // Ring full: the oldest request must be collected before its buffer is reused
+    if (ring.full()) ring.collect(storer());
+
+    const Block reset = { 0, 0, 0, UINT_MAX, 0, INT_MAX, INT_MAX, INT_MIN, INT_MIN };
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, ring.next());
+    glBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, sizeof(Block), &reset);
+
+    shader.use();
+    shader.setInt_w_Name("numCellsX", width);
+    shader.setInt_w_Name("numCellsY", height);
+    shader.setInt_w_Name("packedWordsPerRow", packedWordsPerRow);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, CELLS_BINDING, cellsBuf);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, RESULT_BINDING, ring.next());
+    glDispatchCompute((width + 15) / 16, (height + 15) / 16, 1);
+    glMemoryBarrier(GL_BUFFER_UPDATE_BARRIER_BIT);
+
+    ring.submit(tag);
+}
+
+bool GpuReduction::poll(Result& result)
+{
+    // Pick up the oldest request if the GPU is done with it (without waiting)
+    if (ready.empty()) ring.poll(storer());
+    if (ready.empty()) return false;
+    result = ready.front();
+    ready.pop_front();
+    return true;
+}
+
+void GpuReduction::flush()
+{
+    ring.flush(storer());
+}
+
+void GpuReduction::store(const void* data, unsigned long long tag)
+{
+    Block block;
+    std::memcpy(&block, data, sizeof(Block));
+
+    Result result;
+    result.tag = tag;
+    result.count = block.count;
+    result.sum = (static_cast<uint64_t>(block.sumHi) << 32) | block.sumLo;
+    result.minValue = block.minValue;
+    result.maxValue = block.maxValue;
+    if (block.count > 0) {
+        result.minX = block.minX;  result.minY = block.minY;
+        result.maxX = block.maxX;  result.maxY = block.maxY;
+    }
+    ready.push_back(result);
+}
@@ -0,0 +1,61 @@
+#include <string>
+#include <vector>
+#include "gpu_rule_table_engine.h"
+
+GpuRuleTableEngine::GpuRuleTableEngine(int width, int height, const RuleTable& table)
+    : shader(SHADER_PATH "ruleTableStep.comp", specialise(table)), width(width), height(height)
+{
+    glGenBuffers(1, &tableBuf);
+    glGenBuffers(1, &seedsBuf);
+
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, tableBuf);
+    if (table.dense()) {
+        // Padded to whole uints, as the shader reads them
+        std::vector<uint8_t> bytes(table.denseEntries());
+        bytes.resize((bytes.size() + 3) & ~size_t(3), 0);
+        tableSize = bytes.size();
+        glBufferData(GL_SHADER_STORAGE_BUFFER, tableSize, bytes.data(), GL_STATIC_DRAW);
+    }
+    else {
+        tableSize = table.hashSlots().size() * sizeof(RuleTable::Slot);
+        glBufferData(GL_SHADER_STORAGE_BUFFER, tableSize, table.hashSlots().data(), GL_STATIC_DRAW);
+        seedsSize = table.bucketSeeds().size() * sizeof(uint32_t);
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, seedsBuf);
+        glBufferData(GL_SHADER_STORAGE_BUFFER, seedsSize, table.bucketSeeds().data(), GL_STATIC_DRAW);
+    }
+
+    shader.use();
+    shader.setInt_w_Name("numCellsX", width);
+    shader.setInt_w_Name("numCellsY", height);
+}
+
+GpuRuleTableEngine::~GpuRuleTableEngine()
+{
+    glDeleteBuffers(1, &tableBuf);
+    glDeleteBuffers(1, &seedsBuf);
+}
+
+// The #defines ruleTableStep.comp is compiled with
+std::string GpuRuleTableEngine::specialise(const RuleTable& table)
+{
+    static const char* MOORE_OFFSETS = "ivec2[](ivec2(0, 1), ivec2(1, 1), ivec2(1, 0), ivec2(1, -1), ivec2(0, -1), ivec2(-1, -1), ivec2(-1, 0), ivec2(-1, 1))";
+    static const char* VON_NEUMANN_OFFSETS = "ivec2[](ivec2(0, 1), ivec2(1, 0), ivec2(0, -1), ivec2(-1, 0))";
+
+    std::string defines = "#define NEIGHBOURS " + std::to_string(table.neighbourCount()) + "\n"
+                        + "#define BITS_PER_STATE " + std::to_string(table.bitsPerState) + "\n"
+                        + "#define NEIGHBOUR_OFFSETS " + (table.neighbourhood == RuleTable::MOORE ? MOORE_OFFSETS : VON_NEUMANN_OFFSETS) + "\n";
+    if (table.dense()) return defines + "#define DENSE\n";
+    return defines + "#define BUCKETS " + std::to_string(table.bucketSeeds().size()) + "u\n"
+                   + "#define SLOTS " + std::to_string(table.hashSlots().size()) + "u\n";
+}
+
+void GpuRuleTableEngine::step(GLuint sourceBuf, GLuint targetBuf)
+{
+    shader.use();
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, sourceBuf);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, targetBuf);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, TABLE_BINDING, tableBuf);
+    if (seedsSize) glBindBufferBase(GL_SHADER_STORAGE_BUFFER, SEEDS_BINDING, seedsBuf);
+    glDispatchCompute((width + 7) / 8, (height + 7) / 8, 1);
+    glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+}
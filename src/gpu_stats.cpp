@@ -0,0 +1,57 @@
+#include <climits>
+#include <cstring>
+#include "gpu_stats.h"
+
+GpuStats::GpuStats(int slots)
+    : ring(slots, sizeof(Block))
+{
+}
+
+void GpuStats::begin()
+{
+    // Ring full: the oldest step must be collected before its buffer is reused
+    if (ring.full()) ring.collect(storer());
+
+    const Block reset = { 0, 0, 0, INT_MAX, INT_MAX, INT_MIN, INT_MIN, 0, 0 };
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, ring.next());
+    glBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, sizeof(Block), &reset);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, BINDING, ring.next());
+}
+
+void GpuStats::end(unsigned long long generation)
+{
+    ring.submit(generation);
+}
+
+bool GpuStats::poll(GenerationStats& stats)
+{
+    // Pick up the oldest step if the GPU is done with it (without waiting)
+    if (ready.empty()) ring.poll(storer());
+    if (ready.empty()) return false;
+    stats = ready.front();
+    ready.pop_front();
+    return true;
+}
+
+void GpuStats::flush()
+{
+    ring.flush(storer());
+}
+
+void GpuStats::store(const void* data, unsigned long long generation)
+{
+    Block block;
+    std::memcpy(&block, data, sizeof(Block));
+
+    GenerationStats stats;
+    stats.generation = generation;
+    stats.population = block.population;
+    stats.births = block.births;
+    stats.deaths = block.deaths;
+    stats.hash = (static_cast<uint64_t>(block.hashHi) << 32) | block.hashLo;
+    if (block.population > 0) {
+        stats.minX = block.minX;  stats.minY = block.minY;
+        stats.maxX = block.maxX;  stats.maxY = block.maxY;
+    }
+    ready.push_back(stats);
+}
@@ -0,0 +1,88 @@
+#include <vector>
+#include "gpu_universe_batch.h"
+
+GpuUniverseBatch::GpuUniverseBatch(const UniverseBatch& batch)
+    : shader(SHADER_PATH "batchStep.comp"), width(batch.width()), height(batch.height()), slices(batch.slices() * 2),
+      sliceWords(batch.sliceWords())
+{
+    glGenBuffers(2, cellsBufs);
+    glGenBuffers(1, &rulesBuf);
+    std::vector<GLuint> zeros(slices * sliceWords, 0);     // The border is never written, so both start all dead
+    for (GLuint buffer : cellsBufs) {
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, buffer);
+        glBufferData(GL_SHADER_STORAGE_BUFFER, zeros.size() * sizeof(GLuint), zeros.data(), GL_DYNAMIC_COPY);
+    }
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, rulesBuf);
+    glBufferData(GL_SHADER_STORAGE_BUFFER, slices * UniverseBatch::RULE_WORDS * sizeof(GLuint), NULL, GL_STATIC_DRAW);
+
+    shader.use();
+    shader.setInt_w_Name("numCellsX", width);
+    shader.setInt_w_Name("numCellsY", height);
+    sourceLoc = glGetUniformLocation(shader.ID, "source");
+    upload(batch);
+}
+
+GpuUniverseBatch::~GpuUniverseBatch()
+{
+    glDeleteBuffers(2, cellsBufs);
+    glDeleteBuffers(1, &rulesBuf);
+}
+
+void GpuUniverseBatch::upload(const UniverseBatch& batch)
+{
+    // Slice s of the batch -> slices 2s (its low 32 universes) & 2s + 1
+    std::vector<GLuint> words(slices * sliceWords);
+    for (int s = 0; s < batch.slices(); s++) {
+        const uint64_t* in = batch.words() + s * sliceWords;
+        GLuint* lo = words.data() + (2 * s) * sliceWords;
+        GLuint* hi = lo + sliceWords;
+        for (size_t i = 0; i < sliceWords; i++) {
+            lo[i] = static_cast<GLuint>(in[i]);
+            hi[i] = static_cast<GLuint>(in[i] >> 32);
+        }
+    }
+    currentBuf = 0;
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, cellsBufs[currentBuf]);
+    glBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, words.size() * sizeof(GLuint), words.data());
+
+    const int ruleWords = UniverseBatch::RULE_WORDS;
+    std::vector<GLuint> masks(slices * ruleWords);
+    for (int s = 0; s < batch.slices(); s++)
+        for (int i = 0; i < ruleWords; i++) {
+            uint64_t mask = batch.ruleMasks()[s * ruleWords + i];
+            masks[(2 * s) * ruleWords + i] = static_cast<GLuint>(mask);
+            masks[(2 * s + 1) * ruleWords + i] = static_cast<GLuint>(mask >> 32);
+        }
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, rulesBuf);
+    glBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, masks.size() * sizeof(GLuint), masks.data());
+}
+
+void GpuUniverseBatch::step(int generations)
+{
+    shader.use();
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, CELLS0_BINDING, cellsBufs[0]);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, CELLS1_BINDING, cellsBufs[1]);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, RULES_BINDING, rulesBuf);
+
+    for (int g = 0; g < generations; g++) {
+        shader.setInt_w_Loc(sourceLoc, currentBuf);
+        glDispatchCompute((width + 7) / 8, (height + 7) / 8, slices);
+        glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+        currentBuf ^= 1;
+    }
+}
+
+void GpuUniverseBatch::download(UniverseBatch& batch) const
+{
+    std::vector<GLuint> words(slices * sliceWords);
+    glMemoryBarrier(GL_BUFFER_UPDATE_BARRIER_BIT);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, cellsBufs[currentBuf]);
+    glGetBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, words.size() * sizeof(GLuint), words.data());
+
+    for (int s = 0; s < batch.slices(); s++) {
+        uint64_t* out = batch.words() + s * sliceWords;
+        const GLuint* lo = words.data() + (2 * s) * sliceWords;
+        const GLuint* hi = lo + sliceWords;
+        for (size_t i = 0; i < sliceWords; i++) out[i] = (static_cast<uint64_t>(hi[i]) << 32) | lo[i];
+    }
+}
@@ -0,0 +1,185 @@
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <cstring>
+#include "life_rule.h"
+#include "bit_utils.h"
+
+namespace {
+
+// Letters naming the arrangements of each neighbour count (a prefix of HENSEL_LETTERS)
+const int LETTER_COUNTS[9] = { 0, 2, 6, 10, 13, 10, 6, 2, 0 };
+
+// An arrangement for each letter of 1-4 neighbours, bits 0-7 = N, NE, E, SE, S, SW, W, NW. Those of 5-7
+// neighbours are the complements of 3-1's, with the same letters
+const uint8_t ARRANGEMENTS[5][13] = {
+    {},
+    { 0x02, 0x01 },
+    { 0x0a, 0x05, 0x09, 0x03, 0x11, 0x22 },
+    { 0x2a, 0x15, 0x25, 0x07, 0x83, 0x0b, 0x29, 0x23, 0x43, 0x13 },
+    { 0xaa, 0x55, 0x4b, 0x0f, 0x1b, 0x8b, 0x2b, 0x27, 0x53, 0x17, 0x93, 0x63, 0x33 },
+};
+
+// Letter (index into HENSEL_LETTERS) of each arrangement of the 8 neighbours
+const std::array<uint8_t, 256>& letterIndex()
+{
+    static const std::array<uint8_t, 256> index = [] {
+        std::array<uint8_t, 256> result{};
+        for (int n = 1; n <= 7; n++)
+            for (int k = 0; k < LETTER_COUNTS[n]; k++) {
+                unsigned ring = n <= 4 ? ARRANGEMENTS[n][k] : ~ARRANGEMENTS[8 - n][k] & 255u;
+                // Its 4 rotations (2 ring places each) & their mirror images
+                for (int r = 0; r < 8; r += 2) {
+                    unsigned rotated = ((ring << r) | (ring >> (8 - r))) & 255u, mirrored = 0;
+                    for (int i = 0; i < 8; i++)
+                        if ((rotated >> i) & 1) mirrored |= 1u << ((8 - i) & 7);
+                    result[rotated] = result[mirrored] = static_cast<uint8_t>(k);
+                }
+            }
+        return result;
+    }();
+    return index;
+}
+
+unsigned allLetters(int n)
+{
+    return LETTER_COUNTS[n] ? (1u << LETTER_COUNTS[n]) - 1 : 1u;
+}
+
+}
+
+bool LifeRule::parse(const std::string& ruleText)
+{
+    unsigned birth = 0, survive = 0;
+    std::array<uint16_t, 9> birthSets{}, surviveSets{};
+    int stateCount = 2;
+    bool hasLetters = false, hensel = false;
+
+    // The neighbourhood suffix, then the rest as for Moore rules
+    std::string text = ruleText.substr(0, ruleText.find_last_not_of(' ') + 1);
+    Neighbourhood hood = MOORE;
+    char suffix = text.empty() ? '\0' : static_cast<char>(std::toupper(static_cast<unsigned char>(text.back())));
+    if (suffix == 'H' || suffix == 'V') {
+        hood = suffix == 'H' ? HEXAGONAL : VON_NEUMANN;
+        text.pop_back();
+    }
+
+    for (char c : text) {
+        char u = static_cast<char>(std::toupper(static_cast<unsigned char>(c)));
+        if (u == 'B' || u == 'S' || u == 'C' || u == 'G')
+            hasLetters = true;
+    }
+
+    if (hasLetters) {
+        // "B3/S23": each digit belongs to the most recent B / S; C (or G) is followed by the state count
+        unsigned* target = nullptr;
+        std::array<uint16_t, 9>* targetSets = nullptr;
+        for (size_t i = 0; i < text.size(); i++) {
+            char u = static_cast<char>(std::toupper(static_cast<unsigned char>(text[i])));
+            if (u == 'B')                   { target = &birth;      targetSets = &birthSets; }
+            else if (u == 'S')              { target = &survive;    targetSets = &surviveSets; }
+            else if (u == 'C' || u == 'G') {
+                target = nullptr;
+                size_t digits = std::min(text.find_first_not_of("0123456789", i + 1), text.size());
+                if (digits == i + 1) return false;
+                stateCount = atoi(text.substr(i + 1, digits - i - 1).c_str());
+                i = digits - 1;
+            }
+            else if (u >= '0' && u <= '8') {
+                if (!target) return false;
+                int n = u - '0';
+                // Hensel letters after the digit: just those arrangements ("2ak"), or all but them ("2-a")
+                size_t j = i + 1;
+                bool negated = j < text.size() && text[j] == '-';
+                if (negated) j++;
+                unsigned chosen = 0;
+                for (; j < text.size() && text[j] && std::strchr(HENSEL_LETTERS, text[j]); j++) {
+                    int k = static_cast<int>(std::strchr(HENSEL_LETTERS, text[j]) - HENSEL_LETTERS);
+                    if (k >= LETTER_COUNTS[n]) return false;
+                    chosen |= 1u << k;
+                }
+                if (negated && !chosen) return false;
+                if (chosen) hensel = true;
+                (*targetSets)[n] |= static_cast<uint16_t>(!chosen ? allLetters(n) : negated ? allLetters(n) & ~chosen : chosen);
+                if ((*targetSets)[n]) *target |= 1u << n;
+                i = j - 1;
+            }
+            else if (u != '/' && u != ' ')  return false;
+        }
+    }
+    else {
+        // "23/3": survive digits, then birth digits, then the state count if there's a second slash
+        size_t slash = text.find('/');
+        if (slash == std::string::npos) return false;
+        size_t slash2 = text.find('/', slash + 1);
+        if (slash2 != std::string::npos) {
+            if (slash2 + 1 == text.size() || text.find_first_not_of("0123456789", slash2 + 1) != std::string::npos) return false;
+            stateCount = atoi(text.c_str() + slash2 + 1);
+        }
+        for (size_t i = 0; i < std::min(text.size(), slash2); i++) {
+            char c = text[i];
+            if (i == slash) continue;
+            if (c < '0' || c > '8') return false;
+            (i < slash ? survive : birth) |= 1u << (c - '0');
+        }
+    }
+    if (stateCount < 2 || stateCount > MAX_STATES) return false;
+
+    // Letters that pick every arrangement of each count they're used with are just a totalistic rule
+    bool partial = false;
+    for (int n = 0; n <= 8; n++)
+        partial |= (birthSets[n] && birthSets[n] != allLetters(n)) || (surviveSets[n] && surviveSets[n] != allLetters(n));
+    hensel = hensel && partial;
+    if (hensel && stateCount > 2) return false;
+    if (hood != MOORE) {
+        int most = hood == HEXAGONAL ? 6 : 4;
+        if (hensel || stateCount > 2 || (birth >> (most + 1)) || (survive >> (most + 1))) return false;
+    }
+
+    birthMask = birth;
+    surviveMask = survive;
+    states = stateCount;
+    neighbourhood = hood;
+    isotropic = hensel;
+    birthLetters = hensel ? birthSets : std::array<uint16_t, 9>{};
+    surviveLetters = hensel ? surviveSets : std::array<uint16_t, 9>{};
+    return true;
+}
+
+std::string LifeRule::toString() const
+{
+    auto counts = [&](unsigned mask, const std::array<uint16_t, 9>& letters) {
+        std::string s;
+        for (int n = 0; n <= 8; n++) {
+            if (!(mask & (1u << n))) continue;
+            s += static_cast<char>('0' + n);
+            if (!isotropic || letters[n] == allLetters(n)) continue;
+            // Whichever is shorter: the letters, or '-' & the ones left out
+            bool negated = 2 * popcount64(letters[n]) > LETTER_COUNTS[n];
+            if (negated) s += '-';
+            for (int k = 0; k < LETTER_COUNTS[n]; k++)
+                if (((letters[n] >> k) & 1) != negated) s += HENSEL_LETTERS[k];
+        }
+        return s;
+    };
+    std::string s = "B" + counts(birthMask, birthLetters) + "/S" + counts(surviveMask, surviveLetters);
+    if (states > 2) s += "/C" + std::to_string(states);
+    if (neighbourhood != MOORE) s += neighbourhood == HEXAGONAL ? "H" : "V";
+    return s;
+}
+
+std::array<uint64_t, 8> LifeRule::table() const
+{
+    // Ring bits in the neighbourhood: hexagonal leaves out SE & NW here (the board's NE & SW with north
+    // at +y, as in Golly once RLE rows are flipped), von Neumann the corners
+    const unsigned counted = neighbourhood == HEXAGONAL ? 0x77u : neighbourhood == VON_NEUMANN ? 0x55u : 0xffu;
+    std::array<uint64_t, 8> bits{};
+    for (unsigned i = 0; i < 512; i++) {
+        unsigned ring = i & 255u, n = popcount64(ring & counted);
+        bool alive = (i >> 8) != 0, next;
+        if (isotropic) next = (((alive ? surviveLetters : birthLetters)[n] >> letterIndex()[ring]) & 1) != 0;
+        else next = (((alive ? surviveMask : birthMask) >> n) & 1) != 0;
+        if (next) bits[i >> 6] |= 1ull << (i & 63);
+    }
+    return bits;
+}
@@ -0,0 +1,156 @@
+#include <algorithm>
+#include <thread>
+#include "ltl_engine.h"
+#include "cell_hash.h"
+
+namespace {
+
+const size_t MIN_CELLS_PER_THREAD = 1 << 16;
+
+}
+
+LtlEngine::LtlEngine(int threads)
+    : threads(threads > 0 ? threads : static_cast<int>(std::max(1u, std::thread::hardware_concurrency())))
+{
+}
+
+void LtlEngine::setRule(const LtlRule& rule)
+{
+    this->rule = rule;
+}
+
+void LtlEngine::loadCells(const std::vector<uint32_t>& cells, int width, int height)
+{
+    _width = width;
+    _height = height;
+    current.resize(static_cast<size_t>(width) * height);
+    for (size_t i = 0; i < current.size(); i++) current[i] = cells[i] != 0;
+    next.assign(current.size(), 0);
+    rowSums.assign(current.size(), 0);
+}
+
+void LtlEngine::toCells(std::vector<uint32_t>& cells) const
+{
+    cells.assign(current.begin(), current.end());
+}
+
+void LtlEngine::stamp(const PackedGridView& pattern, int x, int y, StampMode mode)
+{
+    int x0 = std::max(x, 0), x1 = std::min(x + pattern.width, _width);
+    int y0 = std::max(y, 0), y1 = std::min(y + pattern.height, _height);
+    for (int j = y0; j < y1; j++)
+        for (int i = x0; i < x1; i++) {
+            uint8_t& cell = current[static_cast<size_t>(j) * _width + i];
+            cell = static_cast<uint8_t>(stampCell(cell, pattern.get(i - x, j - y), mode));
+        }
+}
+
+void LtlEngine::step(GenerationStats* stats)
+{
+    size_t cells = static_cast<size_t>(_width) * _height;
+    int bands = static_cast<int>(std::min<size_t>(threads, std::max<size_t>(1, cells / MIN_CELLS_PER_THREAD)));
+    bands = std::max(1, std::min(bands, _height));
+
+    // Rows first: the column pass of a band reads row sums up to R rows outside it
+    std::vector<std::thread> workers;
+    for (int b = 1; b < bands; b++)
+        workers.emplace_back(&LtlEngine::sumRows, this, _height * b / bands, _height * (b + 1) / bands);
+    sumRows(0, _height / bands);
+    for (std::thread& t : workers) t.join();
+    workers.clear();
+
+    std::vector<GenerationStats> bandStats(bands);
+    std::vector<uint32_t> hashLo(bands, 0), hashHi(bands, 0);
+    for (int b = 1; b < bands; b++)
+        workers.emplace_back(&LtlEngine::stepRows, this, _height * b / bands, _height * (b + 1) / bands,
+                             std::ref(bandStats[b]), std::ref(hashLo[b]), std::ref(hashHi[b]), stats != nullptr);
+    stepRows(0, _height / bands, bandStats[0], hashLo[0], hashHi[0], stats != nullptr);
+    for (std::thread& t : workers) t.join();
+
+    std::swap(current, next);
+
+    if (stats) {
+        GenerationStats total;
+        uint32_t lo = 0, hi = 0;
+        for (int b = 0; b < bands; b++) {
+            addStats(total, bandStats[b]);
+            lo += hashLo[b];
+            hi += hashHi[b];
+        }
+        total.generation = stats->generation;
+        total.hash = (static_cast<uint64_t>(hi) << 32) | lo;
+        *stats = total;
+    }
+}
+
+void LtlEngine::sumRows(int y0, int y1)
+{
+    const int r = rule.range;
+    for (int y = y0; y < y1; y++) {
+        const uint8_t* row = current.data() + static_cast<size_t>(y) * _width;
+        uint16_t* sums = rowSums.data() + static_cast<size_t>(y) * _width;
+
+        // Window [x-R, x+R], clipped to the board (cells past its edges are dead)
+        int sum = 0;
+        for (int x = 0; x < std::min(r, _width); x++) sum += row[x];
+        for (int x = 0; x < _width; x++) {
+            if (x + r < _width) sum += row[x + r];
+            if (x - r - 1 >= 0) sum -= row[x - r - 1];
+            sums[x] = static_cast<uint16_t>(sum);
+        }
+    }
+}
+
+void LtlEngine::stepRows(int y0, int y1, GenerationStats& stats, uint32_t& hashLo, uint32_t& hashHi, bool hashing)
+{
+    const int r = rule.range;
+    const int self = rule.countsSelf ? 0 : 1;
+
+    // Column sums of the row sums over rows [y-R, y+R]: every cell's box count
+    std::vector<uint32_t> counts(_width, 0);
+    auto addRow = [&](int y, int sign) {
+        if (y < 0 || y >= _height) return;
+        const uint16_t* sums = rowSums.data() + static_cast<size_t>(y) * _width;
+        for (int x = 0; x < _width; x++) counts[x] += sign * sums[x];
+    };
+    for (int y = y0 - r; y < y0 + r; y++) addRow(y, 1);
+
+    for (int y = y0; y < y1; y++) {
+        addRow(y + r, 1);
+        const uint8_t* row = current.data() + static_cast<size_t>(y) * _width;
+        uint8_t* out = next.data() + static_cast<size_t>(y) * _width;
+        int minX = -1, maxX = -1;
+
+        for (int x = 0; x < _width; x++) {
+            int alive = row[x];
+            int count = static_cast<int>(counts[x]) - self * alive;
+            int result = alive ? (count >= rule.surviveMin && count <= rule.surviveMax)
+                               : (count >= rule.birthMin && count <= rule.birthMax);
+            out[x] = static_cast<uint8_t>(result);
+            if (!result) {
+                stats.deaths += alive;
+                continue;
+            }
+
+            stats.population++;
+            stats.births += !alive;
+            if (minX < 0) minX = x;
+            maxX = x;
+            if (hashing) {
+                uint32_t lo, hi;
+                cellHash(static_cast<uint32_t>(x), static_cast<uint32_t>(y), lo, hi);
+                hashLo += lo;
+                hashHi += hi;
+            }
+        }
+        addRow(y - r, -1);
+
+        if (minX < 0) continue;
+        if (stats.maxX < stats.minX) {
+            stats.minX = minX; stats.maxX = maxX; stats.minY = y;
+        }
+        stats.minX = std::min(stats.minX, minX);
+        stats.maxX = std::max(stats.maxX, maxX);
+        stats.maxY = y;
+    }
+}
@@ -0,0 +1,81 @@
+#include <cctype>
+#include <cstdlib>
+#include "ltl_rule.h"
+
+namespace {
+
+// Non-negative decimal number filling 'text'
+bool parseNumber(const std::string& text, int& value)
+{
+    if (text.empty() || text.size() > 9 || text.find_first_not_of("0123456789") != std::string::npos) return false;
+    value = atoi(text.c_str());
+    return true;
+}
+
+// "a..b", or "a" for a single count
+bool parseRange(const std::string& text, int& low, int& high)
+{
+    size_t dots = text.find("..");
+    if (dots == std::string::npos) {
+        if (!parseNumber(text, low)) return false;
+        high = low;
+        return true;
+    }
+    return parseNumber(text.substr(0, dots), low) && parseNumber(text.substr(dots + 2), high) && low <= high;
+}
+
+}
+
+bool LtlRule::parse(const std::string& text)
+{
+    LtlRule rule;
+    bool hasRange = false, hasBirth = false, hasSurvive = false;
+    size_t pos = 0;
+    while (pos <= text.size()) {
+        size_t comma = text.find(',', pos);
+        if (comma == std::string::npos) comma = text.size();
+        std::string token;
+        for (size_t i = pos; i < comma; i++)
+            if (text[i] != ' ') token += text[i];
+        pos = comma + 1;
+        if (token.empty()) return false;
+
+        char key = static_cast<char>(std::toupper(static_cast<unsigned char>(token[0])));
+        std::string value = token.substr(1);
+        int n;
+        if (key == 'R') {
+            if (!parseNumber(value, rule.range) || rule.range < 1 || rule.range > MAX_RANGE) return false;
+            hasRange = true;
+        }
+        else if (key == 'C') {
+            if (!parseNumber(value, n) || (n != 0 && n != 2)) return false;
+        }
+        else if (key == 'M') {
+            if (value != "0" && value != "1") return false;
+            rule.countsSelf = value == "1";
+        }
+        else if (key == 'S') {
+            if (!parseRange(value, rule.surviveMin, rule.surviveMax)) return false;
+            hasSurvive = true;
+        }
+        else if (key == 'B') {
+            if (!parseRange(value, rule.birthMin, rule.birthMax)) return false;
+            hasBirth = true;
+        }
+        else if (key == 'N') {
+            if (value != "M" && value != "m") return false;
+        }
+        else return false;
+    }
+    if (!hasRange || !hasBirth || !hasSurvive) return false;
+
+    *this = rule;
+    return true;
+}
+
+std::string LtlRule::toString() const
+{
+    return "R" + std::to_string(range) + ",C0,M" + (countsSelf ? "1" : "0") +
+           ",S" + std::to_string(surviveMin) + ".." + std::to_string(surviveMax) +
+           ",B" + std::to_string(birthMin) + ".." + std::to_string(birthMax) + ",NM";
+}
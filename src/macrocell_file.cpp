@@ -0,0 +1,152 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <vector>
+#include <unordered_map>
+#include "macrocell_file.h"
+
+namespace {
+
+// Leaf rows are listed top to bottom; QuadTree leaves keep row 0 at the bottom
+uint64_t parseLeaf(const char* line)
+{
+    uint64_t bits = 0;
+    int row = 7, x = 0;
+    for (const char* c = line; *c && row >= 0; c++) {
+        if (*c == '*' && x < 8)     bits |= 1ull << (row * 8 + x);
+        if (*c == '$')              { row--; x = 0; }
+        else if (*c == '.' || *c == '*') x++;
+    }
+    return bits;
+}
+
+void writeLeaf(FILE* file, uint64_t bits)
+{
+    // Rows after the last live one are left out, as are dead cells after the last live one in a row
+    int lastRow = 0;
+    for (int y = 7; y >= 0; y--)
+        if ((bits >> (y * 8)) & 0xFF) lastRow = 7 - y;
+
+    char line[80];
+    int len = 0;
+    for (int r = 0; r <= lastRow; r++) {
+        uint64_t row = (bits >> ((7 - r) * 8)) & 0xFF;
+        for (int x = 0; x < 8 && (row >> x); x++)
+            line[len++] = ((row >> x) & 1) ? '*' : '.';
+        line[len++] = '$';
+    }
+    line[len++] = '\n';
+    fwrite(line, 1, len, file);
+}
+
+}
+
+bool MacrocellFile::load(const std::string& path, QuadTree& tree, std::string* rule, unsigned long long* generation)
+{
+    FILE* file = fopen(path.c_str(), "rb");
+    if (!file) {
+        std::cout << "ERROR::MACROCELL::FILE_NOT_FOUND: " << path << std::endl;
+        return false;
+    }
+    std::vector<char> ioBuffer(1 << 20);
+    setvbuf(file, ioBuffer.data(), _IOFBF, ioBuffer.size());
+
+    tree.clear();
+    std::vector<QuadTree::NodeId> lineNodes(1, QuadTree::EMPTY);  // Node line number -> id (line 0 = empty)
+    std::vector<uint8_t> lineLevels(1, 0);
+
+    char line[1024];
+    bool ok = true;
+    while (ok && fgets(line, sizeof(line), file)) {
+        char c = line[0];
+        if (c == '[' || c == '\n' || c == '\r') continue;
+        if (c == '#') {
+            if (line[1] == 'R' && rule) {
+                *rule = line + 2;
+                rule->erase(0, rule->find_first_not_of(" \t"));
+                rule->erase(rule->find_last_not_of(" \t\r\n") + 1);
+            }
+            if (line[1] == 'G' && generation) *generation = strtoull(line + 2, NULL, 10);
+            continue;
+        }
+
+        if (c == '.' || c == '*' || c == '$') {
+            lineNodes.push_back(tree.leaf(parseLeaf(line)));
+            lineLevels.push_back(QuadTree::LEAF_LEVEL);
+            continue;
+        }
+
+        unsigned long level, child[4];
+        if (sscanf(line, "%lu %lu %lu %lu %lu", &level, &child[0], &child[1], &child[2], &child[3]) != 5) {
+            std::cout << "ERROR::MACROCELL::BAD_LINE: " << line;
+            ok = false;
+            break;
+        }
+        if (level <= QuadTree::LEAF_LEVEL || level > 62) {
+            std::cout << "ERROR::MACROCELL::UNSUPPORTED_LEVEL (multi-state files aren't supported): " << line;
+            ok = false;
+            break;
+        }
+
+        QuadTree::NodeId ids[4];
+        for (int i = 0; i < 4 && ok; i++) {
+            if (child[i] >= lineNodes.size() || (child[i] != 0 && lineLevels[child[i]] != level - 1)) {
+                std::cout << "ERROR::MACROCELL::BAD_CHILD_REFERENCE: " << line;
+                ok = false;
+            }
+            else ids[i] = lineNodes[child[i]];
+        }
+        if (!ok) break;
+        lineNodes.push_back(tree.node(static_cast<int>(level), ids[0], ids[1], ids[2], ids[3]));
+        lineLevels.push_back(static_cast<uint8_t>(level));
+    }
+    fclose(file);
+    if (!ok) return false;
+
+    // The last node is the root
+    if (lineNodes.size() > 1) tree.setRoot(lineNodes.back(), lineLevels.back());
+    return true;
+}
+
+bool MacrocellFile::save(const std::string& path, const QuadTree& tree, const std::string& rule, unsigned long long generation)
+{
+    FILE* file = fopen(path.c_str(), "wb");
+    if (!file) return false;
+
+    fprintf(file, "[M2] (gameOLifeGL)\n#R %s\n", rule.c_str());
+    if (generation) fprintf(file, "#G %llu\n", generation);
+
+    // Post-order walk numbering each distinct node once; an explicit stack keeps deep trees off the call stack
+    std::unordered_map<QuadTree::NodeId, unsigned long> lineOf;
+    lineOf[QuadTree::EMPTY] = 0;
+    unsigned long nextLine = 1;
+
+    std::vector<std::pair<QuadTree::NodeId, bool>> stack;   // (node, children already pushed)
+    if (tree.root() != QuadTree::EMPTY) stack.push_back({ tree.root(), false });
+    while (!stack.empty()) {
+        auto [id, expanded] = stack.back();
+        if (lineOf.count(id)) {
+            stack.pop_back();
+            continue;
+        }
+        const QuadTree::Node& n = tree.get(id);
+        if (n.level == QuadTree::LEAF_LEVEL) {
+            writeLeaf(file, n.leafBits);
+            lineOf[id] = nextLine++;
+            stack.pop_back();
+        }
+        else if (!expanded) {
+            stack.back().second = true;
+            for (QuadTree::NodeId child : { n.se, n.sw, n.ne, n.nw })
+                if (!lineOf.count(child)) stack.push_back({ child, false });
+        }
+        else {
+            fprintf(file, "%d %lu %lu %lu %lu\n", n.level, lineOf[n.nw], lineOf[n.ne], lineOf[n.sw], lineOf[n.se]);
+            lineOf[id] = nextLine++;
+            stack.pop_back();
+        }
+    }
+
+    return fclose(file) == 0;
+}
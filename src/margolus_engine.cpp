@@ -0,0 +1,210 @@
+#include <algorithm>
+#include <thread>
+#include "margolus_engine.h"
+#include "cell_hash.h"
+
+// The byte shuffle path: compiled for SSSE3 function by function, so the rest of the build keeps its baseline
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#include <tmmintrin.h>
+#define MARGOLUS_SHUFFLE 1
+#define SSSE3_FUNCTION __attribute__((target("ssse3")))
+#elif defined(_M_X64)
+#include <intrin.h>
+#define MARGOLUS_SHUFFLE 1
+#define SSSE3_FUNCTION
+#endif
+
+namespace {
+
+const size_t MIN_CELLS_PER_THREAD = 1 << 16;
+
+// One block: its cells' weights index the table, & the entry's bits go back to the same cells
+inline void stepBlock(uint8_t* upper, uint8_t* lower, const uint8_t* table)
+{
+    uint8_t out = table[upper[0] | upper[1] << 1 | lower[0] << 2 | lower[1] << 3];
+    upper[0] = out & 1;     upper[1] = (out >> 1) & 1;
+    lower[0] = (out >> 2) & 1;  lower[1] = out >> 3;
+}
+
+#ifdef MARGOLUS_SHUFFLE
+bool cpuHasShuffle()
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_cpu_supports("ssse3");
+#else
+    return true;    // Every x64 CPU MSVC still targets
+#endif
+}
+
+// 16 blocks a loop: read as 16 bit lanes, a block's row is (left cell | right cell << 8), which folds to
+// left + 2 right; the two rows' lanes make the index & pack down to bytes, & pshufb looks all 16 up in the
+// table. The results are widened back to lanes & their bits spread over the cells. Returns the blocks done
+SSSE3_FUNCTION int shuffleBlocks(uint8_t* upper, uint8_t* lower, int blocks, const uint8_t* table)
+{
+    const __m128i lut = _mm_loadu_si128(reinterpret_cast<const __m128i*>(table));
+    const __m128i three = _mm_set1_epi16(3), one = _mm_set1_epi16(1), zero = _mm_setzero_si128();
+    int done = 0;
+    for (; done + 16 <= blocks; done += 16) {
+        __m128i* u = reinterpret_cast<__m128i*>(upper + 2 * done);
+        __m128i* l = reinterpret_cast<__m128i*>(lower + 2 * done);
+        __m128i u0 = _mm_loadu_si128(u), u1 = _mm_loadu_si128(u + 1);
+        __m128i l0 = _mm_loadu_si128(l), l1 = _mm_loadu_si128(l + 1);
+
+        __m128i index0 = _mm_or_si128(_mm_and_si128(_mm_or_si128(u0, _mm_srli_epi16(u0, 7)), three),
+                                      _mm_slli_epi16(_mm_and_si128(_mm_or_si128(l0, _mm_srli_epi16(l0, 7)), three), 2));
+        __m128i index1 = _mm_or_si128(_mm_and_si128(_mm_or_si128(u1, _mm_srli_epi16(u1, 7)), three),
+                                      _mm_slli_epi16(_mm_and_si128(_mm_or_si128(l1, _mm_srli_epi16(l1, 7)), three), 2));
+        __m128i out = _mm_shuffle_epi8(lut, _mm_packus_epi16(index0, index1));
+
+        __m128i out0 = _mm_unpacklo_epi8(out, zero), out1 = _mm_unpackhi_epi8(out, zero);
+        // Upper row: bit 0 to the left cell, bit 1 to the right (bit 8); lower row: bits 2 & 3
+        _mm_storeu_si128(u, _mm_or_si128(_mm_and_si128(out0, one), _mm_slli_epi16(_mm_and_si128(_mm_srli_epi16(out0, 1), one), 8)));
+        _mm_storeu_si128(u + 1, _mm_or_si128(_mm_and_si128(out1, one), _mm_slli_epi16(_mm_and_si128(_mm_srli_epi16(out1, 1), one), 8)));
+        _mm_storeu_si128(l, _mm_or_si128(_mm_and_si128(_mm_srli_epi16(out0, 2), one), _mm_slli_epi16(_mm_srli_epi16(out0, 3), 8)));
+        _mm_storeu_si128(l + 1, _mm_or_si128(_mm_and_si128(_mm_srli_epi16(out1, 2), one), _mm_slli_epi16(_mm_srli_epi16(out1, 3), 8)));
+    }
+    return done;
+}
+#endif
+
+}
+
+MargolusEngine::MargolusEngine(int threads)
+    : threads(threads > 0 ? threads : static_cast<int>(std::max(1u, std::thread::hardware_concurrency())))
+{
+    setShuffle(true);
+    setRule(rule);
+}
+
+void MargolusEngine::setShuffle(bool on)
+{
+#ifdef MARGOLUS_SHUFFLE
+    shuffle = on && cpuHasShuffle();
+#else
+    (void)on;
+    shuffle = false;
+#endif
+}
+
+void MargolusEngine::setRule(const MargolusRule& rule)
+{
+    this->rule = rule;
+    forwardTable = rule.table;
+    backwardTable = rule.inverse();
+}
+
+void MargolusEngine::loadCells(const std::vector<uint32_t>& cells, int width, int height)
+{
+    _width = width;
+    _height = height;
+    current.resize(static_cast<size_t>(width) * height);
+    for (size_t i = 0; i < current.size(); i++) current[i] = cells[i] != 0;
+    _time = 0;
+}
+
+void MargolusEngine::toCells(std::vector<uint32_t>& cells) const
+{
+    cells.assign(current.begin(), current.end());
+}
+
+void MargolusEngine::stamp(const PackedGridView& pattern, int x, int y, StampMode mode)
+{
+    int x0 = std::max(x, 0), x1 = std::min(x + pattern.width, _width);
+    int y0 = std::max(y, 0), y1 = std::min(y + pattern.height, _height);
+    for (int j = y0; j < y1; j++)
+        for (int i = x0; i < x1; i++) {
+            uint8_t& cell = current[static_cast<size_t>(j) * _width + i];
+            cell = static_cast<uint8_t>(stampCell(cell, pattern.get(i - x, j - y), mode));
+        }
+}
+
+void MargolusEngine::step(bool backward, GenerationStats* stats)
+{
+    if (backward && !rule.reversible()) return;
+    if (stats) previous = current;
+
+    // Undoing a step cuts the board as that step did: the partition before it
+    if (backward) _time--;
+    const int offset = static_cast<int>(_time & 1);
+    const uint8_t* table = backward ? backwardTable.data() : forwardTable.data();
+    if (!backward) _time++;
+
+    const int pairs = std::max(0, (_height - offset) / 2);
+    size_t cells = static_cast<size_t>(_width) * _height;
+    int bands = static_cast<int>(std::min<size_t>(threads, std::max<size_t>(1, cells / MIN_CELLS_PER_THREAD)));
+    bands = std::max(1, std::min(bands, pairs));
+
+    std::vector<std::thread> workers;
+    for (int b = 1; b < bands; b++)
+        workers.emplace_back(&MargolusEngine::stepPairs, this, pairs * b / bands, pairs * (b + 1) / bands, offset, table);
+    stepPairs(0, pairs / bands, offset, table);
+    for (std::thread& t : workers) t.join();
+
+    if (!stats) return;
+    bands = std::max(1, std::min(bands, _height));
+    std::vector<GenerationStats> bandStats(bands);
+    std::vector<uint32_t> hashLo(bands, 0), hashHi(bands, 0);
+    workers.clear();
+    for (int b = 1; b < bands; b++)
+        workers.emplace_back(&MargolusEngine::statsRows, this, _height * b / bands, _height * (b + 1) / bands,
+                             std::ref(bandStats[b]), std::ref(hashLo[b]), std::ref(hashHi[b]));
+    statsRows(0, _height / bands, bandStats[0], hashLo[0], hashHi[0]);
+    for (std::thread& t : workers) t.join();
+
+    GenerationStats total;
+    uint32_t lo = 0, hi = 0;
+    for (int b = 0; b < bands; b++) {
+        addStats(total, bandStats[b]);
+        lo += hashLo[b];
+        hi += hashHi[b];
+    }
+    total.generation = stats->generation;
+    total.hash = (static_cast<uint64_t>(hi) << 32) | lo;
+    if (_time & 1) total.hash = ~total.hash;
+    *stats = total;
+}
+
+// Row pairs [pair0, pair1) of the partition 'offset' cells in from the bottom-left corner
+void MargolusEngine::stepPairs(int pair0, int pair1, int offset, const uint8_t* table)
+{
+    const int blocks = (_width - offset) / 2;
+    for (int p = pair0; p < pair1; p++) {
+        int y = offset + 2 * p;
+        uint8_t* lower = current.data() + static_cast<size_t>(y) * _width + offset;
+        uint8_t* upper = lower + _width;
+        int done = 0;
+#ifdef MARGOLUS_SHUFFLE
+        if (shuffle) done = shuffleBlocks(upper, lower, blocks, table);
+#endif
+        for (int b = done; b < blocks; b++) stepBlock(upper + 2 * b, lower + 2 * b, table);
+    }
+}
+
+void MargolusEngine::statsRows(int y0, int y1, GenerationStats& stats, uint32_t& hashLo, uint32_t& hashHi)
+{
+    for (int y = y0; y < y1; y++) {
+        const uint8_t* row = current.data() + static_cast<size_t>(y) * _width;
+        const uint8_t* was = previous.data() + static_cast<size_t>(y) * _width;
+        int minX = -1, maxX = -1;
+        for (int x = 0; x < _width; x++) {
+            stats.births += row[x] & !was[x];
+            stats.deaths += was[x] & !row[x];
+            if (!row[x]) continue;
+            stats.population++;
+            if (minX < 0) minX = x;
+            maxX = x;
+            uint32_t lo, hi;
+            cellHash(static_cast<uint32_t>(x), static_cast<uint32_t>(y), lo, hi);
+            hashLo += lo;
+            hashHi += hi;
+        }
+
+        if (minX < 0) continue;
+        if (stats.maxX < stats.minX) {
+            stats.minX = minX; stats.maxX = maxX; stats.minY = y;
+        }
+        stats.minX = std::min(stats.minX, minX);
+        stats.maxX = std::max(stats.maxX, maxX);
+        stats.maxY = y;
+    }
+}
@@ -0,0 +1,68 @@
+#include <cctype>
+#include <cstdlib>
+#include "margolus_rule.h"
+
+namespace {
+
+struct NamedRule {
+    const char* name;
+    const char* table;
+};
+const NamedRule NAMED_RULES[] = {
+    { "bbm",        "MS,D0;8;4;3;2;5;9;7;1;6;10;11;12;13;14;15" },
+    { "critters",   "MS,D15;14;13;3;11;5;6;1;7;9;10;2;12;4;8;0" },
+    { "tron",       "MS,D15;1;2;3;4;5;6;7;8;9;10;11;12;13;14;0" },
+};
+
+}
+
+bool MargolusRule::parse(const std::string& text)
+{
+    std::string spec;
+    for (char c : text)
+        if (c != ' ') spec += static_cast<char>(std::toupper(static_cast<unsigned char>(c)));
+
+    for (const NamedRule& named : NAMED_RULES) {
+        std::string name = named.name;
+        for (char& c : name) c = static_cast<char>(std::toupper(static_cast<unsigned char>(c)));
+        if (spec == name) return parse(named.table);
+    }
+
+    if (spec.compare(0, 4, "MS,D") != 0) return false;
+    std::array<uint8_t, 16> parsed;
+    size_t pos = 4;
+    for (int i = 0; i < 16; i++) {
+        size_t end = spec.find(';', pos);
+        if ((end == std::string::npos) != (i == 15)) return false;
+        std::string entry = spec.substr(pos, end == std::string::npos ? std::string::npos : end - pos);
+        if (entry.empty() || entry.size() > 2 || entry.find_first_not_of("0123456789") != std::string::npos) return false;
+        int value = atoi(entry.c_str());
+        if (value > 15) return false;
+        parsed[i] = static_cast<uint8_t>(value);
+        pos = end + 1;
+    }
+
+    table = parsed;
+    return true;
+}
+
+std::string MargolusRule::toString() const
+{
+    std::string text = "MS,D";
+    for (int i = 0; i < 16; i++) text += (i ? ";" : "") + std::to_string(table[i]);
+    return text;
+}
+
+bool MargolusRule::reversible() const
+{
+    unsigned seen = 0;
+    for (uint8_t out : table) seen |= 1u << out;
+    return seen == 0xffffu;
+}
+
+std::array<uint8_t, 16> MargolusRule::inverse() const
+{
+    std::array<uint8_t, 16> back = {};
+    for (int i = 0; i < 16; i++) back[table[i]] = static_cast<uint8_t>(i);
+    return back;
+}
@@ -0,0 +1,468 @@
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <iostream>
+#include <numeric>
+#include <thread>
+#include "object_census.h"
+#include "cpu_life_engine.h"
+#include "bit_utils.h"
+
+namespace {
+
+const size_t MIN_CELLS_PER_THREAD = 1 << 18;
+const char WECHSLER_DIGITS[] = "0123456789abcdefghijklmnopqrstuvwxyz";
+const int CLUSTER_REACH = 2;    // Cells this close (Chebyshev distance) can interact
+
+int findRoot(int* parent, int i)
+{
+    while (parent[i] != i) {
+        parent[i] = parent[parent[i]];     // Path halving
+        i = parent[i];
+    }
+    return i;
+}
+
+// The lower index becomes the root, so labels come out the same whatever the banding
+void unite(int* parent, int a, int b)
+{
+    a = findRoot(parent, a);
+    b = findRoot(parent, b);
+    if (a < b) parent[b] = a;
+    else if (b < a) parent[a] = b;
+}
+
+// Joins the runs of two rows that come within CLUSTER_REACH of each other
+template <typename Run>
+void joinRows(const Run* runs, int* parent, size_t a, size_t aEnd, size_t b, size_t bEnd)
+{
+    while (a < aEnd && b < bEnd) {
+        if (runs[a].x1 + CLUSTER_REACH < runs[b].x0)        a++;
+        else if (runs[b].x1 + CLUSTER_REACH < runs[a].x0)   b++;
+        else {
+            unite(parent, static_cast<int>(a), static_cast<int>(b));
+            if (runs[a].x1 < runs[b].x1) a++;
+            else b++;
+        }
+    }
+}
+
+// ... & the runs of one row that do
+template <typename Run>
+void joinRow(const Run* runs, int* parent, size_t a, size_t aEnd)
+{
+    for (size_t i = a + 1; i < aEnd; i++)
+        if (runs[i].x0 - runs[i - 1].x1 <= CLUSTER_REACH) unite(parent, static_cast<int>(i - 1), static_cast<int>(i));
+}
+
+// Period of an apgcode'd object (1 for still lifes, 0 if it has none)
+int codePeriod(const std::string& code)
+{
+    if (code.compare(0, 2, "xs") == 0) return 1;
+    if (code.compare(0, 2, "xp") == 0 || code.compare(0, 2, "xq") == 0) return atoi(code.c_str() + 2);
+    return 0;
+}
+
+}
+
+ObjectCensus::ObjectCensus(int threads)
+    : threads(threads > 0 ? threads : static_cast<int>(std::max(1u, std::thread::hardware_concurrency())))
+{
+}
+
+void ObjectCensus::setRule(const LifeRule& newRule)
+{
+    rule = newRule;
+    pieceCache.clear();
+}
+
+void ObjectCensus::clear()
+{
+    _objects.clear();
+    _table.clear();
+}
+
+void ObjectCensus::merge(const ObjectCensus& other)
+{
+    for (const auto& [code, count] : other._table) _table[code] += count;
+}
+
+void ObjectCensus::extractRuns(const PackedGrid& grid, int y0, int y1, std::vector<Run>& runs, std::vector<size_t>& rowStart)
+{
+    const size_t words = grid.usedWordsPerRow();
+    for (int y = y0; y < y1; y++) {
+        rowStart.push_back(runs.size());
+        const size_t firstRun = runs.size();
+        const uint64_t* row = grid.row(y);
+        for (size_t w = 0; w < words; w++) {
+            uint64_t bits = row[w];
+            while (bits) {
+                int start = countTrailingZeros64(bits);
+                uint64_t rest = ~(bits >> start);
+                int length = rest ? countTrailingZeros64(rest) : 64 - start;
+                int x0 = static_cast<int>(w * 64) + start;
+
+                // Runs crossing a word boundary continue the previous one
+                if (runs.size() > firstRun && runs.back().x1 == x0 - 1) runs.back().x1 = x0 + length - 1;
+                else runs.push_back({ y, x0, x0 + length - 1 });
+
+                bits = start + length >= 64 ? 0 : bits & (~0ull << (start + length));
+            }
+        }
+    }
+    rowStart.push_back(runs.size());
+}
+
+int ObjectCensus::label(const PackedGrid& grid, std::vector<Run>& runs, std::vector<int>& component) const
+{
+    const int height = grid.height();
+    size_t cells = static_cast<size_t>(grid.width()) * height;
+    int bands = static_cast<int>(std::min<size_t>(threads, std::max<size_t>(1, cells / MIN_CELLS_PER_THREAD)));
+    bands = std::max(1, std::min(bands, height));
+
+    // Each band finds its runs & joins them up on its own
+    std::vector<std::vector<Run>> bandRuns(bands);
+    std::vector<std::vector<size_t>> bandRowStart(bands);
+    std::vector<std::vector<int>> bandParent(bands);
+    auto labelBand = [&](int b) {
+        extractRuns(grid, height * b / bands, height * (b + 1) / bands, bandRuns[b], bandRowStart[b]);
+        std::vector<int>& parent = bandParent[b];
+        parent.resize(bandRuns[b].size());
+        std::iota(parent.begin(), parent.end(), 0);
+        const std::vector<size_t>& rowStart = bandRowStart[b];
+        const Run* bandRunData = bandRuns[b].data();
+        for (size_t r = 0; r + 1 < rowStart.size(); r++) {
+            joinRow(bandRunData, parent.data(), rowStart[r], rowStart[r + 1]);
+            for (size_t above = 1; above <= CLUSTER_REACH && above <= r; above++)
+                joinRows(bandRunData, parent.data(), rowStart[r - above], rowStart[r - above + 1], rowStart[r], rowStart[r + 1]);
+        }
+    };
+    std::vector<std::thread> workers;
+    for (int b = 1; b < bands; b++) workers.emplace_back(labelBand, b);
+    labelBand(0);
+    for (std::thread& t : workers) t.join();
+
+    // Concatenate, then join the rows within reach across each seam
+    runs.clear();
+    std::vector<int> parent;
+    std::vector<size_t> rowStart;       // Of every row, + the end
+    for (int b = 0; b < bands; b++) {
+        int offset = static_cast<int>(runs.size());
+        runs.insert(runs.end(), bandRuns[b].begin(), bandRuns[b].end());
+        for (int p : bandParent[b]) parent.push_back(p + offset);
+        for (size_t r = 0; r + 1 < bandRowStart[b].size(); r++) rowStart.push_back(bandRowStart[b][r] + offset);
+    }
+    rowStart.push_back(runs.size());
+    for (int b = 1; b < bands; b++) {
+        int seam = height * b / bands;
+        for (int below = seam; below < seam + CLUSTER_REACH && below < height; below++)
+            for (int above = std::max(0, below - CLUSTER_REACH); above < seam; above++)
+                joinRows(runs.data(), parent.data(), rowStart[above], rowStart[above + 1], rowStart[below], rowStart[below + 1]);
+    }
+
+    // Roots -> dense component ids, in order of first appearance
+    component.assign(runs.size(), -1);
+    int count = 0;
+    for (size_t i = 0; i < runs.size(); i++) {
+        int root = findRoot(parent.data(), static_cast<int>(i));
+        if (component[root] < 0) component[root] = count++;
+        component[i] = component[root];
+    }
+    return count;
+}
+
+void ObjectCensus::take(const PackedGrid& grid)
+{
+    std::vector<Run> runs;
+    std::vector<int> cluster;
+    int count = label(grid, runs, cluster);
+
+    // Cluster bounding boxes, & runs grouped by cluster (counting sort) as others can lie inside one's box
+    struct Box { int minX, minY, maxX, maxY; };
+    std::vector<Box> boxes(count, Box{ grid.width(), grid.height(), -1, -1 });
+    std::vector<size_t> runStart(count + 1, 0);
+    for (size_t i = 0; i < runs.size(); i++) {
+        Box& box = boxes[cluster[i]];
+        const Run& run = runs[i];
+        box.minX = std::min(box.minX, run.x0);   box.maxX = std::max(box.maxX, run.x1);
+        box.minY = std::min(box.minY, run.y);    box.maxY = std::max(box.maxY, run.y);
+        runStart[cluster[i] + 1]++;
+    }
+    std::partial_sum(runStart.begin(), runStart.end(), runStart.begin());
+    std::vector<size_t> fill(runStart.begin(), runStart.end() - 1), order(runs.size());
+    for (size_t i = 0; i < runs.size(); i++) order[fill[cluster[i]]++] = i;
+
+    // Clusters not seen before are collected first & then classified in parallel
+    std::vector<std::string> keys(count);
+    std::unordered_map<std::string, size_t> newShapes;     // Key -> index in 'pending'
+    std::vector<Bitmap> pending;
+    Bitmap bitmap;
+    for (int c = 0; c < count; c++) {
+        const Box& box = boxes[c];
+        bitmap.width = box.maxX - box.minX + 1;
+        bitmap.height = box.maxY - box.minY + 1;
+        bitmap.cells.assign(static_cast<size_t>(bitmap.width) * bitmap.height, 0);
+        for (size_t k = runStart[c]; k < runStart[c + 1]; k++) {
+            const Run& run = runs[order[k]];
+            uint8_t* row = bitmap.cells.data() + static_cast<size_t>(box.maxY - run.y) * bitmap.width;
+            std::fill(row + run.x0 - box.minX, row + run.x1 - box.minX + 1, 1);
+        }
+
+        std::string& key = keys[c];
+        key.assign(reinterpret_cast<const char*>(&bitmap.width), sizeof(int));
+        key.append(bitmap.cells.begin(), bitmap.cells.end());
+        if (!pieceCache.count(key) && newShapes.emplace(key, pending.size()).second) pending.push_back(bitmap);
+    }
+
+    std::vector<std::vector<Piece>> classified(pending.size());
+    std::atomic<size_t> nextShape{0};
+    auto classifyShapes = [&]() {
+        for (size_t i = nextShape++; i < pending.size(); i = nextShape++) classified[i] = classifyCluster(pending[i]);
+    };
+    std::vector<std::thread> workers;
+    for (size_t t = 1; t < std::min<size_t>(threads, pending.size()); t++) workers.emplace_back(classifyShapes);
+    classifyShapes();
+    for (std::thread& t : workers) t.join();
+    for (const auto& [key, index] : newShapes) pieceCache.emplace(key, std::move(classified[index]));
+
+    _objects.clear();
+    for (int c = 0; c < count; c++) {
+        const Box& box = boxes[c];
+        for (const Piece& piece : pieceCache[keys[c]]) {
+            int maxY = box.maxY - piece.y;
+            _objects.push_back({ piece.code, box.minX + piece.x, maxY - piece.height + 1, box.minX + piece.x + piece.width - 1, maxY, piece.population });
+            _table[piece.code]++;
+        }
+    }
+}
+
+std::vector<ObjectCensus::Piece> ObjectCensus::splitParts(const Bitmap& cluster, std::vector<Bitmap>& parts)
+{
+    // Flood fill, 8-connected
+    std::vector<int> part(cluster.cells.size(), -1);
+    std::vector<Piece> pieces;
+    std::vector<int> stack;
+    for (int start = 0; start < static_cast<int>(cluster.cells.size()); start++) {
+        if (!cluster.cells[start] || part[start] >= 0) continue;
+        int id = static_cast<int>(pieces.size());
+        Piece piece{ std::string(), cluster.width, cluster.height, -1, -1, 0 };    // Box as min/max until the end
+        part[start] = id;
+        stack.push_back(start);
+        while (!stack.empty()) {
+            int i = stack.back();
+            stack.pop_back();
+            int x = i % cluster.width, y = i / cluster.width;
+            piece.x = std::min(piece.x, x);  piece.width = std::max(piece.width, x);
+            piece.y = std::min(piece.y, y);  piece.height = std::max(piece.height, y);
+            piece.population++;
+            for (int ny = std::max(0, y - 1); ny <= std::min(cluster.height - 1, y + 1); ny++)
+                for (int nx = std::max(0, x - 1); nx <= std::min(cluster.width - 1, x + 1); nx++) {
+                    int n = ny * cluster.width + nx;
+                    if (cluster.cells[n] && part[n] < 0) {
+                        part[n] = id;
+                        stack.push_back(n);
+                    }
+                }
+        }
+        piece.width = piece.width - piece.x + 1;
+        piece.height = piece.height - piece.y + 1;
+        pieces.push_back(piece);
+    }
+
+    parts.assign(pieces.size(), Bitmap());
+    for (size_t p = 0; p < pieces.size(); p++) {
+        parts[p].width = pieces[p].width;
+        parts[p].height = pieces[p].height;
+        parts[p].cells.assign(static_cast<size_t>(pieces[p].width) * pieces[p].height, 0);
+    }
+    for (int i = 0; i < static_cast<int>(cluster.cells.size()); i++) {
+        if (part[i] < 0) continue;
+        const Piece& piece = pieces[part[i]];
+        int x = i % cluster.width - piece.x, y = i / cluster.width - piece.y;
+        parts[part[i]].cells[y * piece.width + x] = 1;
+    }
+    return pieces;
+}
+
+std::vector<ObjectCensus::Piece> ObjectCensus::classifyCluster(const Bitmap& cluster) const
+{
+    std::vector<Bitmap> parts;
+    std::vector<Piece> pieces = splitParts(cluster, parts);
+
+    // Parts are objects in their own right if each one is & they don't interfere over their common period
+    bool apart = pieces.size() > 1;
+    long long commonPeriod = 1;
+    for (size_t p = 0; p < pieces.size() && apart; p++) {
+        pieces[p].code = classify(parts[p]);
+        int period = codePeriod(pieces[p].code);
+        if (period == 0) apart = false;
+        else commonPeriod = std::min<long long>(MAX_PERIOD, commonPeriod / std::gcd<long long>(commonPeriod, period) * period);
+    }
+    if (apart && evolvesApart(cluster, pieces, parts, static_cast<int>(commonPeriod))) return pieces;
+
+    int population = 0;
+    for (uint8_t cell : cluster.cells) population += cell;
+    return { Piece{ classify(cluster), 0, 0, cluster.width, cluster.height, static_cast<uint32_t>(population) } };
+}
+
+bool ObjectCensus::evolvesApart(const Bitmap& cluster, const std::vector<Piece>& pieces, const std::vector<Bitmap>& parts, int generations) const
+{
+    const int margin = generations + 2;
+    PackedGrid board(cluster.width + 2 * margin, cluster.height + 2 * margin);
+    paint(cluster, board, margin, margin);
+    CpuLifeEngine whole(1);
+    whole.setRule(rule);
+    whole.load(board);
+
+    std::vector<CpuLifeEngine> alone(parts.size(), CpuLifeEngine(1));
+    for (size_t p = 0; p < parts.size(); p++) {
+        board.clear();
+        paint(parts[p], board, margin + pieces[p].x, margin + cluster.height - pieces[p].y - pieces[p].height);
+        alone[p].setRule(rule);
+        alone[p].load(board);
+    }
+
+    const size_t words = board.usedWordsPerRow();
+    for (int t = 0; t < generations; t++) {
+        whole.step();
+        for (CpuLifeEngine& engine : alone) engine.step();
+        for (int y = 0; y < board.height(); y++)
+            for (size_t w = 0; w < words; w++) {
+                uint64_t united = 0;
+                for (const CpuLifeEngine& engine : alone) united |= engine.board().row(y)[w];
+                if (united != whole.board().row(y)[w]) return false;
+            }
+    }
+    return true;
+}
+
+// Bitmap row 0 is the top: it goes to grid row y + height - 1
+void ObjectCensus::paint(const Bitmap& bitmap, PackedGrid& grid, int x, int y)
+{
+    for (int by = 0; by < bitmap.height; by++)
+        for (int bx = 0; bx < bitmap.width; bx++)
+            if (bitmap.get(bx, by)) grid.set(x + bx, y + bitmap.height - 1 - by, true);
+}
+
+ObjectCensus::Bitmap ObjectCensus::crop(const PackedGrid& grid, int minX, int minY, int maxX, int maxY)
+{
+    Bitmap bitmap;
+    bitmap.width = maxX - minX + 1;
+    bitmap.height = maxY - minY + 1;
+    bitmap.cells.resize(static_cast<size_t>(bitmap.width) * bitmap.height);
+    for (int y = 0; y < bitmap.height; y++)
+        for (int x = 0; x < bitmap.width; x++)
+            bitmap.cells[y * bitmap.width + x] = grid.get(minX + x, maxY - y);
+    return bitmap;
+}
+
+// Orientation bits: 1 mirrors x, 2 mirrors y, 4 transposes - together the 8 symmetries of the square
+ObjectCensus::Bitmap ObjectCensus::orient(const Bitmap& bitmap, int orientation)
+{
+    bool transpose = orientation & 4;
+    Bitmap out;
+    out.width = transpose ? bitmap.height : bitmap.width;
+    out.height = transpose ? bitmap.width : bitmap.height;
+    out.cells.resize(bitmap.cells.size());
+    for (int y = 0; y < out.height; y++) {
+        for (int x = 0; x < out.width; x++) {
+            int sx = transpose ? y : x, sy = transpose ? x : y;
+            if (orientation & 1) sx = bitmap.width - 1 - sx;
+            if (orientation & 2) sy = bitmap.height - 1 - sy;
+            out.cells[y * out.width + x] = bitmap.cells[sy * bitmap.width + sx];
+        }
+    }
+    return out;
+}
+
+// Extended Wechsler format: 5 row strips top to bottom separated by 'z', each column of a strip one
+// base-32 digit (top row = bit 0). Runs of blank columns shrink to 'w' (2), 'x' (3) or 'y' + digit (4-39),
+// & a strip's trailing blanks are dropped
+std::string ObjectCensus::wechsler(const Bitmap& bitmap)
+{
+    std::string code;
+    for (int strip = 0; strip * 5 < bitmap.height; strip++) {
+        if (strip > 0) code += 'z';
+        int blanks = 0;
+        for (int x = 0; x < bitmap.width; x++) {
+            int value = 0;
+            for (int r = 0; r < 5 && strip * 5 + r < bitmap.height; r++)
+                if (bitmap.get(x, strip * 5 + r)) value |= 1 << r;
+            if (value == 0) {
+                blanks++;
+                continue;
+            }
+            while (blanks > 0) {
+                if (blanks == 1)        { code += '0'; blanks = 0; }
+                else if (blanks == 2)   { code += 'w'; blanks = 0; }
+                else if (blanks == 3)   { code += 'x'; blanks = 0; }
+                else {
+                    int n = std::min(blanks, 39);
+                    code += 'y';
+                    code += WECHSLER_DIGITS[n - 4];
+                    blanks -= n;
+                }
+            }
+            code += WECHSLER_DIGITS[value];
+        }
+    }
+    return code;
+}
+
+std::string ObjectCensus::classify(const Bitmap& object) const
+{
+    // Room for the object to move MAX_PERIOD cells any way before it could reach the (dead) edges
+    const int margin = MAX_PERIOD + 2;
+    PackedGrid board(object.width + 2 * margin, object.height + 2 * margin);
+    paint(object, board, margin, margin);
+
+    CpuLifeEngine engine(1);
+    engine.setRule(rule);
+    engine.load(board);
+
+    std::vector<Bitmap> phases(1, object);
+    int period = 0, dx = 0, dy = 0;
+    GenerationStats stats;
+    for (int t = 1; t <= MAX_PERIOD && !period; t++) {
+        engine.step(&stats);
+        if (stats.maxX < stats.minX) return "zz_DIES";
+        if (stats.minX == 0 || stats.minY == 0 || stats.maxX == board.width() - 1 || stats.maxY == board.height() - 1) break;
+
+        Bitmap phase = crop(engine.board(), stats.minX, stats.minY, stats.maxX, stats.maxY);
+        if (phase.width == object.width && phase.cells == object.cells) {
+            period = t;
+            dx = stats.minX - margin;
+            dy = stats.minY - margin;
+        }
+        else phases.push_back(phase);
+    }
+    if (!period) return "zz_UNKNOWN";
+
+    // Shortest code, then the first in ASCII order, over every phase & orientation
+    std::string best;
+    for (const Bitmap& phase : phases) {
+        for (int orientation = 0; orientation < 8; orientation++) {
+            std::string code = wechsler(orient(phase, orientation));
+            if (best.empty() || code.size() < best.size() || (code.size() == best.size() && code < best)) best = code;
+        }
+    }
+
+    if (dx != 0 || dy != 0) return "xq" + std::to_string(period) + "_" + best;
+    if (period > 1) return "xp" + std::to_string(period) + "_" + best;
+    return "xs" + std::to_string(board.population()) + "_" + best;
+}
+
+bool ObjectCensus::write(const std::string& path) const
+{
+    FILE* file = fopen(path.c_str(), "w");
+    if (!file) {
+        std::cout << "ERROR::CENSUS::CANT_CREATE: " << path << std::endl;
+        return false;
+    }
+
+    std::vector<std::pair<std::string, uint64_t>> rows(_table.begin(), _table.end());
+    std::stable_sort(rows.begin(), rows.end(), [](const auto& a, const auto& b) { return a.second > b.second; });
+    fprintf(file, "code,count\n");
+    for (const auto& [code, count] : rows) fprintf(file, "%s,%llu\n", code.c_str(), static_cast<unsigned long long>(count));
+    return fclose(file) == 0;
+}
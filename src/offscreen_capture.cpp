@@ -0,0 +1,193 @@
+#include <iostream>
+#include <cstring>
+#include "offscreen_capture.h"
+#include "png_writer.h"
+
+#ifdef _WIN32
+#define popen _popen
+#define pclose _pclose
+#define PIPE_WRITE_MODE "wb"
+#else
+#define PIPE_WRITE_MODE "w"
+#endif
+
+OffscreenCapture::OffscreenCapture(int width, int height, int numPBOs)
+    : _width(width), _height(height)
+{
+    // FBO with colour + depth renderbuffers (the render path enables GL_DEPTH_TEST)
+    glGenFramebuffers(1, &FBO);
+    glBindFramebuffer(GL_FRAMEBUFFER, FBO);
+
+    glGenRenderbuffers(1, &colourRBO);
+    glBindRenderbuffer(GL_RENDERBUFFER, colourRBO);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, width, height);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, colourRBO);
+
+    glGenRenderbuffers(1, &depthRBO);
+    glBindRenderbuffer(GL_RENDERBUFFER, depthRBO);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, width, height);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, depthRBO);
+
+    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+        std::cout << "ERROR::OFFSCREEN::FRAMEBUFFER_INCOMPLETE" << std::endl;
+    glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+    // PBO ring
+    PBOs.resize(numPBOs);
+    fences.assign(numPBOs, nullptr);
+    pboFrameIndex.assign(numPBOs, 0);
+    glGenBuffers(numPBOs, PBOs.data());
+    for (GLuint pbo : PBOs) {
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, pbo);
+        glBufferData(GL_PIXEL_PACK_BUFFER, static_cast<GLsizeiptr>(width) * height * 4, NULL, GL_STREAM_READ);
+    }
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+    writer = std::thread(&OffscreenCapture::writerLoop, this);
+}
+
+OffscreenCapture::~OffscreenCapture()
+{
+    finish();
+    glDeleteBuffers(static_cast<GLsizei>(PBOs.size()), PBOs.data());
+    glDeleteRenderbuffers(1, &colourRBO);
+    glDeleteRenderbuffers(1, &depthRBO);
+    glDeleteFramebuffers(1, &FBO);
+}
+
+bool OffscreenCapture::openPngSequence(const std::string& pathPattern)
+{
+    pngPattern = pathPattern;
+    return true;
+}
+
+bool OffscreenCapture::openRawPipe(const std::string& command)
+{
+    rawPipe = popen(command.c_str(), PIPE_WRITE_MODE);
+    if (!rawPipe) {
+        std::cout << "ERROR::OFFSCREEN::PIPE_OPEN_FAILED: " << command << std::endl;
+        return false;
+    }
+    return true;
+}
+
+void OffscreenCapture::bindFramebuffer()
+{
+    glBindFramebuffer(GL_FRAMEBUFFER, FBO);
+    glViewport(0, 0, _width, _height);
+}
+
+void OffscreenCapture::captureFrame()
+{
+    int slot = static_cast<int>(nextFrameIndex % PBOs.size());
+
+    // The slot's previous readback was issued numPBOs frames ago, so its DMA has normally completed
+    if (fences[slot]) collectPBO(slot);
+
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, FBO);
+    glReadBuffer(GL_COLOR_ATTACHMENT0);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, PBOs[slot]);
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    glReadPixels(0, 0, _width, _height, GL_RGBA, GL_UNSIGNED_BYTE, (void*)0);     // Async: writes into the bound PBO
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+    fences[slot] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    pboFrameIndex[slot] = nextFrameIndex++;
+}
+
+void OffscreenCapture::collectPBO(int slot)
+{
+    glClientWaitSync(fences[slot], GL_SYNC_FLUSH_COMMANDS_BIT, GL_TIMEOUT_IGNORED);
+    glDeleteSync(fences[slot]);
+    fences[slot] = nullptr;
+
+    const size_t frameBytes = static_cast<size_t>(_width) * _height * 4;
+    Frame frame;
+    frame.index = pboFrameIndex[slot];
+    {
+        // Wait for room in the queue & recycle a buffer if one is free
+        std::unique_lock<std::mutex> lock(queueMutex);
+        queueCV.wait(lock, [this] { return queue.size() < MAX_QUEUED_FRAMES; });
+        if (!freeBuffers.empty()) {
+            frame.pixels = std::move(freeBuffers.back());
+            freeBuffers.pop_back();
+        }
+    }
+    frame.pixels.resize(frameBytes);
+
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, PBOs[slot]);
+    void* ptr = glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, frameBytes, GL_MAP_READ_BIT);
+    if (ptr) {
+        std::memcpy(frame.pixels.data(), ptr, frameBytes);
+        glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+    }
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        queue.push_back(std::move(frame));
+    }
+    queueCV.notify_all();
+}
+
+void OffscreenCapture::finish()
+{
+    if (!writer.joinable()) return;
+
+    // Collect the outstanding readbacks oldest first so frames stay in order
+    for (size_t i = 0; i < PBOs.size(); i++) {
+        int slot = static_cast<int>((nextFrameIndex + i) % PBOs.size());
+        if (fences[slot]) collectPBO(slot);
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        stopping = true;
+    }
+    queueCV.notify_all();
+    writer.join();
+
+    if (rawPipe) {
+        pclose(rawPipe);
+        rawPipe = nullptr;
+    }
+}
+
+void OffscreenCapture::writerLoop()
+{
+    while (true) {
+        Frame frame;
+        {
+            std::unique_lock<std::mutex> lock(queueMutex);
+            queueCV.wait(lock, [this] { return stopping || !queue.empty(); });
+            if (queue.empty()) return;  // Stopping & drained
+            frame = std::move(queue.front());
+            queue.pop_front();
+        }
+        queueCV.notify_all();
+
+        writeFrame(frame);
+
+        std::lock_guard<std::mutex> lock(queueMutex);
+        freeBuffers.push_back(std::move(frame.pixels));
+    }
+}
+
+void OffscreenCapture::writeFrame(const Frame& frame)
+{
+    if (!pngPattern.empty()) {
+        char path[1024];
+        snprintf(path, sizeof(path), pngPattern.c_str(), static_cast<int>(frame.index));
+        if (!PNGWriter::write(path, _width, _height, frame.pixels.data(), true))
+            std::cout << "ERROR::OFFSCREEN::PNG_WRITE_FAILED: " << path << std::endl;
+    }
+
+    if (rawPipe) {
+        // GL rows are bottom-up; encoders expect the top row first
+        const size_t rowBytes = static_cast<size_t>(_width) * 4;
+        for (int y = _height - 1; y >= 0; y--)
+            fwrite(frame.pixels.data() + rowBytes * y, 1, rowBytes, rawPipe);
+    }
+
+    _framesWritten++;
+}
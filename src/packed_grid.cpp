@@ -0,0 +1,81 @@
+#include <algorithm>
+#include "packed_grid.h"
+#include "bit_utils.h"
+
+void PackedGrid::resize(int width, int height)
+{
+    _width = width;
+    _height = height;
+    _wordsPerRow = (usedWordsPerRow() + ROW_ALIGN_WORDS - 1) / ROW_ALIGN_WORDS * ROW_ALIGN_WORDS;
+    words.assign(_wordsPerRow * height, 0);
+}
+
+void PackedGrid::clear()
+{
+    std::fill(words.begin(), words.end(), 0);
+}
+
+void PackedGrid::setRun(int x, int y, int length)
+{
+    if (y < 0 || y >= _height || length <= 0) return;
+    int end = std::min(x + length, _width);     // Exclusive
+    x = std::max(x, 0);
+    if (x >= end) return;
+
+    uint64_t* r = row(y);
+    int firstWord = x >> 6, lastWord = (end - 1) >> 6;
+    uint64_t firstMask = ~0ull << (x & 63);
+    uint64_t lastMask = ~0ull >> (63 - ((end - 1) & 63));
+
+    if (firstWord == lastWord) {
+        r[firstWord] |= firstMask & lastMask;
+        return;
+    }
+    r[firstWord] |= firstMask;
+    for (int w = firstWord + 1; w < lastWord; w++) r[w] = ~0ull;
+    r[lastWord] |= lastMask;
+}
+
+size_t PackedGrid::population() const
+{
+    size_t count = 0;
+    for (uint64_t w : words) count += popcount64(w);
+    return count;
+}
+
+void PackedGrid::assign(const PackedGridView& source)
+{
+    if (source.width != _width || source.height != _height) resize(source.width, source.height);
+    size_t used = usedWordsPerRow();
+    for (int y = 0; y < _height; y++)
+        std::copy(source.row(y), source.row(y) + used, row(y));
+}
+
+void PackedGrid::toCells(std::vector<uint32_t>& cells) const
+{
+    cells.resize(static_cast<size_t>(_width) * _height);
+    for (int y = 0; y < _height; y++) {
+        const uint64_t* r = row(y);
+        uint32_t* out = cells.data() + static_cast<size_t>(y) * _width;
+        for (int x = 0; x < _width; x++)
+            out[x] = static_cast<uint32_t>((r[x >> 6] >> (x & 63)) & 1);
+    }
+}
+
+void PackedGrid::fromCells(const uint32_t* cells, int width, int height)
+{
+    if (width != _width || height != _height) resize(width, height);
+
+    for (int y = 0; y < height; y++) {
+        uint64_t* r = row(y);
+        const uint32_t* in = cells + static_cast<size_t>(y) * width;
+        for (size_t w = 0; w < usedWordsPerRow(); w++) {
+            uint64_t word = 0;
+            int x0 = static_cast<int>(w) * WORD_BITS;
+            int n = std::min(WORD_BITS, width - x0);
+            for (int b = 0; b < n; b++)
+                word |= static_cast<uint64_t>(in[x0 + b] != 0) << b;
+            r[w] = word;
+        }
+    }
+}
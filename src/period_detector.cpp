@@ -0,0 +1,45 @@
+#include <algorithm>
+#include "period_detector.h"
+
+PeriodDetector::PeriodDetector(int maxPeriod)
+    : history(std::max(1, maxPeriod) + 1)
+{
+}
+
+void PeriodDetector::reset()
+{
+    count = 0;
+    candidate = 0;
+    repeats = 0;
+}
+
+int PeriodDetector::add(unsigned long long generation, uint64_t hash)
+{
+    const int maxPeriod = static_cast<int>(history.size()) - 1;
+    const size_t slot = count % history.size();
+
+    // Nearest earlier generation with the same hash
+    int period = 0;
+    for (int p = 1; p <= maxPeriod && static_cast<unsigned long long>(p) <= count; p++) {
+        if (history[(slot + history.size() - p) % history.size()] == hash) {
+            period = p;
+            break;
+        }
+    }
+    history[slot] = hash;
+    count++;
+
+    // A board of period p also repeats with 2p, 3p...: keep the candidate while it still matches
+    if (candidate && count > static_cast<unsigned long long>(candidate)
+        && history[(slot + history.size() - candidate) % history.size()] == hash) {
+        repeats++;
+    }
+    else {
+        candidate = period;
+        repeats = period ? 1 : 0;
+    }
+
+    if (!candidate || repeats != candidate) return 0;     // Reported once, when confirmed
+    _periodicSince = generation - 2 * candidate + 1;
+    return candidate;
+}
@@ -0,0 +1,174 @@
+#include <cstdio>
+#include <cstdint>
+#include <array>
+#include "png_writer.h"
+
+namespace {
+
+// CRC-32 as used by PNG chunks. The table is built by a function-local static's initializer, which C++11
+// makes thread-safe: PNGs are written from the capture's writer thread
+uint32_t crc32Update(uint32_t crc, const unsigned char* data, size_t len)
+{
+    static const std::array<uint32_t, 256> table = [] {
+        std::array<uint32_t, 256> t{};
+        for (uint32_t n = 0; n < 256; n++) {
+            uint32_t c = n;
+            for (int k = 0; k < 8; k++)
+                c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+            t[n] = c;
+        }
+        return t;
+    }();
+    crc = ~crc;
+    for (size_t i = 0; i < len; i++)
+        crc = table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+    return ~crc;
+}
+
+// Writes deflate bits LSB-first, as the format requires
+class BitWriter
+{
+public:
+    std::vector<unsigned char>& out;
+    uint32_t bitBuf = 0;
+    int bitCount = 0;
+
+    BitWriter(std::vector<unsigned char>& o) : out(o) {}
+
+    void writeBits(uint32_t value, int count)
+    {
+        bitBuf |= value << bitCount;
+        bitCount += count;
+        while (bitCount >= 8) {
+            out.push_back(static_cast<unsigned char>(bitBuf & 0xFF));
+            bitBuf >>= 8;
+            bitCount -= 8;
+        }
+    }
+    // Huffman codes are packed starting from their most significant bit
+    void writeCode(uint32_t code, int length)
+    {
+        uint32_t reversed = 0;
+        for (int i = 0; i < length; i++)
+            reversed |= ((code >> i) & 1) << (length - 1 - i);
+        writeBits(reversed, length);
+    }
+    void flush()
+    {
+        if (bitCount > 0) out.push_back(static_cast<unsigned char>(bitBuf & 0xFF));
+        bitBuf = 0;
+        bitCount = 0;
+    }
+};
+
+// Fixed Huffman literal/length alphabet (RFC 1951, 3.2.6)
+void writeLitLen(BitWriter& bw, int symbol)
+{
+    if (symbol < 144)       bw.writeCode(0x30 + symbol, 8);
+    else if (symbol < 256)  bw.writeCode(0x190 + (symbol - 144), 9);
+    else if (symbol < 280)  bw.writeCode(symbol - 256, 7);
+    else                    bw.writeCode(0xC0 + (symbol - 280), 8);
+}
+
+void writeMatch(BitWriter& bw, int length)
+{
+    static const int lengthBase[29] = { 3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+                                        35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258 };
+    static const int lengthExtra[29] = { 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+                                         3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0 };
+    int k = 28;
+    while (lengthBase[k] > length) k--;
+    writeLitLen(bw, 257 + k);
+    if (lengthExtra[k] > 0) bw.writeBits(length - lengthBase[k], lengthExtra[k]);
+    bw.writeCode(0, 5);     // Distance code 0 = distance 1, no extra bits
+}
+
+void writeChunk(std::vector<unsigned char>& out, const char* type, const std::vector<unsigned char>& data)
+{
+    uint32_t len = static_cast<uint32_t>(data.size());
+    unsigned char header[8] = { (unsigned char)(len >> 24), (unsigned char)(len >> 16), (unsigned char)(len >> 8), (unsigned char)len,
+                                (unsigned char)type[0], (unsigned char)type[1], (unsigned char)type[2], (unsigned char)type[3] };
+    out.insert(out.end(), header, header + 8);
+    out.insert(out.end(), data.begin(), data.end());
+
+    uint32_t crc = crc32Update(0, header + 4, 4);
+    crc = crc32Update(crc, data.data(), data.size());
+    unsigned char crcBytes[4] = { (unsigned char)(crc >> 24), (unsigned char)(crc >> 16), (unsigned char)(crc >> 8), (unsigned char)crc };
+    out.insert(out.end(), crcBytes, crcBytes + 4);
+}
+
+void putBE32(std::vector<unsigned char>& out, uint32_t v)
+{
+    out.push_back((unsigned char)(v >> 24));  out.push_back((unsigned char)(v >> 16));
+    out.push_back((unsigned char)(v >> 8));   out.push_back((unsigned char)v);
+}
+
+}
+
+void PNGWriter::encode(std::vector<unsigned char>& out, int width, int height, const unsigned char* rgba, bool flipY)
+{
+    const size_t rowBytes = static_cast<size_t>(width) * 4;
+
+    // 1. Filter scanlines ('Sub': each byte minus the same channel of the pixel to its left)
+    std::vector<unsigned char> filtered;
+    filtered.reserve((rowBytes + 1) * height);
+    for (int y = 0; y < height; y++) {
+        const unsigned char* row = rgba + rowBytes * (flipY ? height - 1 - y : y);
+        filtered.push_back(1);
+        for (size_t x = 0; x < rowBytes; x++)
+            filtered.push_back(static_cast<unsigned char>(row[x] - (x >= 4 ? row[x-4] : 0)));
+    }
+
+    // 2. Deflate as a single fixed-Huffman block, matching runs of the previous byte (distance 1)
+    std::vector<unsigned char> zlib = { 0x78, 0x01 };
+    BitWriter bw(zlib);
+    bw.writeBits(1, 1);     // BFINAL
+    bw.writeBits(1, 2);     // BTYPE = fixed Huffman
+    size_t i = 0;
+    while (i < filtered.size()) {
+        if (i > 0) {
+            size_t run = 0;
+            while (run < 258 && i + run < filtered.size() && filtered[i + run] == filtered[i - 1]) run++;
+            if (run >= 3) {
+                writeMatch(bw, static_cast<int>(run));
+                i += run;
+                continue;
+            }
+        }
+        writeLitLen(bw, filtered[i++]);
+    }
+    writeLitLen(bw, 256);   // End of block
+    bw.flush();
+
+    uint32_t a = 1, b = 0;  // Adler-32 of the uncompressed stream
+    for (unsigned char c : filtered) {
+        a = (a + c) % 65521;
+        b = (b + a) % 65521;
+    }
+    putBE32(zlib, (b << 16) | a);
+
+    // 3. Wrap into PNG chunks
+    static const unsigned char signature[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+    out.assign(signature, signature + 8);
+
+    std::vector<unsigned char> ihdr;
+    putBE32(ihdr, static_cast<uint32_t>(width));
+    putBE32(ihdr, static_cast<uint32_t>(height));
+    ihdr.push_back(8);  // Bit depth
+    ihdr.push_back(6);  // Colour type RGBA
+    ihdr.push_back(0);  ihdr.push_back(0);  ihdr.push_back(0);
+    writeChunk(out, "IHDR", ihdr);
+    writeChunk(out, "IDAT", zlib);
+    writeChunk(out, "IEND", {});
+}
+
+bool PNGWriter::write(const std::string& path, int width, int height, const unsigned char* rgba, bool flipY)
+{
+    std::vector<unsigned char> png;
+    encode(png, width, height, rgba, flipY);
+
+    FILE* file = fopen(path.c_str(), "wb");
+    if (!file) return false;
+    bool ok = fwrite(png.data(), 1, png.size(), file) == png.size();
+    return fclose(file) == 0 && ok;
+}
@@ -0,0 +1,228 @@
+#include <algorithm>
+#include <cstring>
+#include "quadtree.h"
+
+QuadTree::QuadTree()
+{
+    clear();
+}
+
+void QuadTree::clear()
+{
+    nodes.clear();
+    leafIndex.clear();
+    nodeIndex.clear();
+    nodes.push_back(Node{ 0, EMPTY, EMPTY, EMPTY, EMPTY, 0 });     // EMPTY sentinel
+    _root = EMPTY;
+    _rootLevel = LEAF_LEVEL;
+}
+
+QuadTree::NodeId QuadTree::leaf(uint64_t bits)
+{
+    if (bits == 0) return EMPTY;
+    auto it = leafIndex.find(bits);
+    if (it != leafIndex.end()) return it->second;
+
+    NodeId id = static_cast<NodeId>(nodes.size());
+    nodes.push_back(Node{ bits, EMPTY, EMPTY, EMPTY, EMPTY, static_cast<uint8_t>(LEAF_LEVEL) });
+    leafIndex.emplace(bits, id);
+    return id;
+}
+
+QuadTree::NodeId QuadTree::node(int level, NodeId nw, NodeId ne, NodeId sw, NodeId se)
+{
+    if (nw == EMPTY && ne == EMPTY && sw == EMPTY && se == EMPTY) return EMPTY;
+    NodeKey key{ nw, ne, sw, se, static_cast<uint8_t>(level) };
+    auto it = nodeIndex.find(key);
+    if (it != nodeIndex.end()) return it->second;
+
+    NodeId id = static_cast<NodeId>(nodes.size());
+    nodes.push_back(Node{ 0, nw, ne, sw, se, static_cast<uint8_t>(level) });
+    nodeIndex.emplace(key, id);
+    return id;
+}
+
+// BOUNDING BOX / POPULATION
+// -------------------------
+// Both memoise per distinct node, so they cost O(nodes) however large the area
+QuadTree::Box QuadTree::nodeBox(NodeId id, std::unordered_map<NodeId, Box>& memo) const
+{
+    Box box{ 0, 0, -1, -1 };
+    if (id == EMPTY) return box;
+    auto it = memo.find(id);
+    if (it != memo.end()) return it->second;
+
+    const Node& n = nodes[id];
+    if (n.level == LEAF_LEVEL) {
+        box = Box{ 8, 8, -1, -1 };
+        for (int y = 0; y < 8; y++) {
+            uint64_t row = (n.leafBits >> (y * 8)) & 0xFF;
+            if (!row) continue;
+            box.minY = std::min<int64_t>(box.minY, y);
+            box.maxY = y;
+            for (int x = 0; x < 8; x++) {
+                if (!((row >> x) & 1)) continue;
+                box.minX = std::min<int64_t>(box.minX, x);
+                box.maxX = std::max<int64_t>(box.maxX, x);
+            }
+        }
+    }
+    else {
+        int64_t half = 1ll << (n.level - 1);
+        const NodeId children[4] = { n.nw, n.ne, n.sw, n.se };
+        const int64_t dx[4] = { 0, half, 0, half }, dy[4] = { half, half, 0, 0 };
+        bool any = false;
+        for (int c = 0; c < 4; c++) {
+            Box b = nodeBox(children[c], memo);
+            if (b.empty()) continue;
+            b.minX += dx[c];  b.maxX += dx[c];  b.minY += dy[c];  b.maxY += dy[c];
+            if (!any) box = b;
+            else {
+                box.minX = std::min(box.minX, b.minX);  box.maxX = std::max(box.maxX, b.maxX);
+                box.minY = std::min(box.minY, b.minY);  box.maxY = std::max(box.maxY, b.maxY);
+            }
+            any = true;
+        }
+    }
+    memo.emplace(id, box);
+    return box;
+}
+
+QuadTree::Box QuadTree::boundingBox() const
+{
+    std::unordered_map<NodeId, Box> memo;
+    return nodeBox(_root, memo);
+}
+
+uint64_t QuadTree::nodePopulation(NodeId id, std::unordered_map<NodeId, uint64_t>& memo) const
+{
+    if (id == EMPTY) return 0;
+    auto it = memo.find(id);
+    if (it != memo.end()) return it->second;
+
+    const Node& n = nodes[id];
+    uint64_t pop;
+    if (n.level == LEAF_LEVEL) {
+        pop = 0;
+        for (uint64_t b = n.leafBits; b; b &= b - 1) pop++;
+    }
+    else {
+        pop = nodePopulation(n.nw, memo) + nodePopulation(n.ne, memo) + nodePopulation(n.sw, memo) + nodePopulation(n.se, memo);
+    }
+    memo.emplace(id, pop);
+    return pop;
+}
+
+uint64_t QuadTree::population() const
+{
+    std::unordered_map<NodeId, uint64_t> memo;
+    return nodePopulation(_root, memo);
+}
+
+// EXPANSION
+// ---------
+void QuadTree::tileRows(NodeId id, int level, int x0, int y0, uint64_t* rows) const
+{
+    if (id == EMPTY) return;
+    const Node& n = nodes[id];
+    if (level == LEAF_LEVEL) {
+        for (int y = 0; y < 8; y++)
+            rows[y0 + y] |= ((n.leafBits >> (y * 8)) & 0xFF) << x0;
+        return;
+    }
+    int half = 1 << (level - 1);
+    tileRows(n.nw, level - 1, x0, y0 + half, rows);
+    tileRows(n.ne, level - 1, x0 + half, y0 + half, rows);
+    tileRows(n.sw, level - 1, x0, y0, rows);
+    tileRows(n.se, level - 1, x0 + half, y0, rows);
+}
+
+void QuadTree::paintTilesRec(NodeId id, int level, int64_t x0, int64_t y0, TileStore& store,
+                             int64_t minX, int64_t minY, int64_t maxX, int64_t maxY) const
+{
+    if (id == EMPTY) return;
+    int64_t size = 1ll << level;
+    if (x0 > maxX || y0 > maxY || x0 + size <= minX || y0 + size <= minY) return;
+
+    if (level <= TILE_LEVEL) {
+        uint64_t rows[TileStore::TILE_SIZE] = {};
+        tileRows(id, level, 0, 0, rows);
+        store.setTile(static_cast<int32_t>(x0 >> TileStore::TILE_SHIFT), static_cast<int32_t>(y0 >> TileStore::TILE_SHIFT), rows);
+        return;
+    }
+    const Node& n = nodes[id];
+    int64_t half = size / 2;
+    paintTilesRec(n.nw, level - 1, x0, y0 + half, store, minX, minY, maxX, maxY);
+    paintTilesRec(n.ne, level - 1, x0 + half, y0 + half, store, minX, minY, maxX, maxY);
+    paintTilesRec(n.sw, level - 1, x0, y0, store, minX, minY, maxX, maxY);
+    paintTilesRec(n.se, level - 1, x0 + half, y0, store, minX, minY, maxX, maxY);
+}
+
+void QuadTree::paintTiles(TileStore& store, int64_t minX, int64_t minY, int64_t maxX, int64_t maxY) const
+{
+    paintTilesRec(_root, _rootLevel, 0, 0, store, minX, minY, maxX, maxY);
+}
+
+void QuadTree::paintGridRec(NodeId id, int level, int64_t x0, int64_t y0, PackedGrid& grid) const
+{
+    if (id == EMPTY) return;
+    int64_t size = 1ll << level;
+    if (x0 >= grid.width() || y0 >= grid.height() || x0 + size <= 0 || y0 + size <= 0) return;
+
+    const Node& n = nodes[id];
+    if (level == LEAF_LEVEL) {
+        for (int y = 0; y < 8; y++) {
+            uint64_t bits = (n.leafBits >> (y * 8)) & 0xFF;
+            int64_t gy = y0 + y;
+            if (!bits || gy < 0 || gy >= grid.height()) continue;
+            for (int x = 0; x < 8; x++) {
+                int64_t gx = x0 + x;
+                if (((bits >> x) & 1) && gx >= 0 && gx < grid.width())
+                    grid.set(static_cast<int>(gx), static_cast<int>(gy), true);
+            }
+        }
+        return;
+    }
+    int64_t half = size / 2;
+    paintGridRec(n.nw, level - 1, x0, y0 + half, grid);
+    paintGridRec(n.ne, level - 1, x0 + half, y0 + half, grid);
+    paintGridRec(n.sw, level - 1, x0, y0, grid);
+    paintGridRec(n.se, level - 1, x0 + half, y0, grid);
+}
+
+void QuadTree::paintGrid(PackedGrid& grid, int64_t offsetX, int64_t offsetY) const
+{
+    paintGridRec(_root, _rootLevel, offsetX, offsetY, grid);
+}
+
+// BUILDING
+// --------
+QuadTree::NodeId QuadTree::buildRec(const PackedGrid& grid, int level, int x0, int y0)
+{
+    if (x0 >= grid.width() || y0 >= grid.height()) return EMPTY;
+
+    if (level == LEAF_LEVEL) {
+        // x0 is a multiple of 8, so each leaf row is one byte of a grid word
+        uint64_t bits = 0;
+        for (int y = 0; y < 8 && y0 + y < grid.height(); y++) {
+            uint64_t byte = (grid.row(y0 + y)[x0 >> 6] >> (x0 & 63)) & 0xFF;
+            bits |= byte << (y * 8);
+        }
+        return leaf(bits);
+    }
+
+    int half = 1 << (level - 1);
+    NodeId nw = buildRec(grid, level - 1, x0, y0 + half);
+    NodeId ne = buildRec(grid, level - 1, x0 + half, y0 + half);
+    NodeId sw = buildRec(grid, level - 1, x0, y0);
+    NodeId se = buildRec(grid, level - 1, x0 + half, y0);
+    return node(level, nw, ne, sw, se);
+}
+
+void QuadTree::buildFromGrid(const PackedGrid& grid)
+{
+    clear();
+    int level = LEAF_LEVEL;
+    while ((1ll << level) < grid.width() || (1ll << level) < grid.height()) level++;
+    setRoot(buildRec(grid, level, 0, 0), level);
+}
@@ -0,0 +1,62 @@
+#include "readback_ring.h"
+
+ReadbackRing::ReadbackRing(int slots, size_t bytes, GLenum usage)
+    : _bytes(bytes)
+{
+    buffers.resize(slots);
+    fences.assign(slots, nullptr);
+    tags.assign(slots, 0);
+    glGenBuffers(slots, buffers.data());
+    for (GLuint buffer : buffers) {
+        glBindBuffer(GL_COPY_WRITE_BUFFER, buffer);
+        glBufferData(GL_COPY_WRITE_BUFFER, static_cast<GLsizeiptr>(bytes), NULL, usage);
+    }
+    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+}
+
+ReadbackRing::~ReadbackRing()
+{
+    for (GLsync fence : fences)
+        if (fence) glDeleteSync(fence);
+    glDeleteBuffers(static_cast<GLsizei>(buffers.size()), buffers.data());
+}
+
+void ReadbackRing::submit(unsigned long long tag)
+{
+    fences[nextSlot] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    tags[nextSlot] = tag;
+    nextSlot = (nextSlot + 1) % buffers.size();
+    _inFlight++;
+}
+
+bool ReadbackRing::poll(const Consumer& consume)
+{
+    if (_inFlight == 0) return false;
+    GLenum status = glClientWaitSync(fences[oldestSlot], GL_SYNC_FLUSH_COMMANDS_BIT, 0);
+    if (status != GL_ALREADY_SIGNALED && status != GL_CONDITION_SATISFIED) return false;
+    collect(consume);
+    return true;
+}
+
+void ReadbackRing::collect(const Consumer& consume)
+{
+    size_t slot = oldestSlot;
+    glClientWaitSync(fences[slot], GL_SYNC_FLUSH_COMMANDS_BIT, GL_TIMEOUT_IGNORED);
+    glDeleteSync(fences[slot]);
+    fences[slot] = nullptr;
+    oldestSlot = (oldestSlot + 1) % buffers.size();
+    _inFlight--;
+
+    glBindBuffer(GL_COPY_READ_BUFFER, buffers[slot]);
+    const void* data = glMapBufferRange(GL_COPY_READ_BUFFER, 0, static_cast<GLsizeiptr>(_bytes), GL_MAP_READ_BIT);
+    if (data) {
+        consume(data, tags[slot]);
+        glUnmapBuffer(GL_COPY_READ_BUFFER);
+    }
+    glBindBuffer(GL_COPY_READ_BUFFER, 0);
+}
+
+void ReadbackRing::flush(const Consumer& consume)
+{
+    while (_inFlight > 0) collect(consume);
+}
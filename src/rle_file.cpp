@@ -0,0 +1,333 @@
+#include <cstdio>
+#include <cctype>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+#include <algorithm>
+#include "rle_file.h"
+#include "bit_utils.h"
+
+namespace {
+
+const size_t READ_BUFFER_SIZE = 1 << 20;
+const long long MAX_RUN = 1ll << 40;    // Guards the run count against overflow on garbage input
+
+std::string trim(const std::string& s)
+{
+    size_t b = s.find_first_not_of(" \t\r\n");
+    size_t e = s.find_last_not_of(" \t\r\n");
+    return b == std::string::npos ? std::string() : s.substr(b, e - b + 1);
+}
+
+// Buffered writer that wraps lines at 70 characters, as RLE readers expect
+class RLEWriter
+{
+public:
+    FILE* file;
+    std::string buffer;
+    size_t lineLength = 0;
+
+    RLEWriter(FILE* f) : file(f) { buffer.reserve(1 << 16); }
+
+    // 'prefix' is a multi-state symbol's p..y letter, if it has one
+    void token(long long count, char symbol, char prefix = 0)
+    {
+        char text[32];
+        int len = count > 1 ? snprintf(text, sizeof(text), "%lld", count) : 0;
+        if (prefix) text[len++] = prefix;
+        text[len++] = symbol;
+        if (lineLength + len > 70) {
+            buffer += '\n';
+            lineLength = 0;
+        }
+        buffer.append(text, len);
+        lineLength += len;
+        if (buffer.size() >= (1 << 16)) flush();
+    }
+    bool flush()
+    {
+        bool ok = fwrite(buffer.data(), 1, buffer.size(), file) == buffer.size();
+        buffer.clear();
+        return ok;
+    }
+};
+
+// Length of the run of cells equal to 'alive' starting at x (stops at 'end')
+int runLength(const uint64_t* row, int x, int end, bool alive)
+{
+    int start = x;
+    while (x < end) {
+        uint64_t w = row[x >> 6] ^ (alive ? ~0ull : 0ull);   // Set bits = cells that break the run
+        w &= ~0ull << (x & 63);
+        if (w) {
+            x = (x & ~63) + countTrailingZeros64(w);
+            break;
+        }
+        x = (x & ~63) + 64;
+    }
+    return std::min(x, end) - start;
+}
+
+}
+
+bool RLEFile::parseHeaderLine(const std::string& line, Header& header)
+{
+    // "x = m, y = n, rule = abc"
+    size_t pos = 0;
+    bool hasX = false, hasY = false;
+    while (pos < line.size()) {
+        size_t start = pos, comma = line.find(',', pos);
+        std::string field = line.substr(pos, comma == std::string::npos ? std::string::npos : comma - pos);
+        pos = comma == std::string::npos ? line.size() : comma + 1;
+
+        size_t eq = field.find('=');
+        if (eq == std::string::npos) continue;
+        std::string key = trim(field.substr(0, eq)), value = trim(field.substr(eq + 1));
+        if (key == "x")         { header.width = atoll(value.c_str());  hasX = true; }
+        else if (key == "y")    { header.height = atoll(value.c_str()); hasY = true; }
+        else if (key == "rule") {
+            // Last, & the rest of the line: Larger than Life rules have commas of their own
+            header.rule = trim(line.substr(start + eq + 1));
+            break;
+        }
+    }
+    return hasX && hasY && header.width >= 0 && header.height >= 0;
+}
+
+bool RLEFile::readHeader(const std::string& path, Header& header)
+{
+    FILE* file = fopen(path.c_str(), "rb");
+    if (!file) return false;
+
+    char line[4096];
+    bool found = false;
+    while (fgets(line, sizeof(line), file)) {
+        std::string s = trim(line);
+        if (s.empty() || s[0] == '#') continue;
+        found = parseHeaderLine(s, header);
+        break;
+    }
+    fclose(file);
+    return found;
+}
+
+bool RLEFile::decode(const std::string& path, Header& header, const std::function<void(long long, long long, long long, unsigned)>& paint)
+{
+    FILE* file = fopen(path.c_str(), "rb");
+    if (!file) {
+        std::cout << "ERROR::RLE::FILE_NOT_FOUND: " << path << std::endl;
+        return false;
+    }
+
+    enum State { LINE_START, COMMENT, HEADER, BODY };
+    State state = LINE_START;
+    std::string headerLine;
+    bool haveHeader = false, done = false;
+
+    long long count = 0;        // Pending run count (0 = none given, i.e. 1)
+    long long x = 0, row = 0;   // Position within the pattern, row 0 at the top
+    unsigned prefix = 0;        // Multi-state: 24 per p..y letter before the state's A..X
+
+    std::vector<char> buffer(READ_BUFFER_SIZE);
+    size_t n;
+    while (!done && (n = fread(buffer.data(), 1, buffer.size(), file)) > 0) {
+        for (size_t i = 0; i < n && !done; i++) {
+            char c = buffer[i];
+
+            switch (state) {
+            case LINE_START:
+                if (c == '#')                           state = COMMENT;
+                else if (isspace(static_cast<unsigned char>(c))) {}
+                else if (!haveHeader && c == 'x')       { state = HEADER; headerLine = c; }
+                else if (!haveHeader) {
+                    std::cout << "ERROR::RLE::MISSING_HEADER: " << path << std::endl;
+                    fclose(file);
+                    return false;
+                }
+                else                                    { state = BODY; i--; }  // Reprocess as body
+                break;
+
+            case COMMENT:
+                if (c == '\n') state = LINE_START;
+                break;
+
+            case HEADER:
+                if (c != '\n') {
+                    headerLine += c;
+                    if (headerLine.size() > 4096) state = COMMENT;    // Not a sane header; fails below
+                    break;
+                }
+                if (!parseHeaderLine(headerLine, header)) {
+                    std::cout << "ERROR::RLE::BAD_HEADER: " << headerLine << std::endl;
+                    fclose(file);
+                    return false;
+                }
+                haveHeader = true;
+                state = LINE_START;
+                break;
+
+            case BODY:
+                if (c >= '0' && c <= '9') {
+                    count = std::min(count * 10 + (c - '0'), MAX_RUN);
+                    break;
+                }
+                if (isspace(static_cast<unsigned char>(c))) break;
+
+                long long run = count > 0 ? count : 1;
+                count = 0;
+                if (c >= 'p' && c <= 'y') {
+                    prefix = 24 * (c - 'p' + 1);
+                    count = run == 1 ? 0 : run;     // The run belongs to the state letter after the prefix
+                    break;
+                }
+                if (c == 'b' || c == '.') {
+                    x += run;
+                }
+                else if (c == '$') {
+                    row += run;
+                    x = 0;
+                }
+                else if (c == '!') {
+                    done = true;
+                }
+                else if (c == 'o' || (c >= 'A' && c <= 'X')) {
+                    paint(x, row, run, c == 'o' ? 1 : prefix + (c - 'A' + 1));
+                    x += run;
+                }
+                prefix = 0;
+                break;
+            }
+        }
+    }
+    fclose(file);
+
+    if (!haveHeader) {
+        std::cout << "ERROR::RLE::MISSING_HEADER: " << path << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool RLEFile::load(const std::string& path, PackedGrid& grid, int offsetX, int offsetY, Header* headerOut)
+{
+    Header header;
+    bool ok = decode(path, header, [&](long long x, long long row, long long run, unsigned) {
+        // Any live state counts as alive on a 2-state board
+        long long gy = offsetY + header.height - 1 - row;
+        long long start = std::max(offsetX + x, 0ll);
+        long long stop = std::min(offsetX + x + run, static_cast<long long>(grid.width()));
+        if (gy >= 0 && gy < grid.height() && start < stop)
+            grid.setRun(static_cast<int>(start), static_cast<int>(gy), static_cast<int>(stop - start));
+    });
+    if (ok && headerOut) *headerOut = header;
+    return ok;
+}
+
+bool RLEFile::loadStates(const std::string& path, std::vector<uint32_t>& cells, int width, int height, int offsetX, int offsetY, Header* headerOut)
+{
+    Header header;
+    bool ok = decode(path, header, [&](long long x, long long row, long long run, unsigned state) {
+        long long gy = offsetY + header.height - 1 - row;
+        long long start = std::max(offsetX + x, 0ll);
+        long long stop = std::min(offsetX + x + run, static_cast<long long>(width));
+        if (gy < 0 || gy >= height || start >= stop) return;
+        std::fill(cells.begin() + gy * width + start, cells.begin() + gy * width + stop, state);
+    });
+    if (ok && headerOut) *headerOut = header;
+    return ok;
+}
+
+bool RLEFile::save(const std::string& path, const PackedGrid& grid, const std::string& rule)
+{
+    // Bounding box of the live cells
+    int minX = grid.width(), maxX = -1, minY = grid.height(), maxY = -1;
+    for (int y = 0; y < grid.height(); y++) {
+        const uint64_t* r = grid.row(y);
+        for (size_t w = 0; w < grid.usedWordsPerRow(); w++) {
+            if (!r[w]) continue;
+            int x = static_cast<int>(w) * 64;
+            minX = std::min(minX, x + countTrailingZeros64(r[w]));
+            maxX = std::max(maxX, x + highestBit64(r[w]));
+            minY = std::min(minY, y);
+            maxY = y;
+        }
+    }
+
+    FILE* file = fopen(path.c_str(), "wb");
+    if (!file) return false;
+
+    bool empty = maxX < 0;
+    fprintf(file, "x = %d, y = %d, rule = %s\n", empty ? 0 : maxX - minX + 1, empty ? 0 : maxY - minY + 1, rule.c_str());
+
+    RLEWriter writer(file);
+    long long pendingRows = 0;
+    for (int y = maxY; y >= minY && !empty; y--) {     // Top row first
+        const uint64_t* r = grid.row(y);
+        int x = minX, end = maxX + 1;
+
+        // Skip rows with nothing in the box (they fold into the next '$' run)
+        bool rowEmpty = runLength(r, x, end, false) == end - x;
+        if (!rowEmpty) {
+            if (pendingRows > 0) writer.token(pendingRows, '$');
+            pendingRows = 0;
+            while (x < end) {
+                bool alive = (r[x >> 6] >> (x & 63)) & 1;
+                int len = runLength(r, x, end, alive);
+                if (!alive && x + len == end) break;    // Trailing dead cells are implied
+                writer.token(len, alive ? 'o' : 'b');
+                x += len;
+            }
+        }
+        pendingRows++;
+    }
+    writer.token(1, '!');
+    writer.buffer += '\n';
+    bool ok = writer.flush();
+    return fclose(file) == 0 && ok;
+}
+
+bool RLEFile::saveStates(const std::string& path, const std::vector<uint32_t>& cells, int width, int height, const std::string& rule)
+{
+    // Bounding box of the non-zero cells
+    int minX = width, maxX = -1, minY = height, maxY = -1;
+    for (int y = 0; y < height; y++)
+        for (int x = 0; x < width; x++) {
+            if (!cells[static_cast<size_t>(y) * width + x]) continue;
+            minX = std::min(minX, x);
+            maxX = std::max(maxX, x);
+            minY = std::min(minY, y);
+            maxY = y;
+        }
+
+    FILE* file = fopen(path.c_str(), "wb");
+    if (!file) return false;
+
+    bool empty = maxX < 0;
+    fprintf(file, "x = %d, y = %d, rule = %s\n", empty ? 0 : maxX - minX + 1, empty ? 0 : maxY - minY + 1, rule.c_str());
+
+    RLEWriter writer(file);
+    long long pendingRows = 0;
+    for (int y = maxY; y >= minY && !empty; y--) {     // Top row first
+        const uint32_t* r = cells.data() + static_cast<size_t>(y) * width;
+        int end = maxX + 1;
+        while (end > minX && !r[end - 1]) end--;    // Trailing dead cells are implied
+        if (end > minX) {
+            if (pendingRows > 0) writer.token(pendingRows, '$');
+            pendingRows = 0;
+            for (int x = minX; x < end; ) {
+                uint32_t state = r[x];
+                int len = 1;
+                while (x + len < end && r[x + len] == state) len++;
+                // '.' for 0, A..X for 1-24, then a p..y prefix for each further 24
+                if (state > 24) writer.token(len, static_cast<char>('A' + (state - 1) % 24), static_cast<char>('p' + (state - 1) / 24 - 1));
+                else writer.token(len, state ? static_cast<char>('A' + state - 1) : '.');
+                x += len;
+            }
+        }
+        pendingRows++;
+    }
+    writer.token(1, '!');
+    writer.buffer += '\n';
+    bool ok = writer.flush();
+    return fclose(file) == 0 && ok;
+}
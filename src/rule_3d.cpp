@@ -0,0 +1,84 @@
+#include <cctype>
+#include <cstdlib>
+#include "rule_3d.h"
+
+namespace {
+
+// Counts after B / S: a digit each, or comma separated once they need two digits
+bool parseCounts(const std::string& text, int most, uint32_t& mask)
+{
+    mask = 0;
+    if (text.find_first_not_of("0123456789,") != std::string::npos) return false;
+    if (text.find(',') == std::string::npos) {
+        for (char c : text) {
+            if (c - '0' > most) return false;
+            mask |= 1u << (c - '0');
+        }
+        return true;
+    }
+
+    size_t pos = 0;
+    while (pos <= text.size()) {
+        size_t comma = text.find(',', pos);
+        if (comma == std::string::npos) comma = text.size();
+        std::string count = text.substr(pos, comma - pos);
+        pos = comma + 1;
+        if (count.empty() || count.size() > 2 || atoi(count.c_str()) > most) return false;
+        mask |= 1u << atoi(count.c_str());
+    }
+    return true;
+}
+
+std::string countsToString(uint32_t mask)
+{
+    bool commas = (mask >> 10) != 0;
+    std::string s;
+    for (int n = 0; n <= Rule3D::MAX_NEIGHBOURS; n++) {
+        if (!((mask >> n) & 1)) continue;
+        if (commas && !s.empty()) s += ',';
+        s += std::to_string(n);
+    }
+    return s;
+}
+
+}
+
+bool Rule3D::parse(const std::string& ruleText)
+{
+    std::string text;
+    for (char c : ruleText)
+        if (c != ' ') text += static_cast<char>(std::toupper(static_cast<unsigned char>(c)));
+    bool neumann = !text.empty() && text.back() == 'V';
+    if (neumann) text.pop_back();
+    int most = neumann ? 6 : MAX_NEIGHBOURS;
+
+    uint32_t birth = 0, survive = 0;
+    if (text.size() == 4 && text.find_first_not_of("0123456789") == std::string::npos) {
+        // Bays: survival low & high, then birth low & high
+        int surviveLow = text[0] - '0', surviveHigh = text[1] - '0', birthLow = text[2] - '0', birthHigh = text[3] - '0';
+        if (surviveLow > surviveHigh || birthLow > birthHigh || surviveHigh > most || birthHigh > most) return false;
+        for (int n = surviveLow; n <= surviveHigh; n++) survive |= 1u << n;
+        for (int n = birthLow; n <= birthHigh; n++) birth |= 1u << n;
+    }
+    else {
+        size_t slash = text.find('/');
+        if (slash == std::string::npos) return false;
+        std::string first = text.substr(0, slash), second = text.substr(slash + 1);
+        if (first.empty() || second.empty() || first[0] == second[0]) return false;
+        if (first[0] != 'B' && first[0] != 'S') return false;
+        if (second[0] != 'B' && second[0] != 'S') return false;
+        const std::string& birthText = first[0] == 'B' ? first : second;
+        const std::string& surviveText = first[0] == 'B' ? second : first;
+        if (!parseCounts(birthText.substr(1), most, birth) || !parseCounts(surviveText.substr(1), most, survive)) return false;
+    }
+
+    birthMask = birth;
+    surviveMask = survive;
+    vonNeumann = neumann;
+    return true;
+}
+
+std::string Rule3D::toString() const
+{
+    return "B" + countsToString(birthMask) + "/S" + countsToString(surviveMask) + (vonNeumann ? "V" : "");
+}
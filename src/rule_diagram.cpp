@@ -0,0 +1,72 @@
+#include <map>
+#include <tuple>
+#include "rule_diagram.h"
+
+namespace {
+
+// Neighbourhood bits, in the order they're branched on: around the ring, edges before corners & the cell
+// first or last
+const int ORDERS[][9] = {
+    { 0, 1, 2, 3, 4, 5, 6, 7, 8 },
+    { 8, 0, 1, 2, 3, 4, 5, 6, 7 },
+    { 0, 2, 4, 6, 1, 3, 5, 7, 8 },
+    { 8, 0, 2, 4, 6, 1, 3, 5, 7 },
+    { 0, 4, 2, 6, 1, 5, 3, 7, 8 },
+};
+
+class Builder
+{
+public:
+    std::vector<uint16_t> inputs, los, his;
+    std::map<std::tuple<int, int, int>, int> unique;    // (input, lo, hi) -> node, so equal subdiagrams are shared
+
+    // Diagram of 'values' (a truth table over the inputs order[level...], bit 0 of its index = order[level])
+    int build(const std::vector<uint8_t>& values, const int* order, int level)
+    {
+        bool constant = true;
+        for (uint8_t v : values) constant &= v == values[0];
+        if (constant) return values[0];
+
+        std::vector<uint8_t> lo(values.size() / 2), hi(values.size() / 2);
+        for (size_t i = 0; i < lo.size(); i++) {
+            lo[i] = values[2 * i];
+            hi[i] = values[2 * i + 1];
+        }
+        int loNode = build(lo, order, level + 1), hiNode = build(hi, order, level + 1);
+        if (loNode == hiNode) return loNode;
+
+        auto key = std::make_tuple(order[level], loNode, hiNode);
+        auto found = unique.find(key);
+        if (found != unique.end()) return found->second;
+        inputs.push_back(static_cast<uint16_t>(order[level]));
+        los.push_back(static_cast<uint16_t>(loNode));
+        his.push_back(static_cast<uint16_t>(hiNode));
+        int node = static_cast<int>(inputs.size()) + 1;
+        unique.emplace(key, node);
+        return node;
+    }
+};
+
+}
+
+void RuleDiagram::build(const std::array<uint64_t, 8>& table)
+{
+    nodes.clear();
+    bool first = true;
+    for (const int* order : ORDERS) {
+        std::vector<uint8_t> values(512);
+        for (unsigned i = 0; i < 512; i++) {
+            unsigned index = 0;
+            for (int bit = 0; bit < 9; bit++) index |= ((i >> bit) & 1) << order[bit];
+            values[i] = (table[index >> 6] >> (index & 63)) & 1;
+        }
+
+        Builder builder;
+        int top = builder.build(values, order, 0);
+        if (!first && builder.inputs.size() >= nodes.size()) continue;
+        first = false;
+        nodes.resize(builder.inputs.size());
+        for (size_t n = 0; n < nodes.size(); n++) nodes[n] = { builder.inputs[n], builder.los[n], builder.his[n] };
+        root = static_cast<uint16_t>(top);
+    }
+}
@@ -0,0 +1,398 @@
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <numeric>
+#include <unordered_map>
+#include "rule_table.h"
+
+namespace {
+
+const uint64_t MAX_EXPANSIONS = 1ull << 27;     // Variable combinations & transitions written out, over all lines
+const uint32_t MAX_SEED = 1u << 16;             // Displacements tried per perfect hash bucket
+
+enum Symmetry { NONE, ROTATE4, ROTATE8, REFLECT_HORIZONTAL, ROTATE4_REFLECT, ROTATE8_REFLECT, PERMUTE };
+
+std::string trim(const std::string& s)
+{
+    size_t b = s.find_first_not_of(" \t\r\n");
+    size_t e = s.find_last_not_of(" \t\r\n");
+    return b == std::string::npos ? std::string() : s.substr(b, e - b + 1);
+}
+
+// Non-negative decimal number filling 'text'
+bool parseNumber(const std::string& text, int& value)
+{
+    if (text.empty() || text.size() > 9 || text.find_first_not_of("0123456789") != std::string::npos) return false;
+    value = atoi(text.c_str());
+    return true;
+}
+
+bool parseSymmetry(const std::string& text, Symmetry& symmetry)
+{
+    static const std::map<std::string, Symmetry> names = {
+        { "none", NONE }, { "rotate4", ROTATE4 }, { "rotate8", ROTATE8 }, { "reflect_horizontal", REFLECT_HORIZONTAL },
+        { "rotate4reflect", ROTATE4_REFLECT }, { "rotate8reflect", ROTATE8_REFLECT }, { "permute", PERMUTE }
+    };
+    auto found = names.find(text);
+    if (found == names.end()) return false;
+    symmetry = found->second;
+    return true;
+}
+
+// The neighbour orders a symmetry maps a transition onto: neighbour i of an image is neighbour map[i] of the
+// line. Rotations turn the ring by a quarter (or an eighth) turn, & the reflection swaps east & west.
+// Permute isn't a fixed set of maps: it's expanded over the line's own values
+std::vector<std::vector<int>> symmetryMaps(Symmetry symmetry, int n)
+{
+    int rotations = symmetry == ROTATE8 || symmetry == ROTATE8_REFLECT ? n : (symmetry == NONE || symmetry == REFLECT_HORIZONTAL ? 1 : 4);
+    bool reflect = symmetry == REFLECT_HORIZONTAL || symmetry == ROTATE4_REFLECT || symmetry == ROTATE8_REFLECT;
+    std::vector<std::vector<int>> maps;
+    for (int r = 0; r < rotations; r++) {
+        std::vector<int> map(n);
+        for (int i = 0; i < n; i++) map[i] = (i + r * (n / rotations)) % n;
+        maps.push_back(map);
+        if (!reflect) continue;
+        for (int i = 0; i < n; i++) map[i] = maps.back()[(n - i) % n];
+        maps.push_back(map);
+    }
+    return maps;
+}
+
+// Golly's default colours: a gradient over states 1.. from 'from' to 'to'
+void gradient(std::vector<uint32_t>& colours, uint32_t from, uint32_t to)
+{
+    int last = static_cast<int>(colours.size()) - 1;
+    for (int s = 1; s <= last; s++) {
+        uint32_t colour = 0;
+        for (int shift = 0; shift <= 16; shift += 8) {
+            int a = (from >> shift) & 255, b = (to >> shift) & 255;
+            int c = last > 1 ? a + (b - a) * (s - 1) / (last - 1) : a;
+            colour |= static_cast<uint32_t>(c) << shift;
+        }
+        colours[s] = colour;
+    }
+}
+
+}
+
+bool RuleTable::load(const std::string& path)
+{
+    std::ifstream file(path);
+    if (!file.is_open()) {
+        std::cout << "ERROR::RULE_TABLE::FILE_NOT_FOUND: " << path << std::endl;
+        return false;
+    }
+    int lineNumber = 0;
+    auto fail = [&](const std::string& message) {
+        std::cout << "ERROR::RULE_TABLE: " << path << " line " << lineNumber << ": " << message << std::endl;
+        return false;
+    };
+
+    // Built into a fresh table, so this one is left as it was if the file is rejected
+    RuleTable table;
+    size_t slash = path.find_last_of("/\\"), dot = path.find_last_of('.');
+    table.name = path.substr(slash == std::string::npos ? 0 : slash + 1);
+    if (dot != std::string::npos && (slash == std::string::npos || dot > slash)) table.name.resize(dot - (slash == std::string::npos ? 0 : slash + 1));
+
+    enum Section { TABLE, COLORS, OTHER };
+    bool bareTable = path.size() > 6 && path.compare(path.size() - 6, 6, ".table") == 0;
+    Section section = bareTable ? TABLE : OTHER;
+    bool haveTable = bareTable, haveStates = false, started = false, overflow = false;
+    Symmetry symmetry = NONE;
+    std::map<std::string, std::vector<int>> variables;
+    std::vector<std::vector<int>> maps;
+    std::vector<uint32_t> colourLines;      // state, colour pairs & gradients (state ~0u), applied once states is known
+
+    // Transitions so far: a first match marks its key, & later lines can't change it
+    std::vector<bool> seen;
+    std::unordered_map<uint64_t, uint8_t> expanded;
+    uint64_t expansions = 0;
+    int k = 0;
+
+    auto keyOf = [&](const int* cells) {
+        uint64_t key = 0;
+        for (int i = 0; i <= k; i++) key |= static_cast<uint64_t>(cells[i]) << (i * table.bitsPerState);
+        return key;
+    };
+    auto known = [&](uint64_t key) { return table.denseTable.empty() ? expanded.count(key) != 0 : seen[key]; };
+    auto add = [&](const int* cells, int output) {
+        uint64_t key = keyOf(cells);
+        if (++expansions > MAX_EXPANSIONS) overflow = true;
+        if (!table.denseTable.empty()) {
+            if (seen[key]) return;
+            seen[key] = true;
+            table.denseTable[key] = static_cast<uint8_t>(output);
+        }
+        else expanded.emplace(key, static_cast<uint8_t>(output));
+    };
+
+    // A state number, or the values of a variable defined earlier
+    auto values = [&](const std::string& token, std::vector<int>& out) {
+        int state;
+        if (parseNumber(token, state)) {
+            if (state >= table.states) return false;
+            out.push_back(state);
+            return true;
+        }
+        auto found = variables.find(token);
+        if (found == variables.end()) return false;
+        out.insert(out.end(), found->second.begin(), found->second.end());
+        return true;
+    };
+
+    std::string line;
+    while (std::getline(file, line)) {
+        lineNumber++;
+        size_t hash = line.find('#');
+        if (hash != std::string::npos) line.resize(hash);
+        line = trim(line);
+        if (line.empty()) continue;
+
+        if (line[0] == '@') {
+            std::string tag = line.substr(0, line.find_first_of(" \t"));
+            if (tag == "@RULE") {
+                section = OTHER;
+                std::string ruleName = trim(line.substr(tag.size()));
+                if (!ruleName.empty()) table.name = ruleName;
+            }
+            else if (tag == "@TABLE") {
+                section = TABLE;
+                haveTable = true;
+            }
+            else if (tag == "@COLORS") section = COLORS;
+            else section = OTHER;
+            continue;
+        }
+
+        if (section == COLORS) {
+            // "state r g b", or "r1 g1 b1 r2 g2 b2" for a gradient over the live states
+            std::vector<int> numbers;
+            size_t pos = 0;
+            while (pos < line.size()) {
+                size_t end = line.find_first_of(" \t,", pos);
+                if (end == std::string::npos) end = line.size();
+                int n;
+                if (end > pos && parseNumber(line.substr(pos, end - pos), n)) numbers.push_back(n);
+                pos = end + 1;
+            }
+            auto rgb = [&](int i) { return static_cast<uint32_t>((std::min(numbers[i], 255) << 16) | (std::min(numbers[i + 1], 255) << 8) | std::min(numbers[i + 2], 255)); };
+            if (numbers.size() == 4) colourLines.insert(colourLines.end(), { static_cast<uint32_t>(numbers[0]), rgb(1) });
+            else if (numbers.size() == 6) colourLines.insert(colourLines.end(), { ~0u, rgb(0), rgb(3) });
+            continue;
+        }
+        if (section != TABLE) continue;
+
+        size_t colon = line.find(':');
+        if (colon != std::string::npos) {
+            std::string key = trim(line.substr(0, colon)), value = trim(line.substr(colon + 1));
+            if (started) return fail("\"" + key + "\" after the first variable or transition");
+            if (key == "n_states") {
+                if (!parseNumber(value, table.states) || table.states < 2 || table.states > MAX_STATES) return fail("n_states must be 2 to 256");
+                haveStates = true;
+            }
+            else if (key == "neighborhood" || key == "neighbourhood") {
+                if (value == "Moore") table.neighbourhood = MOORE;
+                else if (value == "vonNeumann") table.neighbourhood = VON_NEUMANN;
+                else return fail("unsupported neighbourhood " + value + " (Moore or vonNeumann)");
+            }
+            else if (key == "symmetries") {
+                if (!parseSymmetry(value, symmetry)) return fail("unknown symmetries " + value);
+            }
+            else return fail("unknown setting " + key);
+            continue;
+        }
+
+        if (!started) {
+            // The settings are in: size the key & the lookup it indexes
+            if (!haveStates) return fail("n_states must come first");
+            if (table.neighbourhood == MOORE && table.states > MAX_MOORE_STATES) return fail("Moore tables can have up to 128 states");
+            if (table.neighbourhood == VON_NEUMANN && (symmetry == ROTATE8 || symmetry == ROTATE8_REFLECT))
+                return fail("rotate8 symmetries need the Moore neighbourhood");
+            while ((1 << table.bitsPerState) < table.states) table.bitsPerState++;
+            k = table.neighbourCount();
+            maps = symmetryMaps(symmetry, k);
+            if (table.keyBits() <= DENSE_MAX_BITS) {
+                table.denseTable.assign(size_t(1) << table.keyBits(), 0);
+                seen.assign(table.denseTable.size(), false);
+            }
+            started = true;
+        }
+
+        if (line.compare(0, 4, "var ") == 0) {
+            // "var name={0,1,other}"
+            size_t eq = line.find('='), open = line.find('{'), close = line.rfind('}');
+            if (eq == std::string::npos || open == std::string::npos || close == std::string::npos || close < open)
+                return fail("bad variable");
+            std::string varName = trim(line.substr(4, eq - 4));
+            if (varName.empty()) return fail("bad variable");
+            std::vector<int> list;
+            std::string body = line.substr(open + 1, close - open - 1);
+            size_t pos = 0;
+            while (pos <= body.size()) {
+                size_t comma = body.find(',', pos);
+                if (comma == std::string::npos) comma = body.size();
+                if (!values(trim(body.substr(pos, comma - pos)), list)) return fail("bad value in variable " + varName);
+                pos = comma + 1;
+            }
+            variables[varName] = list;
+            continue;
+        }
+
+        // A transition: "C,N,NE,E,SE,S,SW,W,NW,C'" (von Neumann: "C,N,E,S,W,C'"), or the same as one digit each
+        std::vector<std::string> tokens;
+        if (line.find(',') != std::string::npos) {
+            size_t pos = 0;
+            while (pos <= line.size()) {
+                size_t comma = line.find(',', pos);
+                if (comma == std::string::npos) comma = line.size();
+                tokens.push_back(trim(line.substr(pos, comma - pos)));
+                pos = comma + 1;
+            }
+        }
+        else for (char c : line)
+            if (!isspace(static_cast<unsigned char>(c))) tokens.push_back(std::string(1, c));
+        if (static_cast<int>(tokens.size()) != k + 2) return fail("expected " + std::to_string(k + 2) + " states in a transition");
+
+        // Each variable is bound: all its appearances in the line take the same value
+        std::vector<std::string> names;
+        std::vector<int> slot(k + 2, -1), literal(k + 2, 0);
+        for (int i = 0; i < k + 2; i++) {
+            if (parseNumber(tokens[i], literal[i])) {
+                if (literal[i] >= table.states) return fail("state " + tokens[i] + " is past n_states");
+                continue;
+            }
+            if (!variables.count(tokens[i])) return fail("unknown variable " + tokens[i]);
+            auto found = std::find(names.begin(), names.end(), tokens[i]);
+            if (found == names.end() && i == k + 1) return fail("output variable " + tokens[i] + " isn't bound by the inputs");
+            slot[i] = static_cast<int>(found - names.begin());
+            if (found == names.end()) names.push_back(tokens[i]);
+        }
+
+        std::vector<const std::vector<int>*> lists;
+        for (const std::string& varName : names) lists.push_back(&variables[varName]);
+        std::vector<size_t> choice(names.size(), 0);
+        std::vector<int> cells(k + 1), image(k + 1);
+        for (bool more = true; more && !overflow; ) {
+            for (int i = 0; i <= k; i++) cells[i] = slot[i] < 0 ? literal[i] : (*lists[slot[i]])[choice[slot[i]]];
+            int output = slot[k + 1] < 0 ? literal[k + 1] : (*lists[slot[k + 1]])[choice[slot[k + 1]]];
+
+            // Every transition goes in with all its symmetric images, so if this one is in, so are they: that
+            // skips most of the work for lines whose variables already cover every arrangement (permute's)
+            if (++expansions > MAX_EXPANSIONS) overflow = true;
+            bool covered = known(keyOf(cells.data()));
+            if (!covered && symmetry == PERMUTE) {
+                image = cells;
+                std::sort(image.begin() + 1, image.end());
+                do add(image.data(), output);
+                while (std::next_permutation(image.begin() + 1, image.end()) && !overflow);
+            }
+            else if (!covered) for (const std::vector<int>& map : maps) {
+                image[0] = cells[0];
+                for (int i = 0; i < k; i++) image[i + 1] = cells[map[i] + 1];
+                add(image.data(), output);
+            }
+
+            // Next combination of the variables' values
+            more = false;
+            for (size_t v = 0; v < names.size() && !more; v++) {
+                if (++choice[v] < lists[v]->size()) more = true;
+                else choice[v] = 0;
+            }
+        }
+        if (overflow) return fail("the table expands to more than " + std::to_string(MAX_EXPANSIONS) + " transitions");
+    }
+
+    if (!haveTable || !started) {
+        std::cout << "ERROR::RULE_TABLE: " << path << " has no @TABLE transitions" << std::endl;
+        return false;
+    }
+
+    // Unmatched neighbourhoods leave the cell as it is
+    const uint32_t stateMask = (1u << table.bitsPerState) - 1;
+    if (!table.denseTable.empty()) {
+        for (size_t key = 0; key < table.denseTable.size(); key++) {
+            if (!seen[key]) table.denseTable[key] = static_cast<uint8_t>(key & stateMask);
+            table.changing += table.denseTable[key] != (key & stateMask);
+        }
+    }
+    else {
+        std::vector<std::pair<uint64_t, uint8_t>> entries;
+        for (const auto& entry : expanded)
+            if (entry.second != (entry.first & stateMask)) entries.push_back(entry);
+        expanded.clear();
+        std::sort(entries.begin(), entries.end());      // Same table from the same file, whatever the map's order
+        table.changing = entries.size();
+        if (!table.buildPerfectHash(entries)) {
+            std::cout << "ERROR::RULE_TABLE: " << path << ": couldn't build a perfect hash of " << entries.size() << " transitions" << std::endl;
+            return false;
+        }
+    }
+
+    table.colours.assign(table.states, 0);
+    gradient(table.colours, 0xff0000u, 0xffff00u);
+    for (size_t i = 0; i < colourLines.size(); ) {
+        if (colourLines[i] == ~0u) {
+            gradient(table.colours, colourLines[i + 1], colourLines[i + 2]);
+            i += 3;
+            continue;
+        }
+        if (colourLines[i] < static_cast<uint32_t>(table.states)) table.colours[colourLines[i]] = colourLines[i + 1];
+        i += 2;
+    }
+
+    *this = std::move(table);
+    return true;
+}
+
+// Hash & displace: keys are spread over buckets by one hash, & each bucket, biggest first, is given the
+// first seed that sends all its keys to free slots of a second hash. Slots run ~80% full
+bool RuleTable::buildPerfectHash(std::vector<std::pair<uint64_t, uint8_t>>& entries)
+{
+    const size_t bucketCount = std::max<size_t>(1, (entries.size() + 3) / 4);
+    size_t slotCount = std::max<size_t>(1, entries.size() + entries.size() / 4);
+    auto keyHash = [&](size_t entry, uint32_t seed) {
+        return hashKey(static_cast<uint32_t>(entries[entry].first), static_cast<uint32_t>(entries[entry].first >> 32), seed);
+    };
+
+    std::vector<std::vector<size_t>> buckets(bucketCount);
+    for (size_t i = 0; i < entries.size(); i++) buckets[keyHash(i, 0) % bucketCount].push_back(i);
+    std::vector<size_t> order(bucketCount);
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) { return buckets[a].size() > buckets[b].size(); });
+
+    // Rarely a bucket can't be placed: then it's tried again with more room
+    for (int attempt = 0; attempt < 8; attempt++, slotCount += slotCount / 4 + 1) {
+        slots.assign(slotCount, { EMPTY_KEY, EMPTY_KEY, 0, 0 });
+        seeds.assign(bucketCount, 1);
+        std::vector<size_t> placed;
+        bool complete = true;
+        for (size_t b : order) {
+            const std::vector<size_t>& bucket = buckets[b];
+            if (bucket.empty()) break;
+            uint32_t seed = 1;
+            for (; seed < MAX_SEED; seed++) {
+                placed.clear();
+                for (size_t entry : bucket) {
+                    size_t s = keyHash(entry, seed) % slotCount;
+                    if (slots[s].keyHi != EMPTY_KEY || std::find(placed.begin(), placed.end(), s) != placed.end()) break;
+                    placed.push_back(s);
+                }
+                if (placed.size() == bucket.size()) break;
+            }
+            if (seed == MAX_SEED) {
+                complete = false;
+                break;
+            }
+            seeds[b] = seed;
+            for (size_t j = 0; j < bucket.size(); j++) {
+                uint64_t key = entries[bucket[j]].first;
+                slots[placed[j]] = { static_cast<uint32_t>(key), static_cast<uint32_t>(key >> 32), entries[bucket[j]].second, 0 };
+            }
+        }
+        if (complete) return true;
+    }
+    return false;
+}
@@ -0,0 +1,136 @@
+#include <algorithm>
+#include <thread>
+#include "rule_table_engine.h"
+#include "cell_hash.h"
+
+namespace {
+
+const size_t MIN_CELLS_PER_THREAD = 1 << 16;
+
+}
+
+RuleTableEngine::RuleTableEngine(int threads)
+    : threads(threads > 0 ? threads : static_cast<int>(std::max(1u, std::thread::hardware_concurrency())))
+{
+}
+
+void RuleTableEngine::setRule(const RuleTable& table)
+{
+    this->table = &table;
+}
+
+void RuleTableEngine::loadCells(const std::vector<uint32_t>& cells, int width, int height)
+{
+    _width = width;
+    _height = height;
+    stride = static_cast<size_t>(width) + 2;
+    current.assign(stride * (height + 2), 0);
+    next.assign(current.size(), 0);
+    for (int y = 0; y < height; y++)
+        for (int x = 0; x < width; x++) {
+            uint32_t state = cells[static_cast<size_t>(y) * width + x];
+            cell(x, y) = static_cast<uint8_t>(state < static_cast<uint32_t>(table->states) ? state : 1);
+        }
+}
+
+void RuleTableEngine::toCells(std::vector<uint32_t>& cells) const
+{
+    cells.resize(static_cast<size_t>(_width) * _height);
+    for (int y = 0; y < _height; y++)
+        std::copy_n(current.begin() + (y + 1) * stride + 1, _width, cells.begin() + static_cast<size_t>(y) * _width);
+}
+
+void RuleTableEngine::stamp(const PackedGridView& pattern, int x, int y, StampMode mode)
+{
+    int x0 = std::max(x, 0), x1 = std::min(x + pattern.width, _width);
+    int y0 = std::max(y, 0), y1 = std::min(y + pattern.height, _height);
+    for (int j = y0; j < y1; j++)
+        for (int i = x0; i < x1; i++)
+            cell(i, j) = static_cast<uint8_t>(stampState(cell(i, j), pattern.get(i - x, j - y), mode));
+}
+
+void RuleTableEngine::step(GenerationStats* stats)
+{
+    size_t cells = static_cast<size_t>(_width) * _height;
+    int bands = static_cast<int>(std::min<size_t>(threads, std::max<size_t>(1, cells / MIN_CELLS_PER_THREAD)));
+    bands = std::max(1, std::min(bands, _height));
+
+    auto stepBand = table->neighbourCount() == 8 ? &RuleTableEngine::stepRows<8> : &RuleTableEngine::stepRows<4>;
+    std::vector<GenerationStats> bandStats(bands);
+    std::vector<uint32_t> hashLo(bands, 0), hashHi(bands, 0);
+    std::vector<std::thread> workers;
+    for (int b = 1; b < bands; b++)
+        workers.emplace_back(stepBand, this, _height * b / bands, _height * (b + 1) / bands,
+                             std::ref(bandStats[b]), std::ref(hashLo[b]), std::ref(hashHi[b]), stats != nullptr);
+    (this->*stepBand)(0, _height / bands, bandStats[0], hashLo[0], hashHi[0], stats != nullptr);
+    for (std::thread& t : workers) t.join();
+
+    std::swap(current, next);   // The borders are dead in both
+
+    if (stats) {
+        GenerationStats total;
+        uint32_t lo = 0, hi = 0;
+        for (int b = 0; b < bands; b++) {
+            addStats(total, bandStats[b]);
+            lo += hashLo[b];
+            hi += hashHi[b];
+        }
+        total.generation = stats->generation;
+        total.hash = (static_cast<uint64_t>(hi) << 32) | lo;
+        *stats = total;
+    }
+}
+
+template <int NEIGHBOURS>
+void RuleTableEngine::stepRows(int y0, int y1, GenerationStats& stats, uint32_t& hashLo, uint32_t& hashHi, bool hashing)
+{
+    // Golly's neighbour order, north being the row above (+y)
+    const ptrdiff_t s = static_cast<ptrdiff_t>(stride);
+    const ptrdiff_t moore[8] = { s, s + 1, 1, 1 - s, -s, -s - 1, -1, s - 1 };
+    const ptrdiff_t vonNeumann[4] = { s, 1, -s, -1 };
+    const ptrdiff_t* offsets = NEIGHBOURS == 8 ? moore : vonNeumann;
+    const int bits = table->bitsPerState;
+    const uint32_t quiescent = table->lookup(0);    // Empty neighbourhoods skip the lookup (a hashed one's cost)
+
+    for (int y = y0; y < y1; y++) {
+        const uint8_t* row = current.data() + (y + 1) * stride + 1;
+        uint8_t* out = next.data() + (y + 1) * stride + 1;
+        int minX = -1, maxX = -1;
+
+        for (int x = 0; x < _width; x++) {
+            const uint8_t* c = row + x;
+            uint64_t key = c[0];
+            for (int i = 0; i < NEIGHBOURS; i++) key |= static_cast<uint64_t>(c[offsets[i]]) << ((i + 1) * bits);
+            uint32_t state = key ? table->lookup(key) : quiescent;
+            out[x] = static_cast<uint8_t>(state);
+
+            uint32_t was = c[0];
+            if (!state) {
+                stats.deaths += was != 0;
+                continue;
+            }
+            stats.population++;
+            stats.births += was == 0;
+            if (minX < 0) minX = x;
+            maxX = x;
+            if (hashing) {
+                uint32_t lo, hi;
+                cellHash(static_cast<uint32_t>(x), static_cast<uint32_t>(y), lo, hi);
+                if (state > 1) {
+                    lo = lowbias32(lo + state);
+                    hi = lowbias32(hi + state);
+                }
+                hashLo += lo;
+                hashHi += hi;
+            }
+        }
+
+        if (minX < 0) continue;
+        if (stats.maxX < stats.minX) {
+            stats.minX = minX; stats.maxX = maxX; stats.minY = y;
+        }
+        stats.minX = std::min(stats.minX, minX);
+        stats.maxX = std::max(stats.maxX, maxX);
+        stats.maxY = y;
+    }
+}
@@ -51,6 +51,14 @@ void ShaderProgram::setFloat_w_Loc(GLint location, float value) const
 { 
     glUniform1f(location, value); 
 }
+void ShaderProgram::set2Floats_w_Name(const std::string &name, float value0, float value1) const
+{
+    glUniform2f(glGetUniformLocation(ID, name.c_str()), value0, value1);
+}
+void ShaderProgram::set2Floats_w_Loc(GLint location, float value0, float value1) const
+{
+    glUniform2f(location, value0, value1);
+}
 void ShaderProgram::set4Floats_w_Name(const std::string &name, float value0, float value1, float value2, float value3) const
 {
     glUniform4f(glGetUniformLocation(ID, name.c_str()), value0, value1, value2, value3);
@@ -73,7 +81,7 @@ void ShaderProgram::setMat4_w_Loc(GLint location, GLboolean transpose, const GLf
 #include <iomanip>
 
 // UTILITIES
-unsigned ShaderProgram::readAndCompileShaderFile(const char* shaderPath, unsigned& shaderID, std::string shaderType)
+unsigned ShaderProgram::readAndCompileShaderFile(const char* shaderPath, unsigned& shaderID, std::string shaderType, const std::string& prelude)
 {
     std::ifstream file(shaderPath, std::ios::binary); // Open as binary to try to stop formatting errors
     
@@ -103,6 +111,12 @@ unsigned ShaderProgram::readAndCompileShaderFile(const char* shaderPath, unsigne
         }
     }
 
+    // Specialisations go after the #version line, which must stay first
+    if (!prelude.empty()) {
+        size_t lineEnd = content.find('\n');
+        content.insert(lineEnd == std::string::npos ? content.size() : lineEnd + 1, prelude);
+    }
+
     const char* shaderCode = content.c_str();
     glShaderSource(shaderID, 1, &shaderCode, NULL);
     glCompileShader(shaderID);
@@ -0,0 +1,17 @@
+#version 430 core
+
+in vec2 hexCoord;
+out vec4 fragColor;
+
+layout (location = 1) uniform vec4 Color = vec4(vec3(0.0), 1.0);
+
+// Just inside the hexagon's inner radius (0.5), leaving a gap between neighbours
+const float INSET = 0.46;
+
+void main()
+{
+    // Pointy-top hexagon: the vertical sides, then the four sloping ones
+    vec2 p = abs(hexCoord);
+    if (p.x > INSET || 0.5 * p.x + 0.8660254 * p.y > INSET) discard;
+    fragColor = Color;
+}
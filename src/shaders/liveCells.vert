@@ -0,0 +1,37 @@
+#version 430 core
+layout (location = 0) in uint cellIndex;    // Per instance, from the compacted live cell list
+
+uniform int numCellsX;
+uniform int numCellsY;
+uniform bool hexagonal = false;     // Hexagonal rule: rows shifted half a cell each, cells drawn as hexagons
+
+out vec2 hexCoord;                  // Position in the hexagon's quad, from its centre (hexCells.frag)
+flat out uint boardIndex;           // The cell's, for looking up its state (stateCells.frag)
+
+// Two triangles per cell quad
+const vec2 CORNERS[6] = vec2[](vec2(0.0, 0.0), vec2(1.0, 0.0), vec2(1.0, 1.0),
+                               vec2(1.0, 1.0), vec2(0.0, 1.0), vec2(0.0, 0.0));
+
+// Pointy-top hexagons 1 wide: rows sqrt(3)/2 apart, each hexagon's half height 1/sqrt(3)
+const float ROW_HEIGHT = 0.8660254;
+const float HALF_HEIGHT = 0.5773503;
+
+void main()
+{
+    vec2 cell = vec2(float(cellIndex % uint(numCellsX)), float(cellIndex / uint(numCellsX)));
+    boardIndex = cellIndex;
+    if (!hexagonal) {
+        vec2 scale = 2.0 / vec2(numCellsX, numCellsY);
+        gl_Position = vec4((cell + CORNERS[gl_VertexID]) * scale - 1.0, 0.0, 1.0);
+        return;
+    }
+
+    // The skewed storage's neighbours (x, y-1) & (x+1, y-1) sit either side below a cell, so each row is
+    // half a cell right of the one under it. Uniform scale keeps the hexagons regular, the board centred
+    float rows = float(numCellsY - 1);
+    vec2 centre = vec2(cell.x + 0.5 + 0.5 * cell.y, HALF_HEIGHT + ROW_HEIGHT * cell.y);
+    vec2 extent = vec2(float(numCellsX) + 0.5 * rows, ROW_HEIGHT * rows + 2.0 * HALF_HEIGHT);
+    float scale = 2.0 / max(extent.x, extent.y);
+    hexCoord = (CORNERS[gl_VertexID] - 0.5) * vec2(1.0, 2.0 * HALF_HEIGHT);
+    gl_Position = vec4((centre + hexCoord - 0.5 * extent) * scale, 0.0, 1.0);
+}
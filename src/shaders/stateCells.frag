@@ -0,0 +1,17 @@
+#version 430 core
+
+flat in uint boardIndex;
+out vec4 fragColor;
+
+// Multi-state boards (rule tables, continuous levels): each cell in its state's colour
+layout (std430, binding = 0) readonly buffer Cells {     // The current board
+    uint CellStates[];
+};
+layout (std430, binding = 16) readonly buffer Palette {
+    vec4 StateColours[];
+};
+
+void main()
+{
+    fragColor = StateColours[CellStates[boardIndex]];
+}
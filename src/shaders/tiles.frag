@@ -0,0 +1,40 @@
+#version 430 core
+
+out vec4 fragColor;
+
+// Tile cache (see TileCache)
+uniform usampler2D atlas;       // Resident tiles, each a 2x64 block of packed cell bits
+uniform usampler2D pageTable;   // Tile coords mod pageTableDim -> atlas slot + 1 (0 = empty, 0xffffffff = not loaded yet)
+uniform int pageTableDim;
+uniform int atlasSlotsPerRow;
+
+// View
+uniform vec2 viewOrigin;        // Board position at the bottom-left corner of the viewport
+uniform float cellsPerPixel;
+
+uniform vec4 liveColour = vec4(vec3(0.0), 1.0);
+uniform vec4 deadColour = vec4(vec3(0.85), 1.0);
+uniform vec4 unloadedColour = vec4(vec3(0.6), 1.0);
+
+void main()
+{
+    ivec2 cell = ivec2(floor(viewOrigin + gl_FragCoord.xy * cellsPerPixel));
+    ivec2 tile = cell >> 6;     // Arithmetic shift, so negative coords land in the right tile
+    ivec2 local = cell & 63;
+
+    uint entry = texelFetch(pageTable, tile & (pageTableDim - 1), 0).r;
+    if (entry == 0u) {
+        fragColor = deadColour;
+        return;
+    }
+    if (entry == 0xffffffffu) {
+        fragColor = unloadedColour;
+        return;
+    }
+
+    int slot = int(entry - 1u);
+    ivec2 slotBase = ivec2((slot % atlasSlotsPerRow) * 2, (slot / atlasSlotsPerRow) * 64);
+    uint word = texelFetch(atlas, slotBase + ivec2(local.x >> 5, local.y), 0).r;
+
+    fragColor = ((word >> uint(local.x & 31)) & 1u) != 0u ? liveColour : deadColour;
+}
@@ -0,0 +1,112 @@
+#version 430 core
+
+out vec4 fragColor;
+
+// Volume (see VoxelEngine): bit (x & 63) of 64-bit word (x >> 6) of row (y, z), as pairs of uints low half first
+uniform ivec3 volumeSize;
+uniform int wordsPerRow;
+uniform ivec3 brickCounts;      // Bricks are 64 x 8 x 8 cells
+
+uniform mat4 inverseViewProjection;
+uniform vec3 eye;
+uniform vec2 viewportSize;
+
+uniform vec4 backgroundColour = vec4(vec3(0.85), 1.0);
+
+layout (std430, binding = 14) readonly buffer Volume {
+    uint VolumeWords[];
+};
+layout (std430, binding = 15) readonly buffer Bricks {
+    uint BrickOccupied[];       // Non-zero if the brick holds live cells
+};
+
+const ivec3 BRICK = ivec3(64, 8, 8);
+const int MAX_STEPS = 4096;     // Voxels & brick skips along one ray
+
+bool alive(ivec3 v)
+{
+    int word = (v.z * volumeSize.y + v.y) * wordsPerRow + (v.x >> 6);
+    return ((VolumeWords[word * 2 + ((v.x >> 5) & 1)] >> uint(v.x & 31)) & 1u) != 0u;
+}
+
+bool brickOccupied(ivec3 v)
+{
+    ivec3 b = v / BRICK;
+    return BrickOccupied[(b.z * brickCounts.y + b.y) * brickCounts.x + b.x] != 0u;
+}
+
+// Distances along the ray to where it enters & leaves the box [low, high]
+vec2 boxSpan(vec3 low, vec3 high, vec3 invDir)
+{
+    vec3 t0 = (low - eye) * invDir, t1 = (high - eye) * invDir;
+    vec3 near = min(t0, t1), far = max(t0, t1);
+    return vec2(max(max(near.x, near.y), near.z), min(min(far.x, far.y), far.z));
+}
+
+vec4 shade(ivec3 v, vec3 normal)
+{
+    vec3 base = mix(vec3(0.15, 0.35, 0.75), vec3(0.9, 0.45, 0.2), vec3(v) / vec3(volumeSize));
+    float light = 0.45 + 0.55 * max(dot(normal, normalize(vec3(0.4, 0.8, 0.5))), 0.0);
+    return vec4(base * light, 1.0);
+}
+
+void main()
+{
+    vec2 ndc = gl_FragCoord.xy / viewportSize * 2.0 - 1.0;
+    vec4 farPoint = inverseViewProjection * vec4(ndc, 1.0, 1.0);
+    vec3 dir = normalize(farPoint.xyz / farPoint.w - eye);
+    dir = mix(dir, vec3(1e-6), equal(dir, vec3(0.0)));     // No infinite slopes
+    vec3 invDir = 1.0 / dir;
+    ivec3 stepDir = ivec3(sign(dir));
+
+    vec2 span = boxSpan(vec3(0.0), vec3(volumeSize), invDir);
+    if (span.x >= span.y || span.y <= 0.0) {
+        fragColor = backgroundColour;
+        return;
+    }
+
+    // Normal of the face the ray came in through: the box's, then the last voxel / brick boundary crossed
+    vec3 t0 = (vec3(0.0) - eye) * invDir, t1 = (vec3(volumeSize) - eye) * invDir, near = min(t0, t1);
+    vec3 normal = near.x >= near.y && near.x >= near.z ? vec3(-stepDir.x, 0, 0) :
+                  near.y >= near.z ? vec3(0, -stepDir.y, 0) : vec3(0, 0, -stepDir.z);
+
+    float t = max(span.x, 0.0);
+    int steps = 0;
+    while (t < span.y && steps < MAX_STEPS) {
+        ivec3 v = clamp(ivec3(floor(eye + dir * (t + 1e-3))), ivec3(0), volumeSize - 1);
+        ivec3 brickLow = v / BRICK * BRICK, brickHigh = min(brickLow + BRICK, volumeSize);
+        vec2 brickSpan = boxSpan(vec3(brickLow), vec3(brickHigh), invDir);
+        steps++;
+
+        if (!brickOccupied(v)) {
+            // Out through the brick's far side
+            vec3 exitT = max((vec3(brickLow) - eye) * invDir, (vec3(brickHigh) - eye) * invDir);
+            normal = exitT.x <= exitT.y && exitT.x <= exitT.z ? vec3(-stepDir.x, 0, 0) :
+                     exitT.y <= exitT.z ? vec3(0, -stepDir.y, 0) : vec3(0, 0, -stepDir.z);
+            t = brickSpan.y;
+            continue;
+        }
+
+        // Voxel by voxel (Amanatides & Woo) until a live cell or the brick's edge
+        vec3 nextT = (vec3(v) + vec3(greaterThan(stepDir, ivec3(0))) - eye) * invDir;
+        vec3 deltaT = abs(invDir);
+        while (steps < MAX_STEPS) {
+            if (alive(v)) {
+                fragColor = shade(v, normal);
+                return;
+            }
+            steps++;
+            if (nextT.x <= nextT.y && nextT.x <= nextT.z) {
+                t = nextT.x;    nextT.x += deltaT.x;    v.x += stepDir.x;   normal = vec3(-stepDir.x, 0, 0);
+            }
+            else if (nextT.y <= nextT.z) {
+                t = nextT.y;    nextT.y += deltaT.y;    v.y += stepDir.y;   normal = vec3(0, -stepDir.y, 0);
+            }
+            else {
+                t = nextT.z;    nextT.z += deltaT.z;    v.z += stepDir.z;   normal = vec3(0, 0, -stepDir.z);
+            }
+            if (any(lessThan(v, brickLow)) || any(greaterThanEqual(v, brickHigh))) break;
+        }
+    }
+    fragColor = backgroundColour;
+}
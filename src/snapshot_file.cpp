@@ -0,0 +1,152 @@
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include "snapshot_file.h"
+
+#ifdef _WIN32
+#include <io.h>
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+const char MAGIC[8] = { 'G', 'O', 'L', 'S', 'N', 'A', 'P', '\0' };
+
+bool syncFile(FILE* file)
+{
+    if (fflush(file) != 0) return false;
+#ifdef _WIN32
+    return _commit(_fileno(file)) == 0;
+#else
+    return fsync(fileno(file)) == 0;
+#endif
+}
+
+// Atomically replaces 'path' with 'tmpPath'
+bool replaceFile(const std::string& tmpPath, const std::string& path, bool durable)
+{
+#ifdef _WIN32
+    return MoveFileExA(tmpPath.c_str(), path.c_str(), MOVEFILE_REPLACE_EXISTING | (durable ? MOVEFILE_WRITE_THROUGH : 0)) != 0;
+#else
+    if (rename(tmpPath.c_str(), path.c_str()) != 0) return false;
+    if (durable) {
+        // The rename itself only survives a power cut once the directory is flushed
+        size_t slash = path.find_last_of('/');
+        std::string dir = slash == std::string::npos ? "." : path.substr(0, slash + 1);
+        int fd = ::open(dir.c_str(), O_RDONLY);
+        if (fd >= 0) {
+            fsync(fd);
+            ::close(fd);
+        }
+    }
+    return true;
+#endif
+}
+
+}
+
+uint64_t SnapshotFile::checksum(const uint64_t* words, size_t count)
+{
+    // Four independent lanes so the multiply chains overlap
+    uint64_t lanes[4] = { 0x9E3779B97F4A7C15ull, 0xC2B2AE3D27D4EB4Full, 0x165667B19E3779F9ull, 0x27D4EB2F165667C5ull };
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4)
+        for (int l = 0; l < 4; l++) {
+            uint64_t h = lanes[l] ^ words[i + l];
+            lanes[l] = ((h << 31) | (h >> 33)) * 0x9E3779B97F4A7C15ull;
+        }
+    uint64_t h = lanes[0] ^ (lanes[1] * 3) ^ (lanes[2] * 5) ^ (lanes[3] * 7) ^ count;
+    for (; i < count; i++) h = (h ^ words[i]) * 0x100000001B3ull;
+    return h ^ (h >> 29);
+}
+
+bool SnapshotFile::save(const std::string& path, const PackedGridView& grid, const LifeRule& rule,
+                        unsigned long long generation, Topology topology, bool durable)
+{
+    if (grid.wordsPerRow % PackedGrid::ROW_ALIGN_WORDS != 0) {
+        std::cout << "ERROR::SNAPSHOT::UNALIGNED_ROWS" << std::endl;
+        return false;
+    }
+
+    Header header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = VERSION;
+    header.headerBytes = HEADER_BYTES;
+    header.width = static_cast<uint32_t>(grid.width);
+    header.height = static_cast<uint32_t>(grid.height);
+    header.wordsPerRow = static_cast<uint32_t>(grid.wordsPerRow);
+    header.topology = topology;
+    header.generation = generation;
+    header.birthMask = rule.birthMask;
+    header.surviveMask = rule.surviveMask;
+    header.dataBytes = static_cast<uint64_t>(grid.wordsPerRow) * grid.height * sizeof(uint64_t);
+    header.checksum = checksum(grid.words, grid.wordsPerRow * grid.height);
+
+    std::string tmpPath = path + ".tmp";
+    FILE* file = fopen(tmpPath.c_str(), "wb");
+    if (!file) {
+        std::cout << "ERROR::SNAPSHOT::CANT_CREATE: " << tmpPath << std::endl;
+        return false;
+    }
+    bool ok = fwrite(&header, sizeof(header), 1, file) == 1;
+    if (ok && header.dataBytes) ok = fwrite(grid.words, static_cast<size_t>(header.dataBytes), 1, file) == 1;
+    if (ok && durable) ok = syncFile(file);
+    ok = (fclose(file) == 0) && ok;
+    ok = ok && replaceFile(tmpPath, path, durable);
+    if (!ok) {
+        std::cout << "ERROR::SNAPSHOT::WRITE_FAILED: " << path << std::endl;
+        remove(tmpPath.c_str());
+    }
+    return ok;
+}
+
+bool SnapshotFile::open(const std::string& path)
+{
+    if (!file.open(path)) return false;
+
+    // The header is only read once the file is known to hold one
+    const char* problem = nullptr;
+    if (file.size() < HEADER_BYTES) {
+        std::cout << "ERROR::SNAPSHOT::NOT_A_SNAPSHOT: " << path << std::endl;
+        file.close();
+        return false;
+    }
+    const Header& h = header();
+    if (std::memcmp(h.magic, MAGIC, sizeof(MAGIC)) != 0)                                   problem = "NOT_A_SNAPSHOT";
+    else if (h.version != VERSION || h.headerBytes != HEADER_BYTES)                         problem = "UNSUPPORTED_VERSION";
+    else if (h.wordsPerRow % PackedGrid::ROW_ALIGN_WORDS != 0 ||
+             h.wordsPerRow < (static_cast<uint64_t>(h.width) + 63) / 64)                    problem = "BAD_ROW_LAYOUT";
+    else if (h.dataBytes != static_cast<uint64_t>(h.wordsPerRow) * h.height * sizeof(uint64_t) ||
+             file.size() - HEADER_BYTES < h.dataBytes)                                      problem = "TRUNCATED";
+
+    if (problem) {
+        std::cout << "ERROR::SNAPSHOT::" << problem << ": " << path << std::endl;
+        file.close();
+        return false;
+    }
+    return true;
+}
+
+PackedGridView SnapshotFile::grid() const
+{
+    const Header& h = header();
+    return { data(), static_cast<int>(h.width), static_cast<int>(h.height), h.wordsPerRow };
+}
+
+LifeRule SnapshotFile::rule() const
+{
+    LifeRule rule;
+    rule.birthMask = header().birthMask;
+    rule.surviveMask = header().surviveMask;
+    return rule;
+}
+
+bool SnapshotFile::verifyChecksum() const
+{
+    const Header& h = header();
+    return checksum(data(), static_cast<size_t>(h.dataBytes / sizeof(uint64_t))) == h.checksum;
+}
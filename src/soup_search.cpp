@@ -0,0 +1,102 @@
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <thread>
+#include <vector>
+#include "soup_search.h"
+#include "cpu_life_engine.h"
+#include "period_detector.h"
+
+namespace {
+
+// SplitMix64's output function: a strong enough mix that consecutive counters give independent words
+uint64_t mix64(uint64_t x)
+{
+    x += 0x9E3779B97F4A7C15ull;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+    return x ^ (x >> 31);
+}
+
+}
+
+SoupSearch::SoupSearch(const Settings& settings)
+    : settings(settings), _census(1)
+{
+    if (this->settings.threads <= 0) this->settings.threads = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    _census.setRule(settings.rule);
+}
+
+void SoupSearch::writeSoup(uint64_t seed, uint64_t index, PackedGrid& grid, int x, int y)
+{
+    // 256 cells = 4 words, each a hash of (seed, soup, word)
+    for (int w = 0; w < SOUP_SIZE * SOUP_SIZE / 64; w++) {
+        uint64_t bits = mix64(mix64(seed) ^ mix64(index * 4 + w));
+        for (int i = 0; i < 64; i++)
+            if ((bits >> i) & 1) grid.set(x + (w * 64 + i) % SOUP_SIZE, y + (w * 64 + i) / SOUP_SIZE, true);
+    }
+}
+
+void SoupSearch::run()
+{
+    auto start = std::chrono::steady_clock::now();
+    std::vector<ObjectCensus> censuses(settings.threads, ObjectCensus(1));
+    std::vector<std::thread> workers;
+    for (int t = 0; t < settings.threads; t++) {
+        censuses[t].setRule(settings.rule);
+        workers.emplace_back(&SoupSearch::worker, this, std::ref(censuses[t]));
+    }
+
+    // Progress every couple of seconds
+    uint64_t reported = 0;
+    while (soupsDone < settings.soups) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        if (elapsed >= 2.0 * (reported + 1)) {
+            reported = static_cast<uint64_t>(elapsed / 2.0);
+            std::cout << soupsDone << " / " << settings.soups << " soups, " << static_cast<uint64_t>(soupsDone / elapsed) << " soups/s" << std::endl;
+        }
+    }
+    for (std::thread& t : workers) t.join();
+
+    _census.clear();
+    for (const ObjectCensus& census : censuses) _census.merge(census);
+    _seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+void SoupSearch::worker(ObjectCensus& census)
+{
+    const int soupOrigin = (UNIVERSE_SIZE - SOUP_SIZE) / 2;
+    CpuLifeEngine engine(1);
+    engine.setRule(settings.rule);
+    PeriodDetector detector(settings.maxPeriod);
+    PackedGrid board(UNIVERSE_SIZE, UNIVERSE_SIZE);
+
+    // The border band, as patterns to clear with
+    PackedGrid rows(UNIVERSE_SIZE, BORDER), columns(BORDER, UNIVERSE_SIZE);
+    for (int y = 0; y < BORDER; y++) rows.setRun(0, y, UNIVERSE_SIZE);
+    for (int y = 0; y < UNIVERSE_SIZE; y++) columns.setRun(0, y, BORDER);
+
+    for (uint64_t soup = nextSoup++; soup < settings.soups; soup = nextSoup++) {
+        board.clear();
+        writeSoup(settings.seed, soup, board, soupOrigin, soupOrigin);
+        engine.load(board);
+        detector.reset();
+
+        bool settled = false;
+        for (unsigned long long generation = 1; generation <= settings.maxGenerations && !settled; generation++) {
+            engine.step();
+            if (generation % BORDER_INTERVAL == 0) {
+                engine.stamp(rows.view(), 0, 0, STAMP_CLEAR);
+                engine.stamp(rows.view(), 0, UNIVERSE_SIZE - BORDER, STAMP_CLEAR);
+                engine.stamp(columns.view(), 0, 0, STAMP_CLEAR);
+                engine.stamp(columns.view(), UNIVERSE_SIZE - BORDER, 0, STAMP_CLEAR);
+            }
+            settled = detector.add(generation, engine.hash()) != 0;
+        }
+
+        if (settled) census.take(engine.board());
+        else _unsettled++;
+        soupsDone++;
+    }
+}
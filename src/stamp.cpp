@@ -0,0 +1,148 @@
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+#include "stamp.h"
+#include "rle_file.h"
+
+namespace {
+
+// Applies 64 pattern cells (valid where 'mask' is set) starting at board column 'dx' to one board row
+void stampWord(uint64_t* row, long long words, uint64_t lastMask, long long dx, uint64_t bits, uint64_t mask, StampMode mode)
+{
+    long long wordIndex = dx >= 0 ? dx / 64 : -((-dx + 63) / 64);
+    int shift = static_cast<int>(dx - wordIndex * 64);
+
+    for (int part = 0; part < 2; part++) {
+        long long w = wordIndex + part;
+        if (part == 1 && shift == 0) break;
+        uint64_t b = part == 0 ? bits << shift : bits >> (64 - shift);
+        uint64_t m = part == 0 ? mask << shift : mask >> (64 - shift);
+        if (w < 0 || w >= words) continue;
+        if (w == words - 1) { b &= lastMask; m &= lastMask; }
+
+        uint64_t& word = row[w];
+        switch (mode) {
+            case STAMP_OR:      word |= b;                  break;
+            case STAMP_XOR:     word ^= b;                  break;
+            case STAMP_REPLACE: word = (word & ~m) | b;     break;
+            default:            word &= ~b;                 break;
+        }
+    }
+}
+
+}
+
+bool parseStampMode(const std::string& text, StampMode& mode)
+{
+    if (text == "or")           mode = STAMP_OR;
+    else if (text == "xor")     mode = STAMP_XOR;
+    else if (text == "replace") mode = STAMP_REPLACE;
+    else if (text == "clear")   mode = STAMP_CLEAR;
+    else return false;
+    return true;
+}
+
+void stampGrid(PackedGrid& grid, const PackedGridView& pattern, int x, int y, StampMode mode)
+{
+    const long long words = static_cast<long long>(grid.usedWordsPerRow());
+    const uint64_t lastMask = (grid.width() & 63) ? ~0ull >> (64 - (grid.width() & 63)) : ~0ull;
+    const size_t patternWords = (static_cast<size_t>(pattern.width) + 63) / 64;
+    const uint64_t patternLastMask = (pattern.width & 63) ? ~0ull >> (64 - (pattern.width & 63)) : ~0ull;
+
+    for (int py = 0; py < pattern.height; py++) {
+        int gy = y + py;
+        if (gy < 0 || gy >= grid.height()) continue;
+        const uint64_t* source = pattern.row(py);
+        for (size_t pw = 0; pw < patternWords; pw++) {
+            uint64_t mask = pw + 1 == patternWords ? patternLastMask : ~0ull;
+            stampWord(grid.row(gy), words, lastMask, x + static_cast<long long>(pw) * 64, source[pw] & mask, mask, mode);
+        }
+    }
+}
+
+GpuStamper::GpuStamper()
+    : shader(SHADER_PATH "stamp.comp")
+{
+    glGenBuffers(1, &patternBuf);
+}
+
+GpuStamper::~GpuStamper()
+{
+    glDeleteBuffers(1, &patternBuf);
+}
+
+void GpuStamper::stamp(GLuint cellsBuf, int numCellsX, int numCellsY, const PackedGridView& pattern, int x, int y, StampMode mode)
+{
+    size_t bytes = pattern.wordsPerRow * pattern.height * sizeof(uint64_t);
+    if (bytes == 0) return;
+
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, patternBuf);
+    if (bytes > patternBufBytes) {
+        patternBufBytes = std::max(bytes, 2 * patternBufBytes);
+        glBufferData(GL_SHADER_STORAGE_BUFFER, patternBufBytes, NULL, GL_STREAM_DRAW);
+    }
+    glBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, bytes, pattern.words);
+
+    shader.use();
+    shader.setInt_w_Name("numCellsX", numCellsX);
+    shader.setInt_w_Name("numCellsY", numCellsY);
+    shader.setInt_w_Name("originX", x);
+    shader.setInt_w_Name("originY", y);
+    shader.setInt_w_Name("patternWidth", pattern.width);
+    shader.setInt_w_Name("patternHeight", pattern.height);
+    shader.setInt_w_Name("patternWordsPerRow", static_cast<int>(pattern.wordsPerRow * 2));
+    shader.setInt_w_Name("mode", mode);
+
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, cellsBuf);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 2, patternBuf);
+    glDispatchCompute((pattern.width + 7) / 8, (pattern.height + 7) / 8, 1);
+    glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+}
+
+bool StampScript::load(const std::string& path)
+{
+    std::ifstream file(path);
+    if (!file.is_open()) {
+        std::cout << "ERROR::STAMP_SCRIPT::FILE_NOT_FOUND: " << path << std::endl;
+        return false;
+    }
+
+    std::string line;
+    int lineNumber = 0;
+    while (std::getline(file, line)) {
+        lineNumber++;
+        line = line.substr(0, line.find('#'));
+        std::istringstream fields(line);
+        Entry entry;
+        std::string modeText, patternPath;
+        if (!(fields >> entry.generation)) continue;    // Blank / comment line
+        if (!(fields >> entry.x >> entry.y >> modeText >> patternPath) || !parseStampMode(modeText, entry.mode)) {
+            std::cout << "ERROR::STAMP_SCRIPT::BAD_LINE " << lineNumber << ": " << line << std::endl;
+            return false;
+        }
+
+        auto known = patternIndex.find(patternPath);
+        if (known == patternIndex.end()) {
+            RLEFile::Header header;
+            if (!RLEFile::readHeader(patternPath, header)) return false;
+            PackedGrid pattern(static_cast<int>(header.width), static_cast<int>(header.height));
+            if (!RLEFile::load(patternPath, pattern, 0, 0)) return false;
+            patterns.push_back(std::move(pattern));
+            known = patternIndex.emplace(patternPath, patterns.size() - 1).first;
+        }
+        entry.pattern = known->second;
+        entries.push_back(entry);
+    }
+
+    std::stable_sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) { return a.generation < b.generation; });
+    return true;
+}
+
+const StampScript::Entry* StampScript::next(unsigned long long generation)
+{
+    if (nextEntry >= entries.size() || entries[nextEntry].generation > generation) return nullptr;
+    return &entries[nextEntry++];
+}
@@ -0,0 +1,203 @@
+#include <algorithm>
+#include <cmath>
+#include "tile_cache.h"
+
+TileCache::TileCache(size_t atlasBudgetBytes, int maxUploadsPerFrame)
+    : maxUploadsPerFrame(maxUploadsPerFrame)
+{
+    const size_t tileBytes = TileStore::TILE_SIZE * sizeof(uint64_t);
+    _capacity = std::max<size_t>(1, atlasBudgetBytes / tileBytes);
+
+    // Lay slots out so the atlas is roughly square, within the texture size limit
+    GLint maxTexSize = 0;
+    glGetIntegerv(GL_MAX_TEXTURE_SIZE, &maxTexSize);
+    slotsPerRow = static_cast<int>(std::ceil(std::sqrt(static_cast<double>(_capacity) * 32.0)));
+    slotsPerRow = std::max(1, std::min(slotsPerRow, maxTexSize / 2));
+    int slotRows = static_cast<int>((_capacity + slotsPerRow - 1) / slotsPerRow);
+    slotRows = std::min(slotRows, maxTexSize / TileStore::TILE_SIZE);
+    _capacity = std::min(_capacity, static_cast<size_t>(slotsPerRow) * slotRows);
+
+    glGenTextures(1, &atlasTex);
+    glBindTexture(GL_TEXTURE_2D, atlasTex);
+    glTexStorage2D(GL_TEXTURE_2D, 1, GL_R32UI, slotsPerRow * 2, slotRows * TileStore::TILE_SIZE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+
+    pageTable.assign(static_cast<size_t>(PAGE_TABLE_DIM) * PAGE_TABLE_DIM, EMPTY_TILE);
+    glGenTextures(1, &pageTableTex);
+    glBindTexture(GL_TEXTURE_2D, pageTableTex);
+    glTexStorage2D(GL_TEXTURE_2D, 1, GL_R32UI, PAGE_TABLE_DIM, PAGE_TABLE_DIM);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, PAGE_TABLE_DIM, PAGE_TABLE_DIM, GL_RED_INTEGER, GL_UNSIGNED_INT, pageTable.data());
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    freeSlots.reserve(_capacity);
+    for (size_t i = _capacity; i > 0; i--) freeSlots.push_back(static_cast<GLuint>(i - 1));
+}
+
+TileCache::~TileCache()
+{
+    glDeleteTextures(1, &atlasTex);
+    glDeleteTextures(1, &pageTableTex);
+}
+
+int TileCache::maxVisibleTiles() const
+{
+    // One tile of slack either side as the view rarely lines up with tile boundaries
+    int byCapacity = static_cast<int>(std::sqrt(static_cast<double>(_capacity)));
+    return std::min(PAGE_TABLE_DIM, byCapacity) - 2;
+}
+
+void TileCache::update(const TileStore& store, int64_t minX, int64_t minY, int64_t maxX, int64_t maxY)
+{
+    int32_t tx0 = static_cast<int32_t>(minX >> TileStore::TILE_SHIFT), tx1 = static_cast<int32_t>(maxX >> TileStore::TILE_SHIFT);
+    int32_t ty0 = static_cast<int32_t>(minY >> TileStore::TILE_SHIFT), ty1 = static_cast<int32_t>(maxY >> TileStore::TILE_SHIFT);
+    tx1 = std::min(tx1, tx0 + PAGE_TABLE_DIM - 1);
+    ty1 = std::min(ty1, ty0 + PAGE_TABLE_DIM - 1);
+    const double centreX = 0.5 * (tx0 + tx1), centreY = 0.5 * (ty0 + ty1);
+
+    // 1. Find the visible tiles that exist, walking whichever is smaller: the window or the store
+    std::vector<std::pair<double, uint64_t>> needed;
+    const uint64_t windowArea = static_cast<uint64_t>(tx1 - tx0 + 1) * (ty1 - ty0 + 1);
+    auto consider = [&](int32_t tx, int32_t ty) {
+        double dx = tx - centreX, dy = ty - centreY;
+        needed.push_back({ dx*dx + dy*dy, TileStore::key(tx, ty) });
+    };
+    if (windowArea <= store.tileCount()) {
+        for (int32_t ty = ty0; ty <= ty1; ty++)
+            for (int32_t tx = tx0; tx <= tx1; tx++)
+                if (store.findTile(tx, ty)) consider(tx, ty);
+    }
+    else {
+        for (const auto& kv : store.allTiles()) {
+            int32_t tx = TileStore::keyX(kv.first), ty = TileStore::keyY(kv.first);
+            if (tx >= tx0 && tx <= tx1 && ty >= ty0 && ty <= ty1) consider(tx, ty);
+        }
+    }
+
+    // 2. Central tiles win when more are visible than fit
+    size_t numResident = std::min(needed.size(), _capacity);
+    if (needed.size() > numResident)
+        std::nth_element(needed.begin(), needed.begin() + numResident, needed.end());
+    std::sort(needed.begin(), needed.begin() + numResident);
+
+    // 3. Touch resident tiles first so none of them can be evicted by this frame's loads
+    for (size_t i = 0; i < numResident; i++) {
+        auto it = entries.find(needed[i].second);
+        if (it != entries.end()) lru.splice(lru.begin(), lru, it->second.lruPos);
+    }
+
+    // 4. Upload new / changed tiles, within the per-frame budget
+    _uploadsLastFrame = 0;
+    std::vector<char> resident(numResident, 0);
+    for (size_t i = 0; i < numResident; i++) {
+        uint64_t k = needed[i].second;
+        const TileStore::Tile* tile = store.findTile(TileStore::keyX(k), TileStore::keyY(k));
+        auto it = entries.find(k);
+
+        if (it != entries.end() && it->second.version == tile->version) {
+            resident[i] = 1;
+            continue;
+        }
+        if (_uploadsLastFrame >= static_cast<size_t>(maxUploadsPerFrame)) continue;   // Streams in over the next frames
+
+        if (it == entries.end()) {
+            GLuint slot = acquireSlot();
+            lru.push_front(k);
+            it = entries.emplace(k, Entry{ slot, 0, lru.begin() }).first;
+        }
+        uploadTile(it->second.slot, *tile);
+        it->second.version = tile->version;
+        _uploadsLastFrame++;
+        resident[i] = 1;
+    }
+
+    // 5. Rewrite the page table window
+    std::vector<GLuint> window(windowArea, EMPTY_TILE);
+    for (size_t i = 0; i < needed.size(); i++) {
+        uint64_t k = needed[i].second;
+        GLuint value = UNLOADED_TILE;
+        if (i < numResident && resident[i]) value = entries[k].slot + 1;
+        window[static_cast<size_t>(TileStore::keyY(k) - ty0) * (tx1 - tx0 + 1) + (TileStore::keyX(k) - tx0)] = value;
+    }
+
+    const int mask = PAGE_TABLE_DIM - 1;
+    bool changed = false;
+    for (int32_t ty = ty0; ty <= ty1; ty++) {
+        for (int32_t tx = tx0; tx <= tx1; tx++) {
+            GLuint& entry = pageTable[static_cast<size_t>(ty & mask) * PAGE_TABLE_DIM + (tx & mask)];
+            GLuint value = window[static_cast<size_t>(ty - ty0) * (tx1 - tx0 + 1) + (tx - tx0)];
+            if (entry != value) {
+                entry = value;
+                changed = true;
+            }
+        }
+    }
+    if (!changed) return;
+
+    // The window may wrap around the table edges: upload as up to 4 sub-rects
+    int wx0 = tx0 & mask, wy0 = ty0 & mask;
+    int w = tx1 - tx0 + 1, h = ty1 - ty0 + 1;
+    int wFirst = std::min(w, PAGE_TABLE_DIM - wx0), hFirst = std::min(h, PAGE_TABLE_DIM - wy0);
+    uploadPageTableRect(wx0, wy0, wx0 + wFirst, wy0 + hFirst);
+    if (w > wFirst)                 uploadPageTableRect(0, wy0, w - wFirst, wy0 + hFirst);
+    if (h > hFirst)                 uploadPageTableRect(wx0, 0, wx0 + wFirst, h - hFirst);
+    if (w > wFirst && h > hFirst)   uploadPageTableRect(0, 0, w - wFirst, h - hFirst);
+}
+
+void TileCache::bind(ShaderProgram& shader) const
+{
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, atlasTex);
+    glActiveTexture(GL_TEXTURE1);
+    glBindTexture(GL_TEXTURE_2D, pageTableTex);
+    glActiveTexture(GL_TEXTURE0);
+
+    shader.setInt_w_Name("atlas", 0);
+    shader.setInt_w_Name("pageTable", 1);
+    shader.setInt_w_Name("pageTableDim", PAGE_TABLE_DIM);
+    shader.setInt_w_Name("atlasSlotsPerRow", slotsPerRow);
+}
+
+GLuint TileCache::acquireSlot()
+{
+    if (!freeSlots.empty()) {
+        GLuint slot = freeSlots.back();
+        freeSlots.pop_back();
+        return slot;
+    }
+
+    // Evict the least recently used tile
+    uint64_t victim = lru.back();
+    lru.pop_back();
+    auto it = entries.find(victim);
+    GLuint slot = it->second.slot;
+    entries.erase(it);
+    return slot;
+}
+
+void TileCache::uploadTile(GLuint slot, const TileStore::Tile& tile)
+{
+    // Little-endian: each uint64 row splits into texel 0 = cells 0-31, texel 1 = cells 32-63
+    int x = static_cast<int>(slot % slotsPerRow) * 2;
+    int y = static_cast<int>(slot / slotsPerRow) * TileStore::TILE_SIZE;
+    glBindTexture(GL_TEXTURE_2D, atlasTex);
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+    glTexSubImage2D(GL_TEXTURE_2D, 0, x, y, 2, TileStore::TILE_SIZE, GL_RED_INTEGER, GL_UNSIGNED_INT, tile.rows);
+    glBindTexture(GL_TEXTURE_2D, 0);
+}
+
+void TileCache::uploadPageTableRect(int x0, int y0, int x1, int y1)
+{
+    glBindTexture(GL_TEXTURE_2D, pageTableTex);
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, PAGE_TABLE_DIM);
+    glPixelStorei(GL_UNPACK_SKIP_PIXELS, x0);
+    glPixelStorei(GL_UNPACK_SKIP_ROWS, y0);
+    glTexSubImage2D(GL_TEXTURE_2D, 0, x0, y0, x1 - x0, y1 - y0, GL_RED_INTEGER, GL_UNSIGNED_INT, pageTable.data());
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+    glPixelStorei(GL_UNPACK_SKIP_PIXELS, 0);
+    glPixelStorei(GL_UNPACK_SKIP_ROWS, 0);
+    glBindTexture(GL_TEXTURE_2D, 0);
+}
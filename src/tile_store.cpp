@@ -0,0 +1,96 @@
+#include <cstring>
+#include "tile_store.h"
+
+bool TileStore::get(int64_t x, int64_t y) const
+{
+    const Tile* tile = findTile(static_cast<int32_t>(x >> TILE_SHIFT), static_cast<int32_t>(y >> TILE_SHIFT));
+    if (!tile) return false;
+    return (tile->rows[y & (TILE_SIZE-1)] >> (x & (TILE_SIZE-1))) & 1;
+}
+
+void TileStore::set(int64_t x, int64_t y, bool alive)
+{
+    uint64_t k = key(static_cast<int32_t>(x >> TILE_SHIFT), static_cast<int32_t>(y >> TILE_SHIFT));
+    uint64_t bit = 1ull << (x & (TILE_SIZE-1));
+    int row = static_cast<int>(y & (TILE_SIZE-1));
+
+    auto it = tiles.find(k);
+    if (it == tiles.end()) {
+        if (!alive) return;
+        Tile& tile = tiles[k];
+        std::memset(tile.rows, 0, sizeof(tile.rows));
+        tile.rows[row] = bit;
+        tile.version = nextVersion++;
+        return;
+    }
+
+    uint64_t& word = it->second.rows[row];
+    uint64_t updated = alive ? (word | bit) : (word & ~bit);
+    if (updated == word) return;
+    word = updated;
+    it->second.version = nextVersion++;
+}
+
+const TileStore::Tile* TileStore::findTile(int32_t tx, int32_t ty) const
+{
+    auto it = tiles.find(key(tx, ty));
+    return it == tiles.end() ? nullptr : &it->second;
+}
+
+void TileStore::setTile(int32_t tx, int32_t ty, const uint64_t* rows)
+{
+    uint64_t any = 0;
+    for (int i = 0; i < TILE_SIZE; i++) any |= rows[i];
+
+    uint64_t k = key(tx, ty);
+    auto it = tiles.find(k);
+    if (!any) {
+        if (it != tiles.end()) tiles.erase(it);
+        return;
+    }
+    if (it != tiles.end() && std::memcmp(it->second.rows, rows, sizeof(it->second.rows)) == 0) return;
+
+    Tile& tile = (it != tiles.end()) ? it->second : tiles[k];
+    std::memcpy(tile.rows, rows, sizeof(tile.rows));
+    tile.version = nextVersion++;
+}
+
+void TileStore::merge(const TileStore& other)
+{
+    for (const auto& [k, source] : other.tiles) {
+        auto it = tiles.find(k);
+        if (it == tiles.end()) {
+            Tile& tile = tiles[k];
+            std::memcpy(tile.rows, source.rows, sizeof(tile.rows));
+            tile.version = nextVersion++;
+            continue;
+        }
+        for (int r = 0; r < TILE_SIZE; r++) it->second.rows[r] |= source.rows[r];
+        it->second.version = nextVersion++;
+    }
+}
+
+void TileStore::clear()
+{
+    tiles.clear();
+}
+
+void TileStore::loadCells(const uint32_t* cells, int width, int height)
+{
+    uint64_t rows[TILE_SIZE];
+    for (int ty = 0; ty * TILE_SIZE < height; ty++) {
+        for (int tx = 0; tx * TILE_SIZE < width; tx++) {
+            for (int r = 0; r < TILE_SIZE; r++) {
+                rows[r] = 0;
+                int y = ty * TILE_SIZE + r;
+                if (y >= height) continue;
+                for (int c = 0; c < TILE_SIZE; c++) {
+                    int x = tx * TILE_SIZE + c;
+                    if (x >= width) break;
+                    if (cells[static_cast<size_t>(y) * width + x]) rows[r] |= 1ull << c;
+                }
+            }
+            setTile(tx, ty, rows);
+        }
+    }
+}
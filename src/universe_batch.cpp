@@ -0,0 +1,136 @@
+#include <algorithm>
+#include <thread>
+#include "universe_batch.h"
+#include "bit_utils.h"
+
+UniverseBatch::UniverseBatch(int width, int height, int universes, int threads)
+    : _width(width), _height(height), _universes(universes), _slices((universes + LANES - 1) / LANES),
+      threads(threads > 0 ? threads : static_cast<int>(std::max(1u, std::thread::hardware_concurrency())))
+{
+    current.assign(_slices * sliceWords(), 0);
+    next.assign(current.size(), 0);
+    rules.assign(_slices * RULE_WORDS, 0);
+    setRule(LifeRule());
+}
+
+void UniverseBatch::setRule(const LifeRule& rule)
+{
+    for (int u = 0; u < _universes; u++) setRule(u, rule);
+}
+
+void UniverseBatch::setRule(int universe, const LifeRule& rule)
+{
+    uint64_t* masks = rules.data() + (universe / LANES) * RULE_WORDS;
+    uint64_t lane = 1ull << (universe % LANES);
+    for (int n = 0; n <= 8; n++) {
+        masks[n] = ((rule.birthMask >> n) & 1) ? masks[n] | lane : masks[n] & ~lane;
+        masks[9 + n] = ((rule.surviveMask >> n) & 1) ? masks[9 + n] | lane : masks[9 + n] & ~lane;
+    }
+}
+
+void UniverseBatch::clear()
+{
+    std::fill(current.begin(), current.end(), 0);
+}
+
+void UniverseBatch::set(int universe, int x, int y, bool alive)
+{
+    uint64_t& word = current[index(universe / LANES, x, y)];
+    uint64_t lane = 1ull << (universe % LANES);
+    word = alive ? word | lane : word & ~lane;
+}
+
+bool UniverseBatch::get(int universe, int x, int y) const
+{
+    return (current[index(universe / LANES, x, y)] >> (universe % LANES)) & 1;
+}
+
+void UniverseBatch::load(int universe, const PackedGrid& board, int x, int y)
+{
+    int x0 = std::max(x, 0), x1 = std::min(x + board.width(), _width);
+    int y0 = std::max(y, 0), y1 = std::min(y + board.height(), _height);
+    for (int j = y0; j < y1; j++)
+        for (int i = x0; i < x1; i++)
+            set(universe, i, j, board.get(i - x, j - y));
+}
+
+void UniverseBatch::extract(int universe, PackedGrid& board) const
+{
+    board.resize(_width, _height);
+    for (int y = 0; y < _height; y++)
+        for (int x = 0; x < _width; x++)
+            if (get(universe, x, y)) board.set(x, y, true);
+}
+
+std::vector<uint64_t> UniverseBatch::populations() const
+{
+    std::vector<uint64_t> counts(_slices * LANES, 0);
+    for (int s = 0; s < _slices; s++)
+        for (int y = 0; y < _height; y++)
+            for (int x = 0; x < _width; x++)
+                for (uint64_t bits = current[index(s, x, y)]; bits; bits &= bits - 1)
+                    counts[s * LANES + countTrailingZeros64(bits)]++;
+    counts.resize(_universes);
+    return counts;
+}
+
+void UniverseBatch::step(int generations)
+{
+    if (generations <= 0) return;
+
+    int workers = std::max(1, std::min(threads, _slices));
+    std::vector<std::thread> pool;
+    for (int t = 1; t < workers; t++)
+        pool.emplace_back(&UniverseBatch::stepSlices, this, _slices * t / workers, _slices * (t + 1) / workers, generations);
+    stepSlices(0, _slices / workers, generations);
+    for (std::thread& t : pool) t.join();
+
+    // Every slice alternated between the two buffers the same number of times
+    if (generations & 1) std::swap(current, next);
+}
+
+void UniverseBatch::stepSlices(int slice0, int slice1, int generations)
+{
+    const size_t stride = _width + 2;
+
+    for (int s = slice0; s < slice1; s++) {
+        // Only the neighbour counts some universe of the slice is born or survives with need testing
+        const uint64_t* masks = rules.data() + s * RULE_WORDS;
+        int counts[9], activeCounts = 0;
+        for (int n = 0; n <= 8; n++)
+            if (masks[n] | masks[9 + n]) counts[activeCounts++] = n;
+
+        uint64_t* from = current.data() + s * sliceWords();
+        uint64_t* to = next.data() + s * sliceWords();
+        for (int g = 0; g < generations; g++) {
+            for (int y = 1; y <= _height; y++) {
+                const uint64_t* above = from + (y - 1) * stride;
+                const uint64_t* row = from + y * stride;
+                const uint64_t* below = from + (y + 1) * stride;
+                uint64_t* out = to + y * stride;
+
+                for (int x = 1; x <= _width; x++) {
+                    uint64_t s0 = 0, s1 = 0, s2 = 0, s3 = 0;
+                    addPlane(above[x - 1], s0, s1, s2, s3);
+                    addPlane(above[x], s0, s1, s2, s3);
+                    addPlane(above[x + 1], s0, s1, s2, s3);
+                    addPlane(row[x - 1], s0, s1, s2, s3);
+                    addPlane(row[x + 1], s0, s1, s2, s3);
+                    addPlane(below[x - 1], s0, s1, s2, s3);
+                    addPlane(below[x], s0, s1, s2, s3);
+                    addPlane(below[x + 1], s0, s1, s2, s3);
+
+                    // Lanes whose count is n take their rule's bit for n: birth if dead, survival if alive
+                    uint64_t alive = row[x], result = 0;
+                    for (int c = 0; c < activeCounts; c++) {
+                        int n = counts[c];
+                        uint64_t match = ((n & 1) ? s0 : ~s0) & ((n & 2) ? s1 : ~s1) & ((n & 4) ? s2 : ~s2) & ((n & 8) ? s3 : ~s3);
+                        result |= match & ((alive & masks[9 + n]) | (~alive & masks[n]));
+                    }
+                    out[x] = result;
+                }
+            }
+            std::swap(from, to);
+        }
+    }
+}
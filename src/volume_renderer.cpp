@@ -0,0 +1,72 @@
+#include <vector>
+#include <cmath>
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/type_ptr.hpp>
+#include "volume_renderer.h"
+
+VolumeRenderer::VolumeRenderer(const VoxelEngine& engine)
+    : shader(SHADER_PATH "tiles.vert", SHADER_PATH "volume.frag"),
+      size(engine.width(), engine.height(), engine.depth()),
+      wordsPerSlice(engine.wordsPerRow() * engine.height())
+{
+    glGenVertexArrays(1, &VAO);    // Core profile needs a VAO bound even though the triangle comes from gl_VertexID
+
+    glGenBuffers(1, &volumeBuf);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, volumeBuf);
+    glBufferData(GL_SHADER_STORAGE_BUFFER, wordsPerSlice * engine.depth() * sizeof(uint64_t), NULL, GL_DYNAMIC_DRAW);
+
+    glGenBuffers(1, &bricksBuf);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, bricksBuf);
+    glBufferData(GL_SHADER_STORAGE_BUFFER, engine.occupiedBricks().size() * sizeof(GLuint), NULL, GL_DYNAMIC_DRAW);
+
+    shader.use();
+    glUniform3i(glGetUniformLocation(shader.ID, "volumeSize"), engine.width(), engine.height(), engine.depth());
+    glUniform3i(glGetUniformLocation(shader.ID, "brickCounts"), engine.bricksX(), engine.bricksY(), engine.bricksZ());
+    shader.setInt_w_Name("wordsPerRow", static_cast<int>(engine.wordsPerRow()));
+}
+
+VolumeRenderer::~VolumeRenderer()
+{
+    glDeleteBuffers(1, &volumeBuf);
+    glDeleteBuffers(1, &bricksBuf);
+    glDeleteVertexArrays(1, &VAO);
+}
+
+void VolumeRenderer::upload(VoxelEngine& engine)
+{
+    int z0, z1;
+    if (!engine.takeChangedSlices(z0, z1)) return;
+
+    // Slices are contiguous (z major), so the changed ones go up as one range
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, volumeBuf);
+    glBufferSubData(GL_SHADER_STORAGE_BUFFER, z0 * wordsPerSlice * sizeof(uint64_t), (z1 - z0) * wordsPerSlice * sizeof(uint64_t),
+                    engine.words() + z0 * wordsPerSlice);
+
+    const std::vector<uint8_t>& occupied = engine.occupiedBricks();
+    std::vector<GLuint> bricks(occupied.begin(), occupied.end());
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, bricksBuf);
+    glBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, bricks.size() * sizeof(GLuint), bricks.data());
+}
+
+void VolumeRenderer::render(float yaw, float pitch, float distance, int viewportWidth, int viewportHeight)
+{
+    glm::vec3 centre = 0.5f * size;
+    float diagonal = glm::length(size);
+    glm::vec3 eye = centre + distance * diagonal * glm::vec3(std::cos(pitch) * std::sin(yaw), std::sin(pitch), std::cos(pitch) * std::cos(yaw));
+    glm::mat4 view = glm::lookAt(eye, centre, glm::vec3(0.0f, 1.0f, 0.0f));
+    glm::mat4 projection = glm::perspective(glm::radians(45.0f), static_cast<float>(viewportWidth) / viewportHeight, 0.1f, 4.0f * diagonal * distance);
+    glm::mat4 inverse = glm::inverse(projection * view);
+
+    shader.use();
+    shader.setMat4_w_Name("inverseViewProjection", GL_FALSE, glm::value_ptr(inverse));
+    glUniform3f(glGetUniformLocation(shader.ID, "eye"), eye.x, eye.y, eye.z);
+    shader.set2Floats_w_Name("viewportSize", static_cast<float>(viewportWidth), static_cast<float>(viewportHeight));
+
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, VOLUME_BINDING, volumeBuf);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, BRICKS_BINDING, bricksBuf);
+    glDisable(GL_DEPTH_TEST);
+    glBindVertexArray(VAO);
+    glDrawArrays(GL_TRIANGLES, 0, 3);
+    glBindVertexArray(0);
+    glEnable(GL_DEPTH_TEST);
+}
@@ -0,0 +1,243 @@
+#include <algorithm>
+#include <thread>
+#include "voxel_engine.h"
+#include "bit_utils.h"
+
+namespace {
+
+const size_t MIN_BRICKS_PER_THREAD = 64;
+
+// Cells whose count bit-planes hold a value whose bit is set in 'mask'
+inline uint64_t countIn(uint32_t mask, const uint64_t* planes, int planeCount)
+{
+    uint64_t match = 0;
+    for (uint32_t bits = mask; bits; bits &= bits - 1) {
+        int n = countTrailingZeros64(bits);
+        if (n >> planeCount) continue;
+        uint64_t equal = ~0ull;
+        for (int p = 0; p < planeCount; p++) equal &= ((n >> p) & 1) ? planes[p] : ~planes[p];
+        match |= equal;
+    }
+    return match;
+}
+
+}
+
+VoxelEngine::VoxelEngine(int threads)
+    : threads(threads > 0 ? threads : static_cast<int>(std::max(1u, std::thread::hardware_concurrency())))
+{
+}
+
+void VoxelEngine::setRule(const Rule3D& rule)
+{
+    this->rule = rule;
+    std::fill(changed.begin(), changed.end(), 1);       // Every brick is stepped under the new rule
+}
+
+void VoxelEngine::resize(int width, int height, int depth)
+{
+    _width = width;
+    _height = height;
+    _depth = depth;
+    _wordsPerRow = (static_cast<size_t>(width) + 63) / 64;
+    current.assign(_wordsPerRow * height * depth, 0);
+    next.assign(current.size(), 0);
+
+    _bricksX = static_cast<int>(_wordsPerRow);
+    _bricksY = (height + BRICK_ROWS - 1) / BRICK_ROWS;
+    _bricksZ = (depth + BRICK_SLICES - 1) / BRICK_SLICES;
+    size_t bricks = static_cast<size_t>(_bricksX) * _bricksY * _bricksZ;
+    changed.assign(bricks, 0);
+    occupied.assign(bricks, 0);
+    brickPopulation.assign(bricks, 0);
+    active.clear();
+    changedZ0 = 0;
+    changedZ1 = depth;
+}
+
+bool VoxelEngine::get(int x, int y, int z) const
+{
+    return (current[(static_cast<size_t>(z) * _height + y) * _wordsPerRow + (x >> 6)] >> (x & 63)) & 1;
+}
+
+void VoxelEngine::set(int x, int y, int z, bool alive)
+{
+    uint64_t& word = current[(static_cast<size_t>(z) * _height + y) * _wordsPerRow + (x >> 6)];
+    uint64_t bit = 1ull << (x & 63);
+    if (((word & bit) != 0) == alive) return;
+    word ^= bit;
+
+    size_t brick = brickIndex(x >> 6, y / BRICK_ROWS, z / BRICK_SLICES);
+    brickPopulation[brick] += alive ? 1 : -1;
+    occupied[brick] = brickPopulation[brick] != 0;
+    markChanged(brick, z, z + 1);
+}
+
+void VoxelEngine::markChanged(size_t brick, int z0, int z1)
+{
+    changed[brick] = 1;
+    if (changedZ0 >= changedZ1) {
+        changedZ0 = z0;     changedZ1 = z1;
+        return;
+    }
+    changedZ0 = std::min(changedZ0, z0);
+    changedZ1 = std::max(changedZ1, z1);
+}
+
+bool VoxelEngine::takeChangedSlices(int& z0, int& z1)
+{
+    z0 = changedZ0;
+    z1 = changedZ1;
+    changedZ0 = changedZ1 = 0;
+    return z0 < z1;
+}
+
+uint64_t VoxelEngine::population() const
+{
+    uint64_t total = 0;
+    for (uint32_t count : brickPopulation) total += count;
+    return total;
+}
+
+void VoxelEngine::step()
+{
+    // Bricks in or next to one that changed: only their cells can change now
+    std::vector<uint8_t> wanted(changed.size(), 0);
+    for (int bz = 0; bz < _bricksZ; bz++)
+        for (int by = 0; by < _bricksY; by++)
+            for (int bx = 0; bx < _bricksX; bx++) {
+                if (!changed[brickIndex(bx, by, bz)]) continue;
+                for (int k = std::max(bz - 1, 0); k <= std::min(bz + 1, _bricksZ - 1); k++)
+                    for (int j = std::max(by - 1, 0); j <= std::min(by + 1, _bricksY - 1); j++)
+                        for (int i = std::max(bx - 1, 0); i <= std::min(bx + 1, _bricksX - 1); i++)
+                            wanted[brickIndex(i, j, k)] = 1;
+            }
+    active.clear();
+    for (size_t b = 0; b < wanted.size(); b++)
+        if (wanted[b]) active.push_back(static_cast<uint32_t>(b));
+
+    std::vector<uint8_t> nowChanged(changed.size(), 0);
+    int workers = static_cast<int>(std::min<size_t>(threads, std::max<size_t>(1, active.size() / MIN_BRICKS_PER_THREAD)));
+    std::vector<std::thread> pool;
+    for (int t = 1; t < workers; t++)
+        pool.emplace_back(&VoxelEngine::stepBricks, this, active.size() * t / workers, active.size() * (t + 1) / workers, std::ref(nowChanged));
+    stepBricks(0, active.size() / workers, nowChanged);
+    for (std::thread& t : pool) t.join();
+
+    // Bricks left out hold the same cells in both buffers, so the swap keeps them
+    std::swap(current, next);
+    changed.swap(nowChanged);
+    for (uint32_t brick : active) {
+        if (!changed[brick]) continue;
+        int bz = static_cast<int>(brick / (static_cast<size_t>(_bricksX) * _bricksY));
+        markChanged(brick, bz * BRICK_SLICES, std::min((bz + 1) * BRICK_SLICES, _depth));
+    }
+}
+
+void VoxelEngine::stepBricks(size_t first, size_t last, std::vector<uint8_t>& nowChanged)
+{
+    for (size_t i = first; i < last; i++) stepBrick(active[i], nowChanged);
+}
+
+void VoxelEngine::stepBrick(size_t brick, std::vector<uint8_t>& nowChanged)
+{
+    const int bx = static_cast<int>(brick % _bricksX);
+    const int by = static_cast<int>((brick / _bricksX) % _bricksY);
+    const int bz = static_cast<int>(brick / (static_cast<size_t>(_bricksX) * _bricksY));
+    const size_t w = bx;
+    const int y0 = by * BRICK_ROWS, y1 = std::min(y0 + BRICK_ROWS, _height);
+    const int z0 = bz * BRICK_SLICES, z1 = std::min(z0 + BRICK_SLICES, _depth);
+    const uint64_t lastMask = (w + 1 == _wordsPerRow && (_width & 63)) ? ~0ull >> (64 - (_width & 63)) : ~0ull;
+
+    // Row (y, z)'s word & the cells either side of it, all dead outside the volume
+    auto centre = [&](int y, int z) -> uint64_t {
+        if (y < 0 || y >= _height || z < 0 || z >= _depth) return 0;
+        return current[(static_cast<size_t>(z) * _height + y) * _wordsPerRow + w];
+    };
+    auto sides = [&](int y, int z, uint64_t& west, uint64_t& east) {
+        const uint64_t* row = current.data() + (static_cast<size_t>(z) * _height + y) * _wordsPerRow;
+        west = (row[w] << 1) | (w > 0 ? row[w - 1] >> 63 : 0);      // Bit x = cell x-1
+        east = (row[w] >> 1) | (w + 1 < _wordsPerRow ? row[w + 1] << 63 : 0);
+    };
+
+    // Along x (0..3 in 2 planes) for the brick's rows & the ring of rows around them
+    uint64_t rowSum[BRICK_SLICES + 2][BRICK_ROWS + 2][2];
+    // Then along y (0..9 in 4 planes) for the brick's rows, over its slices & the two either side
+    uint64_t columnSum[BRICK_SLICES + 2][BRICK_ROWS][4];
+    if (!rule.vonNeumann) {
+        for (int z = z0 - 1; z <= z1; z++)
+            for (int y = y0 - 1; y <= y1; y++) {
+                uint64_t* sum = rowSum[z - z0 + 1][y - y0 + 1];
+                if (y < 0 || y >= _height || z < 0 || z >= _depth) {
+                    sum[0] = sum[1] = 0;
+                    continue;
+                }
+                uint64_t west, east;
+                sides(y, z, west, east);
+                fullAdd(west, centre(y, z), east, sum[0], sum[1]);
+            }
+        for (int z = z0 - 1; z <= z1; z++)
+            for (int y = y0; y < y1; y++) {
+                const uint64_t* a = rowSum[z - z0 + 1][y - y0];
+                const uint64_t* b = rowSum[z - z0 + 1][y - y0 + 1];
+                const uint64_t* c = rowSum[z - z0 + 1][y - y0 + 2];
+                uint64_t* sum = columnSum[z - z0 + 1][y - y0];
+                uint64_t carry1, low, carry2;
+                fullAdd(a[0], b[0], c[0], sum[0], carry1);
+                fullAdd(a[1], b[1], c[1], low, carry2);
+                sum[1] = low ^ carry1;
+                uint64_t carry = low & carry1;
+                sum[2] = carry2 ^ carry;
+                sum[3] = carry2 & carry;
+            }
+    }
+
+    const uint32_t surviveCounts = rule.vonNeumann ? rule.surviveMask : rule.surviveMask << 1;  // Moore totals include the cell
+    bool anyChange = false;
+    uint32_t population = 0;
+    for (int z = z0; z < z1; z++)
+        for (int y = y0; y < y1; y++) {
+            uint64_t alive = centre(y, z);
+            uint64_t count[5];
+            int planes;
+            if (rule.vonNeumann) {
+                // West, east & the rows above & below in y, then in z
+                uint64_t west, east, sumA, carryA, sumB, carryB;
+                sides(y, z, west, east);
+                fullAdd(west, east, centre(y - 1, z), sumA, carryA);
+                fullAdd(centre(y + 1, z), centre(y, z - 1), centre(y, z + 1), sumB, carryB);
+                uint64_t k = sumA & sumB;
+                count[0] = sumA ^ sumB;
+                count[1] = carryA ^ carryB ^ k;
+                count[2] = (carryA & carryB) | (k & (carryA ^ carryB));
+                planes = 3;
+            }
+            else {
+                // Along z: three 0..9 column sums make the 0..27 block total
+                const uint64_t* a = columnSum[z - z0][y - y0];
+                const uint64_t* b = columnSum[z - z0 + 1][y - y0];
+                const uint64_t* c = columnSum[z - z0 + 2][y - y0];
+                uint64_t carry1, sum1, carry2, sum2, carry3a, carry3b, sum3, carry4a, carry4b;
+                fullAdd(a[0], b[0], c[0], count[0], carry1);
+                fullAdd(a[1], b[1], c[1], sum1, carry2);
+                count[1] = sum1 ^ carry1;
+                uint64_t carry2b = sum1 & carry1;
+                fullAdd(a[2], b[2], c[2], sum2, carry3a);
+                fullAdd(sum2, carry2, carry2b, count[2], carry3b);
+                fullAdd(a[3], b[3], c[3], sum3, carry4a);
+                fullAdd(sum3, carry3a, carry3b, count[3], carry4b);
+                count[4] = carry4a | carry4b;        // Never both: 32 > 27
+                planes = 5;
+            }
+
+            uint64_t result = (alive & countIn(surviveCounts, count, planes)) | (~alive & countIn(rule.birthMask, count, planes));
+            result &= lastMask;         // Padding bits stay dead
+            next[(static_cast<size_t>(z) * _height + y) * _wordsPerRow + w] = result;
+            anyChange |= result != alive;
+            population += popcount64(result);
+        }
+
+    nowChanged[brick] = anyChange;
+    brickPopulation[brick] = population;
+    occupied[brick] = population != 0;
+}
@@ -0,0 +1,71 @@
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+#include "continuous_rule.h"
+#include "continuous_engine.h"
+
+// ContinuousEngine's FFT convolution must give the potentials a direct convolution does: a random board is
+// stepped once by the engine & by summing each cell's kernel weights directly (cells past the edges 0), &
+// the new values compared. Lenia has one kernel; SmoothLife two, which share the transforms
+
+namespace {
+
+const int WIDTH = 48, HEIGHT = 40;
+const float TOLERANCE = 1e-3f;
+
+bool check(const char* text)
+{
+    ContinuousRule rule;
+    if (!rule.parse(text)) {
+        std::cout << text << ": didn't parse" << std::endl;
+        return false;
+    }
+
+    std::mt19937 random(3);
+    std::uniform_int_distribution<uint32_t> level(0, 255);
+    std::vector<uint32_t> cells(WIDTH * HEIGHT);
+    for (uint32_t& cell : cells) cell = level(random);
+
+    ContinuousEngine engine(2);
+    engine.setRule(rule);
+    engine.loadCells(cells, WIDTH, HEIGHT);
+    const std::vector<float> before = engine.values();
+    engine.step();
+
+    const int r = rule.kernelRadius(), size = 2 * r + 1;
+    std::vector<std::vector<float>> kernels;
+    for (int k = 0; k < rule.kernelCount(); k++) kernels.push_back(rule.kernel(k));
+
+    float worst = 0.0f;
+    for (int y = 0; y < HEIGHT; y++) {
+        for (int x = 0; x < WIDTH; x++) {
+            float u[2] = { 0.0f, 0.0f };
+            for (int k = 0; k < rule.kernelCount(); k++)
+                for (int dy = -r; dy <= r; dy++)
+                    for (int dx = -r; dx <= r; dx++) {
+                        int sx = x - dx, sy = y - dy;
+                        if (sx < 0 || sx >= WIDTH || sy < 0 || sy >= HEIGHT) continue;
+                        u[k] += kernels[k][(dy + r) * size + dx + r] * before[sy * WIDTH + sx];
+                    }
+            float want = rule.next(before[y * WIDTH + x], u);
+            worst = std::max(worst, std::fabs(engine.values()[y * WIDTH + x] - want));
+        }
+    }
+    if (worst > TOLERANCE) {
+        std::cout << text << ": FFT & direct convolution differ by up to " << worst << std::endl;
+        return false;
+    }
+    return true;
+}
+
+}
+
+int main()
+{
+    bool ok = check("Lenia:R=6,T=10,m=0.15,s=0.015,b=1");
+    ok &= check("SmoothLife:ri=3,ra=9,b1=0.278,b2=0.365,d1=0.267,d2=0.445,an=0.028,am=0.147,dt=0");
+    if (ok) std::cout << "FFT convolution matches direct convolution" << std::endl;
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,70 @@
+#include <iostream>
+#include <string>
+#include "packed_grid.h"
+#include "life_rule.h"
+#include "object_census.h"
+
+// The census must split a board into its objects & name them by their apgcodes, whatever their phase &
+// orientation: a block, a blinker & a glider placed well apart are three objects, known to Catagolue as
+// xs4_33, xp2_7 & xq4_153
+
+namespace {
+
+const int SIZE = 64;
+
+// Sets the cells of 'rows' (top row first, 'o' live) with the pattern's bottom-left corner at (x, y)
+void place(PackedGrid& grid, int x, int y, const char* const* rows, int height)
+{
+    for (int r = 0; r < height; r++)
+        for (int c = 0; rows[r][c]; c++)
+            if (rows[r][c] == 'o') grid.set(x + c, y + height - 1 - r, true);
+}
+
+bool check(const char* name, const PackedGrid& grid, const char* const* codes, int count)
+{
+    LifeRule life;
+    ObjectCensus census(2);
+    census.setRule(life);
+    census.take(grid);
+
+    bool ok = census.objects().size() == static_cast<size_t>(count);
+    for (int i = 0; i < count; i++) {
+        auto entry = census.table().find(codes[i]);
+        if (entry == census.table().end() || entry->second != 1) ok = false;
+    }
+    if (!ok) {
+        std::cout << name << ": got " << census.objects().size() << " objects:";
+        for (const auto& [code, tally] : census.table()) std::cout << " " << code << " x" << tally;
+        std::cout << std::endl;
+    }
+    return ok;
+}
+
+}
+
+int main()
+{
+    const char* block[] = { "oo", "oo" };
+    const char* blinker[] = { "ooo" };
+    const char* blinkerOtherPhase[] = { "o", "o", "o" };
+    const char* glider[] = { ".o.", "..o", "ooo" };
+    const char* gliderTurned[] = { "o..", "o.o", "oo." };
+    const char* codes[] = { "xs4_33", "xp2_7", "xq4_153" };
+
+    bool ok = true;
+    PackedGrid grid(SIZE, SIZE);
+    place(grid, 5, 5, block, 2);
+    place(grid, 30, 8, blinker, 1);
+    place(grid, 10, 40, glider, 3);
+    ok &= check("block, blinker & glider", grid, codes, 3);
+
+    // Other phases & orientations of the same objects
+    PackedGrid turned(SIZE, SIZE);
+    place(turned, 50, 50, block, 2);
+    place(turned, 8, 20, blinkerOtherPhase, 3);
+    place(turned, 35, 35, gliderTurned, 3);
+    ok &= check("other phases & orientations", turned, codes, 3);
+
+    if (ok) std::cout << "Census names the block, blinker & glider" << std::endl;
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,67 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include "life_rule.h"
+#include "ltl_rule.h"
+#include "ltl_engine.h"
+#include "generations_engine.h"
+
+// Larger than Life & Generations engines must bring known oscillators back to where they started after
+// exactly their period (& not before):
+//  - R2,C0,M0,S4..8,B5..6,NM: a line of 5 cells flips between horizontal & vertical, period 2
+//  - Star Wars (B2/S345/C4): a 13 cell oscillator with dying cells, period 4
+
+namespace {
+
+const int SIZE = 32;
+
+struct Cell { int x, y; uint32_t state; };
+
+template <typename Engine>
+bool checkPeriod(const char* name, Engine& engine, const std::vector<Cell>& pattern, int period)
+{
+    std::vector<uint32_t> start(SIZE * SIZE, 0), cells;
+    for (const Cell& cell : pattern) start[(cell.y + SIZE / 2) * SIZE + cell.x + SIZE / 2] = cell.state;
+    engine.loadCells(start, SIZE, SIZE);
+
+    for (int g = 1; g <= 2 * period; g++) {
+        engine.step();
+        engine.toCells(cells);
+        bool back = cells == start;
+        if (back != (g % period == 0)) {
+            std::cout << name << ": generation " << g << (back ? " is back at the start" : " isn't back at the start") << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+}
+
+int main()
+{
+    bool ok = true;
+
+    LtlRule ltlRule;
+    if (!ltlRule.parse("R2,C0,M0,S4..8,B5..6,NM")) {
+        std::cout << "Larger than Life rule didn't parse" << std::endl;
+        return 1;
+    }
+    LtlEngine ltl(2);
+    ltl.setRule(ltlRule);
+    ok &= checkPeriod("Larger than Life line", ltl, { { -2, 0, 1 }, { -1, 0, 1 }, { 0, 0, 1 }, { 1, 0, 1 }, { 2, 0, 1 } }, 2);
+
+    LifeRule starWars;
+    if (!starWars.parse("B2/S345/C4") || !starWars.isGenerations()) {
+        std::cout << "Star Wars rule didn't parse" << std::endl;
+        return 1;
+    }
+    GenerationsEngine generations(2);
+    generations.setRule(starWars);
+    ok &= checkPeriod("Star Wars oscillator", generations,
+                      { { 0, 2, 2 }, { 1, 0, 1 }, { 1, 1, 3 }, { 1, 2, 1 }, { 1, 3, 3 }, { 2, 0, 2 }, { 2, 1, 2 },
+                        { 2, 4, 2 }, { 3, 0, 1 }, { 3, 1, 3 }, { 3, 2, 1 }, { 3, 3, 3 }, { 4, 2, 2 } }, 4);
+
+    if (ok) std::cout << "Larger than Life & Generations oscillators keep their periods" << std::endl;
+    return ok ? 0 : 1;
+}
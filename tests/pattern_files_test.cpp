@@ -0,0 +1,179 @@
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+#include "packed_grid.h"
+#include "life_rule.h"
+#include "cpu_life_engine.h"
+#include "delta_file.h"
+#include "cell_list_file.h"
+#include "tile_store.h"
+
+// Boards must come back exactly from the files they're written to:
+//  - a delta file's keyframes & deltas, read in order & through seek()
+//  - plaintext & Life 1.06 cell lists, loaded (in parallel chunks, when they're big enough) into a packed
+//    grid & into the sparse tile store
+
+namespace {
+
+bool sameCells(const PackedGrid& a, const PackedGrid& b)
+{
+    if (a.width() != b.width() || a.height() != b.height()) return false;
+    for (int y = 0; y < a.height(); y++)
+        for (int x = 0; x < a.width(); x++)
+            if (a.get(x, y) != b.get(x, y)) return false;
+    return true;
+}
+
+PackedGrid randomGrid(int width, int height, double density, unsigned seed)
+{
+    std::mt19937 random(seed);
+    std::bernoulli_distribution live(density);
+    PackedGrid grid(width, height);
+    for (int y = 0; y < height; y++)
+        for (int x = 0; x < width; x++)
+            grid.set(x, y, live(random));
+    return grid;
+}
+
+// A soup's first generations, keyframes every KEYFRAME_INTERVAL
+bool checkDeltaFile()
+{
+    const int WIDTH = 200, HEIGHT = 150, GENERATIONS = 25, KEYFRAME_INTERVAL = 10;
+    const std::string path = "pattern_files_test.delta";
+    std::remove(DeltaFile::indexPath(path).c_str());
+
+    std::vector<PackedGrid> boards;
+    CpuLifeEngine engine(1);
+    engine.load(randomGrid(WIDTH, HEIGHT, 0.35, 1));
+    boards.push_back(engine.board());
+    for (int g = 1; g < GENERATIONS; g++) {
+        engine.step();
+        boards.push_back(engine.board());
+    }
+
+    std::vector<uint8_t> encoded;
+    for (int g = 0; g < GENERATIONS; g++) {
+        DeltaFile::RecordType type = g % KEYFRAME_INTERVAL == 0 ? DeltaFile::KEYFRAME : DeltaFile::DELTA;
+        DeltaFile::encodeRecord(g == 0 ? boards[0] : boards[g - 1], boards[g], g, type, encoded);
+    }
+    {
+        DeltaFile::Header header = DeltaFile::makeHeader(WIDTH, HEIGHT, LifeRule());
+        std::ofstream file(path, std::ios::binary);
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(reinterpret_cast<const char*>(encoded.data()), static_cast<std::streamsize>(encoded.size()));
+    }
+
+    bool ok = true;
+    DeltaFile::Reader reader;
+    if (!reader.open(path)) {
+        std::cout << "delta file: couldn't open" << std::endl;
+        return false;
+    }
+    PackedGrid grid(WIDTH, HEIGHT);
+    unsigned long long generation = 0;
+    for (int g = 0; g < GENERATIONS; g++) {
+        if (!reader.next(grid, generation) || generation != static_cast<unsigned long long>(g) || !sameCells(grid, boards[g])) {
+            std::cout << "delta file: generation " << g << " read in order differs" << std::endl;
+            ok = false;
+            break;
+        }
+    }
+    for (int target : { 17, 3, 20, 24 }) {
+        if (!reader.seek(target, grid, generation) || generation != static_cast<unsigned long long>(target) || !sameCells(grid, boards[target])) {
+            std::cout << "delta file: seeking to generation " << target << " differs" << std::endl;
+            ok = false;
+        }
+    }
+    reader.close();
+    std::remove(path.c_str());
+    return ok;
+}
+
+// 'pattern' written as 'format' & loaded back, into a grid at (5, 7) & into a tile store at (-100, 70)
+bool checkCellList(const PackedGrid& pattern, CellListFile::Format format)
+{
+    const char* name = format == CellListFile::PLAINTEXT ? "plaintext" : "Life 1.06";
+    const std::string path = "pattern_files_test.cells";
+    {
+        // Rows run down the file: the pattern's top row first
+        std::ofstream file(path);
+        if (format == CellListFile::PLAINTEXT) {
+            file << "!Name: test\n";
+            for (int y = pattern.height() - 1; y >= 0; y--) {
+                std::string row(pattern.width(), '.');
+                for (int x = 0; x < pattern.width(); x++)
+                    if (pattern.get(x, y)) row[x] = 'O';
+                file << row << "\n";
+            }
+        }
+        else {
+            file << "#Life 1.06\n";
+            for (int y = 0; y < pattern.height(); y++)
+                for (int x = 0; x < pattern.width(); x++)
+                    if (pattern.get(x, y)) file << x - 20 << " " << -y << "\n";
+        }
+    }
+
+    bool ok = true;
+    CellListFile::Info info;
+    PackedGrid grid(pattern.width() + 10, pattern.height() + 10);
+    TileStore store;
+    if (!CellListFile::scan(path, format, info) || info.width() != pattern.width() || info.height() != pattern.height() ||
+        !CellListFile::load(path, format, info, grid, 5, 7) || !CellListFile::load(path, format, info, store, -100, 70)) {
+        std::cout << name << ": couldn't load" << std::endl;
+        ok = false;
+    }
+    for (int y = 0; ok && y < grid.height(); y++) {
+        for (int x = 0; x < grid.width(); x++) {
+            int px = x - 5, py = y - 7;
+            bool want = px >= 0 && px < pattern.width() && py >= 0 && py < pattern.height() && pattern.get(px, py);
+            if (grid.get(x, y) != want) {
+                std::cout << name << ": grid cell (" << x << ", " << y << ") differs" << std::endl;
+                ok = false;
+                break;
+            }
+        }
+    }
+    for (int y = -1; ok && y <= pattern.height(); y++) {
+        for (int x = -1; x <= pattern.width(); x++) {
+            bool want = x >= 0 && x < pattern.width() && y >= 0 && y < pattern.height() && pattern.get(x, y);
+            if (store.get(x - 100, y + 70) != want) {
+                std::cout << name << ": tile store cell (" << x - 100 << ", " << y + 70 << ") differs" << std::endl;
+                ok = false;
+                break;
+            }
+        }
+    }
+
+    // A bad Life 1.06 line fails the load & leaves the store as it was
+    if (format == CellListFile::LIFE_106) {
+        { std::ofstream(path, std::ios::app) << "12 nonsense\n"; }
+        TileStore untouched;
+        if (CellListFile::load(path, format, info, untouched, 0, 0) || untouched.tileCount() != 0) {
+            std::cout << name << ": a bad line was accepted" << std::endl;
+            ok = false;
+        }
+    }
+    std::remove(path.c_str());
+    return ok;
+}
+
+}
+
+int main()
+{
+    bool ok = checkDeltaFile();
+
+    // Corners set so the bounding box is the whole pattern; big enough to be split between threads
+    PackedGrid pattern = randomGrid(1600, 1400, 0.1, 2);
+    pattern.set(0, 0, true);
+    pattern.set(pattern.width() - 1, pattern.height() - 1, true);
+    ok &= checkCellList(pattern, CellListFile::PLAINTEXT);
+    ok &= checkCellList(pattern, CellListFile::LIFE_106);
+
+    if (ok) std::cout << "Delta files & cell lists round-trip" << std::endl;
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,105 @@
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include "rule_table.h"
+
+// Rule tables must expand their variables & symmetries as Golly does, & the perfect hash must give what the
+// dense table does. Wireworld is written with 4 states (a dense table) & again with 8 (too long a key for
+// one, so hashed), & both are checked against Wireworld itself over every Moore neighbourhood of states 0-3
+
+namespace {
+
+const char* WIREWORLD_TRANSITIONS =
+    "var a={0,1,2,3}\nvar b={0,1,2,3}\nvar c={0,1,2,3}\nvar d={0,1,2,3}\n"
+    "var e={0,1,2,3}\nvar f={0,1,2,3}\nvar g={0,1,2,3}\nvar h={0,1,2,3}\n"
+    "var i={0,2,3}\nvar j={0,2,3}\nvar k={0,2,3}\nvar l={0,2,3}\n"
+    "var m={0,2,3}\nvar n={0,2,3}\nvar o={0,2,3}\nvar p={0,2,3}\n"
+    "1,a,b,c,d,e,f,g,h,2\n"
+    "2,a,b,c,d,e,f,g,h,3\n"
+    "3,1,i,j,k,l,m,n,o,1\n"
+    "3,1,1,i,j,k,l,m,n,1\n";
+
+bool loadTable(const std::string& text, RuleTable& table)
+{
+    const std::string path = "rule_table_test.rule";
+    { std::ofstream(path) << "@RULE test\n@TABLE\n" << text; }
+    bool ok = table.load(path);
+    std::remove(path.c_str());
+    return ok;
+}
+
+// Cell state in the lowest bits, then N, NE, E, SE, S, SW, W, NW
+uint64_t key(const int* cells, int bitsPerState)
+{
+    uint64_t k = 0;
+    for (int i = 0; i < 9; i++) k |= static_cast<uint64_t>(cells[i]) << (i * bitsPerState);
+    return k;
+}
+
+int wireworld(const int* cells)
+{
+    if (cells[0] == 1) return 2;
+    if (cells[0] == 2) return 3;
+    if (cells[0] != 3) return cells[0];
+    int heads = 0;
+    for (int i = 1; i < 9; i++) heads += cells[i] == 1;
+    return heads == 1 || heads == 2 ? 1 : 3;
+}
+
+bool checkWireworld()
+{
+    RuleTable dense, hashed;
+    if (!loadTable("n_states:4\nneighborhood:Moore\nsymmetries:permute\n" + std::string(WIREWORLD_TRANSITIONS), dense) ||
+        !loadTable("n_states:8\nneighborhood:Moore\nsymmetries:permute\n" + std::string(WIREWORLD_TRANSITIONS), hashed)) {
+        std::cout << "Wireworld: couldn't load" << std::endl;
+        return false;
+    }
+    if (!dense.dense() || hashed.dense()) {
+        std::cout << "Wireworld: expected a dense table & a hashed one" << std::endl;
+        return false;
+    }
+
+    int cells[9];
+    for (int index = 0; index < 1 << 18; index++) {
+        for (int i = 0; i < 9; i++) cells[i] = (index >> (2 * i)) & 3;
+        int want = wireworld(cells);
+        uint32_t fromDense = dense.lookup(key(cells, dense.bitsPerState)), fromHash = hashed.lookup(key(cells, hashed.bitsPerState));
+        if (fromDense != static_cast<uint32_t>(want) || fromHash != static_cast<uint32_t>(want)) {
+            std::cout << "Wireworld: neighbourhood " << index << " gives " << fromDense << " (dense) & " << fromHash
+                      << " (hashed), not " << want << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+// rotate4 turns a line with one orthogonal neighbour into all four of them, & leaves the diagonals alone
+bool checkRotate4()
+{
+    RuleTable table;
+    if (!loadTable("n_states:2\nneighborhood:Moore\nsymmetries:rotate4\n0,1,0,0,0,0,0,0,0,1\n", table)) {
+        std::cout << "rotate4: couldn't load" << std::endl;
+        return false;
+    }
+    for (int neighbour = 1; neighbour < 9; neighbour++) {
+        int cells[9] = {};
+        cells[neighbour] = 1;
+        uint32_t want = neighbour % 2 == 1 ? 1 : 0;      // N, E, S & W are the odd positions
+        if (table.lookup(key(cells, table.bitsPerState)) != want) {
+            std::cout << "rotate4: a lone neighbour at position " << neighbour << " should give " << want << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+}
+
+int main()
+{
+    bool ok = checkWireworld();
+    ok &= checkRotate4();
+    if (ok) std::cout << "Rule tables expand & look up as Golly's" << std::endl;
+    return ok ? 0 : 1;
+}